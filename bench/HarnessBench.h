@@ -0,0 +1,155 @@
+#ifndef HARNESS_BENCH_H
+#define HARNESS_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Impede o compilador de descartar um resultado calculado só para o benchmark
+template <typename T>
+inline void naoOtimizar(const T& valor) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(valor) : "memory");
+#else
+    static volatile const void* destino;
+    destino = &valor;
+#endif
+}
+
+// Estatísticas de um caso medido (tempos por operação, em nanossegundos)
+struct ResultadoBench {
+    std::string nome;
+    std::string parametro;      ///< Ex: "n=100000"
+    size_t operacoes = 0;       ///< Operações por repetição
+    int repeticoes = 0;
+    double minimoNs = 0.0;
+    double medianaNs = 0.0;
+    double mediaNs = 0.0;
+    double p90Ns = 0.0;
+    double desvioNs = 0.0;
+    double coeficienteVariacao = 0.0;   ///< desvio / média; acima de ~0,05 a medição está ruidosa
+    double operacoesPorSegundo = 0.0;   ///< A partir da mediana
+};
+
+/*
+ * Harness mínimo dos benchmarks: cada caso roda algumas vezes para aquecer
+ * (caches, alocador, frequência da CPU) e depois 'repeticoes' vezes medidas.
+ * O relatório usa a mediana (resistente a interrupções do sistema) e mostra o
+ * coeficiente de variação para indicar se o número é confiável. Os resultados
+ * também são gravados em JSON para comparar execuções ao longo do tempo.
+ */
+class HarnessBench {
+public:
+    using Relogio = std::chrono::steady_clock;
+
+private:
+    int repeticoes;
+    int aquecimento;
+    std::string filtro;   ///< Só roda casos cujo nome contém o filtro (vazio = todos)
+    std::vector<ResultadoBench> resultados;
+
+    static std::string escaparJson(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    ResultadoBench resumir(const std::string& nome, const std::string& parametro, size_t operacoes,
+                           std::vector<double> porOperacaoNs) const {
+        ResultadoBench r;
+        r.nome = nome;
+        r.parametro = parametro;
+        r.operacoes = operacoes;
+        r.repeticoes = static_cast<int>(porOperacaoNs.size());
+        std::sort(porOperacaoNs.begin(), porOperacaoNs.end());
+        size_t n = porOperacaoNs.size();
+        r.minimoNs = porOperacaoNs.front();
+        r.medianaNs = n % 2 ? porOperacaoNs[n / 2] : (porOperacaoNs[n / 2 - 1] + porOperacaoNs[n / 2]) / 2;
+        r.p90Ns = porOperacaoNs[std::min(n - 1, static_cast<size_t>(std::ceil(0.9 * n)) - 1)];
+        for (double v : porOperacaoNs) r.mediaNs += v;
+        r.mediaNs /= n;
+        for (double v : porOperacaoNs) r.desvioNs += (v - r.mediaNs) * (v - r.mediaNs);
+        r.desvioNs = n > 1 ? std::sqrt(r.desvioNs / (n - 1)) : 0.0;
+        r.coeficienteVariacao = r.mediaNs > 0 ? r.desvioNs / r.mediaNs : 0.0;
+        r.operacoesPorSegundo = r.medianaNs > 0 ? 1e9 / r.medianaNs : 0.0;
+        return r;
+    }
+
+public:
+    HarnessBench(int repeticoes, int aquecimento, const std::string& filtro = "")
+        : repeticoes(std::max(1, repeticoes)), aquecimento(std::max(0, aquecimento)), filtro(filtro) {}
+
+    bool selecionado(const std::string& nome) const {
+        return filtro.empty() || nome.find(filtro) != std::string::npos;
+    }
+
+    // Mede 'corpo', que executa 'operacoes' operações; 'preparar' roda antes de cada
+    // repetição, fora da medição (ex: recriar a lista que o corpo vai esvaziar).
+    template <typename Preparar, typename Corpo>
+    void medir(const std::string& nome, const std::string& parametro, size_t operacoes, Preparar preparar, Corpo corpo) {
+        if (!selecionado(nome)) return;
+        std::vector<double> amostras;
+        for (int i = 0; i < aquecimento + repeticoes; i++) {
+            preparar();
+            auto inicio = Relogio::now();
+            corpo();
+            double ns = std::chrono::duration<double, std::nano>(Relogio::now() - inicio).count();
+            if (i >= aquecimento) amostras.push_back(ns / static_cast<double>(std::max<size_t>(1, operacoes)));
+        }
+        resultados.push_back(resumir(nome, parametro, operacoes, amostras));
+        const ResultadoBench& r = resultados.back();
+        std::ostringstream linha;
+        linha << std::left << std::setw(34) << r.nome << std::setw(14) << r.parametro << std::right << std::fixed
+              << std::setprecision(1) << std::setw(14) << r.medianaNs << " ns/op" << std::setw(14) << r.minimoNs
+              << " min" << std::setprecision(3) << std::setw(8) << r.coeficienteVariacao << " cv\n";
+        std::cout << linha.str() << std::flush;
+    }
+
+    template <typename Corpo>
+    void medir(const std::string& nome, const std::string& parametro, size_t operacoes, Corpo corpo) {
+        medir(nome, parametro, operacoes, [] {}, corpo);
+    }
+
+    const std::vector<ResultadoBench>& obterResultados() const { return resultados; }
+
+    // Grava os resultados em JSON; 'rotulo' identifica a execução (ex: commit)
+    void gravarJson(const std::string& caminho, const std::string& rotulo) const {
+        std::ofstream f(caminho);
+        if (!f.is_open()) {
+            std::cerr << "Nao foi possivel gravar " << caminho << "\n";
+            return;
+        }
+        std::time_t agora = std::time(nullptr);
+        char data[32];
+        std::strftime(data, sizeof(data), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&agora));
+        f << std::fixed << std::setprecision(3);
+        f << "{\n  \"formato\": 1,\n  \"rotulo\": \"" << escaparJson(rotulo) << "\",\n  \"data\": \"" << data << "\",\n"
+#if defined(__VERSION__)
+          << "  \"compilador\": \"" << escaparJson(__VERSION__) << "\",\n"
+#endif
+          << "  \"repeticoes\": " << repeticoes << ",\n  \"aquecimento\": " << aquecimento << ",\n  \"resultados\": [\n";
+        for (size_t i = 0; i < resultados.size(); i++) {
+            const ResultadoBench& r = resultados[i];
+            f << "    {\"nome\": \"" << escaparJson(r.nome) << "\", \"parametro\": \"" << escaparJson(r.parametro)
+              << "\", \"operacoes\": " << r.operacoes << ", \"repeticoes\": " << r.repeticoes
+              << ", \"minimoNs\": " << r.minimoNs << ", \"medianaNs\": " << r.medianaNs << ", \"mediaNs\": " << r.mediaNs
+              << ", \"p90Ns\": " << r.p90Ns << ", \"desvioNs\": " << r.desvioNs
+              << ", \"cv\": " << r.coeficienteVariacao << ", \"opsPorSegundo\": " << r.operacoesPorSegundo << "}"
+              << (i + 1 < resultados.size() ? "," : "") << "\n";
+        }
+        f << "  ]\n}\n";
+    }
+};
+
+#endif // HARNESS_BENCH_H
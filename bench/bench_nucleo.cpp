@@ -0,0 +1,214 @@
+// Microbenchmarks das estruturas centrais: ListaGenerica, persistência em arquivo,
+// serialização JSON e parseQuery do servidor, e as varreduras de estatísticas.
+// Cada caso repete a medição (ver HarnessBench) e o conjunto é gravado em JSON.
+//
+// Compilação (a partir da raiz): ./bench/compilar_bench.sh  (ou .ps1 no Windows)
+// Uso: ./build/bench_nucleo [--linhas=1000000] [--repeticoes=7] [--aquecimento=2]
+//                           [--filtro=texto] [--saida=build/bench_nucleo.json] [--rotulo=texto]
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include "HarnessBench.h"
+#include "PersistenciaCompras.h"
+#include "RegistroLog.h"
+#include "SerializacaoHttp.h"
+#include "TabelaOrdens.h"
+
+namespace {
+
+struct OpcoesBench {
+    size_t linhas = 1000000;   ///< Linhas dos casos de persistência
+    int repeticoes = 7;
+    int aquecimento = 2;
+    std::string filtro;
+    std::string saida = "build/bench_nucleo.json";
+    std::string rotulo;
+};
+
+OpcoesBench lerOpcoes(int argc, char** argv) {
+    OpcoesBench o;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto valor = [&](const std::string& prefixo) { return arg.substr(prefixo.size()); };
+        if (arg.rfind("--linhas=", 0) == 0) o.linhas = std::stoul(valor("--linhas="));
+        else if (arg.rfind("--repeticoes=", 0) == 0) o.repeticoes = std::stoi(valor("--repeticoes="));
+        else if (arg.rfind("--aquecimento=", 0) == 0) o.aquecimento = std::stoi(valor("--aquecimento="));
+        else if (arg.rfind("--filtro=", 0) == 0) o.filtro = valor("--filtro=");
+        else if (arg.rfind("--saida=", 0) == 0) o.saida = valor("--saida=");
+        else if (arg.rfind("--rotulo=", 0) == 0) o.rotulo = valor("--rotulo=");
+        else throw std::invalid_argument("Opcao desconhecida: " + arg);
+    }
+    return o;
+}
+
+// Ordens e fornecedores determinísticos (mesmos dados em todas as execuções)
+OrdemCompra ordemExemplo(size_t i) {
+    OrdemCompra o(static_cast<int>(i + 1), 1 + static_cast<int>(i % 50), 1 + static_cast<int>(i % 200),
+                  Dinheiro::deCentavos(100 + static_cast<int64_t>(i % 9700)), 1 + static_cast<int>(i % 10),
+                  i % 4 ? "2025-03-15 10:00" : "", 1735689600 + static_cast<int64_t>(i) * 60);
+    o.setStatus(static_cast<StatusOrdem>(i % 3));
+    return o;
+}
+
+Fornecedor fornecedorExemplo(size_t i) {
+    return Fornecedor("Fornecedor Industrial " + std::to_string(i + 1), "Rua das Industrias, " + std::to_string(i % 999),
+                      "12.345.678/0001-" + std::to_string(10 + i % 90), static_cast<int>(i + 1),
+                      "Produto " + std::to_string(i % 40), Dinheiro::deCentavos(1000 + static_cast<int64_t>(i % 5000)));
+}
+
+std::string parametroN(size_t n) { return "n=" + std::to_string(n); }
+
+void benchLista(HarnessBench& h) {
+    for (size_t n : {1000u, 10000u, 100000u, 1000000u}) {
+        std::vector<OrdemCompra> origem;
+        origem.reserve(n);
+        for (size_t i = 0; i < n; i++) origem.push_back(ordemExemplo(i));
+
+        ListaGenerica<OrdemCompra> lista;
+        h.medir("lista.adicionar", parametroN(n), n, [&] { lista.limpar(); }, [&] {
+            for (const OrdemCompra& o : origem) lista.adicionar(o);
+        });
+
+        // Consultas por índice em ordem aleatória (sem padrão para o prefetcher)
+        std::vector<size_t> indices(100000);
+        std::mt19937_64 gerador(42);
+        for (size_t& i : indices) i = gerador() % n;
+        h.medir("lista.obterIndiceAleatorio", parametroN(n), indices.size(), [&] {
+            int64_t soma = 0;
+            for (size_t i : indices) soma += lista.obter(i).getQuantidade();
+            naoOtimizar(soma);
+        });
+
+        // Busca linear pelo ID (o que a lista oferece sem índice auxiliar)
+        size_t buscas = std::max<size_t>(1, std::min<size_t>(1000, 20000000 / n));
+        h.medir("lista.buscarPorId", parametroN(n), buscas, [&] {
+            int encontrados = 0;
+            for (size_t b = 0; b < buscas; b++) {
+                int id = static_cast<int>(indices[b % indices.size()] + 1);
+                const auto& v = lista.obterVetor();
+                encontrados += std::find_if(v.begin(), v.end(), [id](const OrdemCompra& o) {
+                    return o.getIdTransacao() == id;
+                }) != v.end();
+            }
+            naoOtimizar(encontrados);
+        });
+
+        // Remoção no meio: desloca metade da lista a cada chamada
+        size_t remocoes = std::min<size_t>(n / 2, 1000);
+        ListaGenerica<OrdemCompra> copia;
+        h.medir("lista.removerMeio", parametroN(n), remocoes, [&] { copia = lista; }, [&] {
+            for (size_t r = 0; r < remocoes; r++) copia.remover(copia.obterTamanho() / 2);
+        });
+    }
+}
+
+void benchPersistencia(HarnessBench& h, size_t linhas) {
+    namespace fs = std::filesystem;
+    fs::path pasta = fs::temp_directory_path() / "bench_compras";
+    fs::create_directories(pasta);
+    PersistenciaCompras persistencia((pasta / "fornecedores.txt").string(), (pasta / "ordens.txt").string());
+
+    ListaGenerica<OrdemCompra> ordens;
+    for (size_t i = 0; i < linhas; i++) ordens.adicionar(ordemExemplo(i));
+    h.medir("persistencia.salvarOrdens", parametroN(linhas), linhas, [&] { persistencia.salvarOrdens(ordens); });
+    ListaGenerica<OrdemCompra> carregadas;
+    h.medir("persistencia.carregarOrdens", parametroN(linhas), linhas, [&] { carregadas.limpar(); }, [&] {
+        int proximo = 1;
+        persistencia.carregarOrdens(carregadas, proximo);
+    });
+    ordens.limpar();
+    carregadas.limpar();
+
+    ListaGenerica<Fornecedor> fornecedores;
+    for (size_t i = 0; i < linhas; i++) fornecedores.adicionar(fornecedorExemplo(i));
+    h.medir("persistencia.salvarFornecedores", parametroN(linhas), linhas, [&] {
+        persistencia.salvarFornecedores(fornecedores);
+    });
+    ListaGenerica<Fornecedor> fornecedoresCarregados;
+    h.medir("persistencia.carregarFornecedores", parametroN(linhas), linhas, [&] { fornecedoresCarregados.limpar(); }, [&] {
+        int proximo = 1;
+        persistencia.carregarFornecedores(fornecedoresCarregados, proximo);
+    });
+
+    std::error_code erro;
+    fs::remove_all(pasta, erro);
+}
+
+void benchSerializacao(HarnessBench& h) {
+    for (size_t n : {100u, 10000u, 100000u}) {
+        ListaGenerica<OrdemCompra> ordens;
+        ListaGenerica<Fornecedor> fornecedores;
+        for (size_t i = 0; i < n; i++) {
+            ordens.adicionar(ordemExemplo(i));
+            fornecedores.adicionar(fornecedorExemplo(i));
+        }
+        h.medir("json.ordens", parametroN(n), n, [&] { naoOtimizar(jsonOrdens(ordens)); });
+        h.medir("json.fornecedores", parametroN(n), n, [&] { naoOtimizar(jsonFornecedores(fornecedores)); });
+    }
+
+    const std::string consultas[] = {
+        "idFornecedor=3&idItem=12&quantidade=40&valor=12.50",
+        "idFornecedor=3&idItem=12&quantidade=40&valor=12.50&data_chegada=2025-03-15%2010%3A00&idempotencyKey=a1b2c3d4",
+        "nome=Metalurgica+Sao+Jose&cnpj=12.345.678%2F0001-90&endereco=Rua+das+Industrias%2C+100&produto=Aco+Inox&preco=45.90",
+    };
+    const char* nomes[] = {"curta", "com_data", "fornecedor"};
+    for (int c = 0; c < 3; c++) {
+        const size_t repeticoes = 100000;
+        h.medir("http.parseQuery", nomes[c], repeticoes, [&] {
+            for (size_t i = 0; i < repeticoes; i++) naoOtimizar(parseQuery(consultas[c]));
+        });
+    }
+}
+
+// Estatísticas: varredura dos objetos OrdemCompra vs a tabela colunar usada por obterResumo()
+void benchEstatisticas(HarnessBench& h) {
+    for (size_t n : {10000u, 1000000u}) {
+        ListaGenerica<OrdemCompra> lista;
+        TabelaOrdens tabela;
+        tabela.reservar(n);
+        for (size_t i = 0; i < n; i++) {
+            OrdemCompra o = ordemExemplo(i);
+            lista.adicionar(o);
+            tabela.adicionar(o);
+        }
+        h.medir("estatisticas.varreduraObjetos", parametroN(n), n, [&] {
+            ResumoOrdens r;
+            for (size_t i = 0; i < lista.obterTamanho(); i++) {
+                const OrdemCompra& o = lista[i];
+                r.contagemPorStatus[static_cast<int>(o.getStatus())]++;
+                r.quantidadeTotal += o.getQuantidade();
+                r.valorTotal += o.getValorTotal();
+                if (o.getStatus() == StatusOrdem::APROVADO) r.valorTotalAprovado += o.getValorTotal();
+            }
+            naoOtimizar(r);
+        });
+        h.medir("estatisticas.tabelaColunar", parametroN(n), n, [&] { naoOtimizar(tabela.resumir()); });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    OpcoesBench opcoes;
+    try {
+        opcoes = lerOpcoes(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    // Avisos da persistência (ex: arquivo inexistente) não interessam aqui
+    RegistroLog::instancia().configurar(NivelLog::ERRO, FormatoLog::TEXTO);
+
+    HarnessBench h(opcoes.repeticoes, opcoes.aquecimento, opcoes.filtro);
+    std::cout << "Repeticoes: " << opcoes.repeticoes << " (+" << opcoes.aquecimento << " de aquecimento); "
+              << "tempos por operacao, mediana\n\n";
+    benchLista(h);
+    benchPersistencia(h, opcoes.linhas);
+    benchSerializacao(h);
+    benchEstatisticas(h);
+
+    h.gravarJson(opcoes.saida, opcoes.rotulo);
+    std::cout << "\nResultados gravados em " << opcoes.saida << "\n";
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Benchmark de varredura analítica: ListaGenerica<OrdemCompra> (objetos) vs TabelaOrdens (colunar).
+// Mede linhas/s por núcleo ao calcular as estatísticas de status/quantidade/valor.
+//
+// Compilação (a partir da raiz):
+//   g++ -std=c++17 -O2 -pthread -Iinclude bench/bench_tabela_ordens.cpp -o build/bench_tabela_ordens
+// Uso: ./build/bench_tabela_ordens [numOrdens] [threads]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "TabelaOrdens.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+// Varredura equivalente à antiga, percorrendo os objetos OrdemCompra
+ResumoOrdens resumirLista(const ListaGenerica<OrdemCompra>& lista, size_t inicio, size_t fim) {
+    ResumoOrdens r;
+    for (size_t i = inicio; i < fim; i++) {
+        const auto& o = lista[i];
+        int s = static_cast<int>(o.getStatus());
+        r.contagemPorStatus[s]++;
+        r.quantidadeTotal += o.getQuantidade();
+        r.valorTotal += o.getValorTotal();
+        if (o.getStatus() == StatusOrdem::APROVADO) r.valorTotalAprovado += o.getValorTotal();
+    }
+    r.totalOrdens = fim - inicio;
+    return r;
+}
+
+// Executa 'varrer' em 'threads' partições e devolve linhas/s por núcleo
+template <typename Varredura>
+double medirPorNucleo(size_t linhas, unsigned threads, int repeticoes, Varredura varrer) {
+    double melhor = 0.0;
+    for (int rep = 0; rep < repeticoes; rep++) {
+        std::vector<std::thread> ts;
+        std::vector<ResumoOrdens> parciais(threads);
+        auto inicio = Relogio::now();
+        for (unsigned t = 0; t < threads; t++) {
+            size_t a = linhas * t / threads, b = linhas * (t + 1) / threads;
+            ts.emplace_back([&, t, a, b] { parciais[t] = varrer(a, b); });
+        }
+        for (auto& th : ts) th.join();
+        double seg = std::chrono::duration<double>(Relogio::now() - inicio).count();
+        ResumoOrdens total;
+        for (const auto& p : parciais) total.acumular(p);
+        if (total.totalOrdens != linhas) std::cerr << "Resultado inconsistente!\n";
+        double porNucleo = (linhas / seg) / threads;
+        if (porNucleo > melhor) melhor = porNucleo;
+    }
+    return melhor;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    unsigned threads = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    std::cout << "Gerando " << n << " ordens...\n";
+    ListaGenerica<OrdemCompra> lista;
+    TabelaOrdens tabela;
+    tabela.reservar(n);
+    for (size_t i = 0; i < n; i++) {
+        OrdemCompra o(static_cast<int>(i + 1), 1000 + static_cast<int>(i % 50), 1 + static_cast<int>(i % 200),
+                      Dinheiro::deCentavos(10 + static_cast<int64_t>(i % 97)), 1 + static_cast<int>(i % 10));
+        o.setStatus(static_cast<StatusOrdem>(i % 3));
+        lista.adicionar(o);
+        tabela.adicionar(o);
+    }
+
+    const int repeticoes = 5;
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned t : {1u, threads}) {
+        double objetos = medirPorNucleo(n, t, repeticoes, [&](size_t a, size_t b) { return resumirLista(lista, a, b); });
+        double colunar = medirPorNucleo(n, t, repeticoes, [&](size_t a, size_t b) { return tabela.resumir(a, b); });
+        std::cout << "threads=" << t
+                  << " | objetos: " << objetos / 1e6 << " M linhas/s/nucleo"
+                  << " | colunar: " << colunar / 1e6 << " M linhas/s/nucleo"
+                  << " | ganho: " << std::setprecision(2) << colunar / objetos << "x\n" << std::setprecision(1);
+    }
+    return 0;
+}
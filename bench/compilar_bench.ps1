@@ -0,0 +1,16 @@
+# PowerShell script to compile the benchmarks on Windows (output in build/)
+$ErrorActionPreference = 'Stop'
+
+# Go to repo root (parent of the script directory)
+Set-Location -Path (Join-Path $PSScriptRoot "..")
+
+New-Item -ItemType Directory -Force -Path "build" | Out-Null
+$fontes = @("src/PersistenciaCompras.cpp")
+
+Write-Host "🔨 Compilando bench_tabela_ordens..."
+& g++ -std=c++17 -O2 -Iinclude bench/bench_tabela_ordens.cpp -o build/bench_tabela_ordens.exe
+
+Write-Host "🔨 Compilando bench_nucleo..."
+& g++ -std=c++17 -O2 -Iinclude bench/bench_nucleo.cpp @fontes -o build/bench_nucleo.exe
+
+Write-Host "✅ Benchmarks em build/"
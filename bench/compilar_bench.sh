@@ -0,0 +1,16 @@
+#!/bin/bash
+# Compila os benchmarks em build/ (-O2, como o servidor)
+# Uso: ./bench/compilar_bench.sh && ./build/bench_nucleo --linhas=100000
+set -e
+cd "$(dirname "$0")/.."
+
+mkdir -p build
+FONTES="src/PersistenciaCompras.cpp"
+
+echo "🔨 Compilando bench_tabela_ordens..."
+g++ -std=c++17 -O2 -pthread -Iinclude bench/bench_tabela_ordens.cpp -o build/bench_tabela_ordens
+
+echo "🔨 Compilando bench_nucleo..."
+g++ -std=c++17 -O2 -pthread -Iinclude bench/bench_nucleo.cpp $FONTES -o build/bench_nucleo
+
+echo "✅ Benchmarks em build/"
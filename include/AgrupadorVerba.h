@@ -0,0 +1,130 @@
+#ifndef AGRUPADOR_VERBA_H
+#define AGRUPADOR_VERBA_H
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "IntegracoesResilientes.h"
+#include "ExecutorIntegracao.h"
+
+/*
+ * Agrupa as verificações de verba das ordens que chegam dentro de uma janela curta
+ * e as envia ao financeiro numa única chamada verificarDisponibilidadeLote.
+ * A latência de ida e volta ao financeiro passa a ser paga uma vez por lote.
+ * O lote é enviado quando a janela (contada a partir do primeiro pedido) expira
+ * ou quando atinge o tamanho máximo. A chamada ao financeiro é assíncrona (ninguém
+ * espera por ela) e as respostas voltam às ordens no executor do fluxo; uma thread
+ * própria só cuida do relógio da janela.
+ */
+class AgrupadorVerba {
+public:
+    struct Metricas {
+        unsigned long long lotes = 0;
+        unsigned long long pedidos = 0;
+        size_t maiorLote = 0;
+    };
+
+private:
+    struct Pendente {
+        PedidoVerba pedido;
+        Promessa<bool> resposta;
+    };
+
+    FinanceiroResiliente& financeiro;
+    ExecutorIntegracao& executor;
+    const std::chrono::milliseconds janela;
+    const size_t tamanhoMaximo;
+
+    mutable std::mutex mutex;
+    std::condition_variable mudou;
+    std::vector<Pendente> loteAtual;                  ///< Protegido por mutex
+    std::chrono::steady_clock::time_point inicioLote; ///< Chegada do primeiro pedido do lote atual
+    bool encerrando = false;
+    Metricas metricas;
+    std::thread despachante;
+
+    // Envia o lote ao financeiro e, quando ele responder, cumpre as promessas com o resultado
+    void enviar(std::vector<Pendente> lote) {
+        std::vector<PedidoVerba> pedidos;
+        pedidos.reserve(lote.size());
+        for (const auto& p : lote) pedidos.push_back(p.pedido);
+        financeiro.verificarDisponibilidadeLoteAssincrona(pedidos).quandoPronto(
+            [lote = std::move(lote)](const Futuro<std::vector<bool>>& resposta) {
+                try {
+                    std::vector<bool> resultados = resposta.obter();
+                    if (resultados.size() != lote.size()) {
+                        throw ComprasException("Financeiro devolveu resposta de lote com tamanho incorreto!");
+                    }
+                    for (size_t i = 0; i < lote.size(); i++) lote[i].resposta.cumprir(resultados[i]);
+                } catch (...) {
+                    for (const auto& p : lote) p.resposta.falhar(std::current_exception());
+                }
+                return true;
+            });
+    }
+
+    void laco() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            mudou.wait(lock, [this] { return encerrando || !loteAtual.empty(); });
+            if (loteAtual.empty()) return; // encerrando sem nada pendente
+
+            // Espera a janela fechar, a menos que o lote encha antes
+            mudou.wait_until(lock, inicioLote + janela,
+                             [this] { return encerrando || loteAtual.size() >= tamanhoMaximo; });
+
+            std::vector<Pendente> lote;
+            lote.swap(loteAtual);
+            metricas.lotes++;
+            metricas.pedidos += lote.size();
+            if (lote.size() > metricas.maiorLote) metricas.maiorLote = lote.size();
+            lock.unlock();
+            enviar(std::move(lote));
+            lock.lock();
+        }
+    }
+
+public:
+    AgrupadorVerba(FinanceiroResiliente& financeiro, ExecutorIntegracao& executor,
+                   std::chrono::milliseconds janela, size_t tamanhoMaximo)
+        : financeiro(financeiro), executor(executor), janela(janela),
+          tamanhoMaximo(tamanhoMaximo > 0 ? tamanhoMaximo : 1) {
+        despachante = std::thread(&AgrupadorVerba::laco, this);
+    }
+
+    // Envia o que estiver pendente e para a thread da janela.
+    // O último lote ainda pode estar em curso: quem tem ordens pendentes espera por elas antes.
+    ~AgrupadorVerba() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            encerrando = true;
+        }
+        mudou.notify_all();
+        despachante.join();
+    }
+
+    AgrupadorVerba(const AgrupadorVerba&) = delete;
+    AgrupadorVerba& operator=(const AgrupadorVerba&) = delete;
+
+    // Inclui o pedido no lote atual; o Futuro é cumprido quando o lote voltar
+    Futuro<bool> verificar(int idOrdem, Dinheiro valor) {
+        Promessa<bool> resposta(executor);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (loteAtual.empty()) inicioLote = std::chrono::steady_clock::now();
+            loteAtual.push_back(Pendente{PedidoVerba{idOrdem, valor}, resposta});
+        }
+        mudou.notify_all();
+        return resposta.obterFuturo();
+    }
+
+    Metricas obterMetricas() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return metricas;
+    }
+};
+
+#endif // AGRUPADOR_VERBA_H
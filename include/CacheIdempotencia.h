@@ -0,0 +1,96 @@
+#ifndef CACHE_IDEMPOTENCIA_H
+#define CACHE_IDEMPOTENCIA_H
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "MemoriaEstimada.h"
+
+/*
+ * Respostas recentes indexadas pela chave de idempotência enviada pelo cliente.
+ * Um POST repetido com a mesma chave recebe a resposta guardada em vez de ser
+ * executado de novo. Limitada em tamanho (a entrada usada há mais tempo sai
+ * primeiro) e em tempo (entradas mais velhas que o TTL são ignoradas).
+ * Cada entrada guarda também a assinatura da requisição original, para detectar
+ * a mesma chave reutilizada com outro conteúdo.
+ */
+class CacheIdempotencia {
+public:
+    enum class Consulta {
+        AUSENTE,      ///< Chave nova (ou expirada): executar e guardar
+        REPETIDA,     ///< Mesma chave e mesma requisição: devolver 'resposta'
+        CONFLITANTE   ///< Mesma chave com outra requisição: recusar
+    };
+
+private:
+    using Relogio = std::chrono::steady_clock;
+
+    struct Entrada {
+        std::string chave;
+        std::string assinatura;
+        std::string resposta;
+        Relogio::time_point criadaEm;
+    };
+
+    mutable std::mutex mutex;
+    std::list<Entrada> entradas;   ///< Da usada mais recentemente para a mais antiga
+    std::unordered_map<std::string, std::list<Entrada>::iterator> porChave;
+    const size_t capacidade;
+    const std::chrono::seconds ttl;
+
+public:
+    CacheIdempotencia(size_t capacidade, std::chrono::seconds ttl)
+        : capacidade(capacidade > 0 ? capacidade : 1), ttl(ttl) {}
+
+    Consulta consultar(const std::string& chave, const std::string& assinatura, std::string& resposta) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = porChave.find(chave);
+        if (it == porChave.end()) return Consulta::AUSENTE;
+        if (Relogio::now() - it->second->criadaEm > ttl) {
+            entradas.erase(it->second);
+            porChave.erase(it);
+            return Consulta::AUSENTE;
+        }
+        if (it->second->assinatura != assinatura) return Consulta::CONFLITANTE;
+        entradas.splice(entradas.begin(), entradas, it->second);
+        resposta = it->second->resposta;
+        return Consulta::REPETIDA;
+    }
+
+    void guardar(const std::string& chave, const std::string& assinatura, const std::string& resposta) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = porChave.find(chave);
+        if (it != porChave.end()) {
+            entradas.erase(it->second);
+            porChave.erase(it);
+        }
+        entradas.push_front(Entrada{chave, assinatura, resposta, Relogio::now()});
+        porChave[chave] = entradas.begin();
+        while (entradas.size() > capacidade) {
+            porChave.erase(entradas.back().chave);
+            entradas.pop_back();
+        }
+    }
+
+    size_t obterTamanho() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entradas.size();
+    }
+
+    // Lista LRU com as respostas guardadas e o índice por chave (que repete a chave)
+    void medirMemoria(UsoMemoria& respostas, UsoMemoria& indice) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        MemoriaEstimada::lista(respostas, entradas);
+        for (const Entrada& e : entradas) {
+            respostas.bytesTexto += MemoriaEstimada::texto(e.chave) + MemoriaEstimada::texto(e.assinatura) +
+                                    MemoriaEstimada::texto(e.resposta);
+        }
+        MemoriaEstimada::hash(indice, porChave);
+        for (const auto& kv : porChave) indice.bytesTexto += MemoriaEstimada::texto(kv.first);
+    }
+};
+
+#endif // CACHE_IDEMPOTENCIA_H
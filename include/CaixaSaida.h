@@ -0,0 +1,469 @@
+#ifndef CAIXA_SAIDA_H
+#define CAIXA_SAIDA_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+#include "ComprasException.h"
+#include "Dinheiro.h"
+#include "ExecutorIntegracao.h"
+
+// Efeito colateral de uma ordem aprovada a ser entregue a um módulo integrado
+enum class DestinoEvento {
+    CONTA_PAGAR = 0,        ///< financeiro.registrarContaPagar
+    MATERIAL_COMPRADO = 1,  ///< producao.notificarMaterialComprado
+    PREVISAO_ENTREGA = 2,   ///< producao.atualizarPrevisaoEntrega
+    ENTRADA_ESTOQUE = 3     ///< estoque.registrarEntradaCompra
+};
+
+struct EventoSaida {
+    uint64_t id = 0;         ///< Atribuído pela caixa de saída ao registrar
+    DestinoEvento destino = DestinoEvento::CONTA_PAGAR;
+    int idOrdem = 0;
+    int idItem = 0;
+    int quantidade = 0;
+    Dinheiro valorTotal;
+    int idFornecedor = 0;
+};
+
+/*
+ * Caixa de saída (outbox) transacional das ordens aprovadas.
+ * Os eventos de uma ordem são gravados num log só de acréscimo, junto com o
+ * registro da aprovação e antes de o status APROVADO ficar visível; uma thread
+ * própria inicia depois as entregas aos módulos (chamadas assíncronas, sem esperar
+ * por elas), repetindo com espera crescente até dar certo. A entrega é "pelo menos uma vez": os destinos precisam
+ * ser idempotentes (chaveados pelo ID da ordem).
+ *
+ * Formato do log (uma linha por registro):
+ *   A|idOrdem|idItem|qtd                        aprovação da ordem
+ *   E|id|destino|idOrdem|idItem|qtd|centavos|idFornecedor   evento a entregar
+ *   OK|id                                       evento entregue
+ *   F|idOrdem                                   aprovação não é mais necessária
+ * Na abertura, eventos já entregues e aprovações finalizadas são descartados e o
+ * arquivo é reescrito. Uma aprovação só serve para recuperar a ordem: é finalizada
+ * quando todos os eventos dela foram entregues e o arquivo de ordens já a tem como
+ * aprovada (confirmarPersistidas).
+ */
+class CaixaSaida {
+public:
+    // Inicia a entrega de um evento; Futuro com false ou erro (ou exceção ao iniciar)
+    // = tentar de novo mais tarde
+    using Entregador = std::function<Futuro<bool>(const EventoSaida&)>;
+
+    struct Metricas {
+        size_t pendentes = 0;
+        size_t aprovacoesGuardadas = 0;   ///< Aprovações ainda mantidas no log
+        unsigned long long registrados = 0;
+        unsigned long long entregues = 0;
+        unsigned long long novasTentativas = 0;
+        int maiorTentativa = 0;   ///< Maior número de tentativas de um evento ainda pendente
+    };
+
+private:
+    using Relogio = std::chrono::steady_clock;
+
+    struct Pendente {
+        EventoSaida evento;
+        int tentativas = 0;
+        Relogio::time_point proximaTentativa;
+        bool emEntrega = false;
+    };
+
+    std::string caminho;
+    Entregador entregador;
+
+    mutable std::mutex mutex;
+    std::condition_variable mudou;
+    FILE* arquivo = nullptr;
+    uint64_t proximoId = 1;
+    // Aprovação gravada no log, com o que é preciso para reconhecer a ordem ao recarregar
+    struct Aprovacao {
+        int idItem = -1;              ///< -1: linha no formato antigo (A|idOrdem)
+        int quantidade = -1;
+        size_t eventosPendentes = 0;
+        bool persistida = false;      ///< O arquivo de ordens já tem a ordem como aprovada
+    };
+
+    std::map<uint64_t, Pendente> pendentes;   ///< Protegido por mutex
+    std::map<int, Aprovacao> ordensAprovadas; ///< Por idOrdem; só as ainda necessárias
+    bool parando = false;
+    size_t entregasEmCurso = 0;               ///< Iniciadas e ainda sem resultado
+    unsigned long long registrados = 0;
+    unsigned long long entregues = 0;
+    unsigned long long novasTentativas = 0;
+    std::thread despachante;
+
+    static constexpr long long ESPERA_BASE_MS = 500;
+    static constexpr long long ESPERA_MAXIMA_MS = 60000;
+
+    // Força a ida ao disco do que já foi escrito em 'f'
+    static void sincronizar(FILE* f, const std::string& nome) {
+        bool ok = std::fflush(f) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(f)) == 0;
+#else
+        ok = ok && fsync(fileno(f)) == 0;
+#endif
+        if (!ok) throw ComprasException("Falha ao sincronizar " + nome + " com o disco");
+    }
+
+    // Torna durável a troca de nome feita na pasta do arquivo (sem equivalente no Windows)
+    static void sincronizarPasta(const std::string& arquivo) {
+#ifndef _WIN32
+        size_t barra = arquivo.find_last_of('/');
+        std::string pasta = (barra == std::string::npos) ? "." : (barra == 0 ? "/" : arquivo.substr(0, barra));
+        int fd = open(pasta.c_str(), O_RDONLY);
+        if (fd < 0) throw ComprasException("Nao foi possivel abrir a pasta " + pasta);
+        int resultado = fsync(fd);
+        close(fd);
+        if (resultado != 0) throw ComprasException("Falha ao sincronizar a pasta " + pasta + " com o disco");
+#else
+        (void)arquivo;
+#endif
+    }
+
+    // Troca 'destino' por 'origem' de uma vez: um leitor vê o arquivo antigo ou o novo, nunca nenhum.
+    // filesystem::rename substitui o destino também no Windows (onde std::rename falharia).
+    static bool substituir(const std::string& origem, const std::string& destino) {
+        std::error_code erro;
+        std::filesystem::rename(origem, destino, erro);
+        return !erro;
+    }
+
+    // Grava as linhas e força a ida ao disco (chamar com o mutex adquirido).
+    // Lança ComprasException se a escrita ou o fsync falhar: o registro não é durável.
+    void gravar(const std::string& linhas) {
+        if (std::fwrite(linhas.data(), 1, linhas.size(), arquivo) != linhas.size()) {
+            throw ComprasException("Falha ao gravar a caixa de saida em " + caminho);
+        }
+        sincronizar(arquivo, caminho);
+    }
+
+    static std::string linhaAprovacao(int idOrdem, const Aprovacao& a) {
+        return "A|" + std::to_string(idOrdem) + "|" + std::to_string(a.idItem) + "|" +
+               std::to_string(a.quantidade) + "\n";
+    }
+
+    // Se a aprovação deixou de ser necessária, remove e devolve a linha F| a gravar
+    // (chamar com o mutex adquirido)
+    std::string finalizarAprovacaoSeConcluida(std::map<int, Aprovacao>::iterator it) {
+        if (!it->second.persistida || it->second.eventosPendentes > 0) return "";
+        std::string linha = "F|" + std::to_string(it->first) + "\n";
+        ordensAprovadas.erase(it);
+        return linha;
+    }
+
+    // (chamar com o mutex adquirido; 'it' pode ser invalidado)
+    std::string marcarPersistida(std::map<int, Aprovacao>::iterator it) {
+        if (it->second.persistida) return "";
+        it->second.persistida = true;
+        return finalizarAprovacaoSeConcluida(it);
+    }
+
+    void gravarFinalizacoes(const std::string& linhas) {
+        if (linhas.empty()) return;
+        try {
+            gravar(linhas);
+        } catch (const std::exception&) {
+            // Sem a marca, a aprovação só volta a ser guardada após reiniciar
+        }
+    }
+
+    static std::string linhaEvento(const EventoSaida& e) {
+        std::ostringstream os;
+        os << "E|" << e.id << "|" << static_cast<int>(e.destino) << "|" << e.idOrdem << "|" << e.idItem << "|"
+           << e.quantidade << "|" << e.valorTotal.emCentavos() << "|" << e.idFornecedor << "\n";
+        return os.str();
+    }
+
+    // Como a persistência: procura a pasta de dados também em "../" e "../../"
+    static std::string resolverCaminho(const std::string& caminho) {
+        for (const std::string& c : {caminho, "../" + caminho, "../../" + caminho}) {
+            if (FILE* f = std::fopen(c.c_str(), "a")) {
+                std::fclose(f);
+                return c;
+            }
+        }
+        throw ComprasException("Nao foi possivel abrir a caixa de saida em " + caminho);
+    }
+
+    // Lê o log existente, descarta o que já foi entregue e reescreve o arquivo compactado
+    void recuperar() {
+        caminho = resolverCaminho(caminho);
+        std::ifstream entrada(caminho);
+        std::string linha;
+        while (std::getline(entrada, linha)) {
+            std::vector<std::string> campos;
+            std::stringstream ss(linha);
+            std::string campo;
+            while (std::getline(ss, campo, '|')) campos.push_back(campo);
+            try {
+                if ((campos.size() == 2 || campos.size() == 4) && campos[0] == "A") {
+                    Aprovacao& a = ordensAprovadas[std::stoi(campos[1])];
+                    if (campos.size() == 4) {
+                        a.idItem = std::stoi(campos[2]);
+                        a.quantidade = std::stoi(campos[3]);
+                    }
+                } else if (campos.size() == 8 && campos[0] == "E") {
+                    Pendente p;
+                    p.evento.id = std::stoull(campos[1]);
+                    p.evento.destino = static_cast<DestinoEvento>(std::stoi(campos[2]));
+                    p.evento.idOrdem = std::stoi(campos[3]);
+                    p.evento.idItem = std::stoi(campos[4]);
+                    p.evento.quantidade = std::stoi(campos[5]);
+                    p.evento.valorTotal = Dinheiro::deCentavos(std::stoll(campos[6]));
+                    p.evento.idFornecedor = std::stoi(campos[7]);
+                    proximoId = std::max(proximoId, p.evento.id + 1);
+                    pendentes[p.evento.id] = p;
+                } else if (campos.size() == 2 && campos[0] == "OK") {
+                    pendentes.erase(std::stoull(campos[1]));
+                } else if (campos.size() == 2 && campos[0] == "F") {
+                    ordensAprovadas.erase(std::stoi(campos[1]));
+                }
+            } catch (const std::exception&) {
+                // Linha incompleta (queda no meio de uma gravação): ignorada
+            }
+        }
+        entrada.close();
+        for (const auto& p : pendentes) {
+            auto a = ordensAprovadas.find(p.second.evento.idOrdem);
+            if (a == ordensAprovadas.end()) continue;
+            a->second.eventosPendentes++;
+            // Formato antigo: os eventos da ordem trazem o item e a quantidade
+            if (a->second.idItem < 0) {
+                a->second.idItem = p.second.evento.idItem;
+                a->second.quantidade = p.second.evento.quantidade;
+            }
+        }
+
+        // O log compactado vai para um temporário, que só substitui o original depois de
+        // estar no disco; a troca de nome é atômica e a pasta é sincronizada em seguida.
+        // Uma queda em qualquer ponto deixa o log antigo ou o novo, completos.
+        std::string temporario = caminho + ".tmp";
+        FILE* novo = std::fopen(temporario.c_str(), "w");
+        if (!novo) throw ComprasException("Nao foi possivel criar " + temporario);
+        std::string conteudo;
+        for (const auto& a : ordensAprovadas) conteudo += linhaAprovacao(a.first, a.second);
+        for (const auto& p : pendentes) conteudo += linhaEvento(p.second.evento);
+        try {
+            if (std::fwrite(conteudo.data(), 1, conteudo.size(), novo) != conteudo.size()) {
+                throw ComprasException("Falha ao gravar " + temporario);
+            }
+            sincronizar(novo, temporario);
+        } catch (...) {
+            std::fclose(novo);
+            throw;
+        }
+        if (std::fclose(novo) != 0) throw ComprasException("Falha ao fechar " + temporario);
+        if (!substituir(temporario, caminho)) {
+            throw ComprasException("Nao foi possivel substituir " + caminho);
+        }
+        sincronizarPasta(caminho);
+        arquivo = std::fopen(caminho.c_str(), "a");
+        if (!arquivo) throw ComprasException("Nao foi possivel abrir a caixa de saida em " + caminho);
+    }
+
+    // Resultado de uma entrega (roda quando a chamada ao módulo termina)
+    void concluirEntrega(uint64_t id, bool sucesso) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entregasEmCurso--;
+            auto it = pendentes.find(id);
+            if (it != pendentes.end() && sucesso) {
+                std::string linhas = "OK|" + std::to_string(id) + "\n";
+                auto aprovacao = ordensAprovadas.find(it->second.evento.idOrdem);
+                pendentes.erase(it);
+                entregues++;
+                if (aprovacao != ordensAprovadas.end()) {
+                    aprovacao->second.eventosPendentes--;
+                    linhas += finalizarAprovacaoSeConcluida(aprovacao);
+                }
+                try {
+                    gravar(linhas);
+                } catch (const std::exception&) {
+                    // Sem as marcas, o evento é reentregue e a aprovação volta após reiniciar
+                    // (destinos são idempotentes)
+                }
+            } else if (it != pendentes.end()) {
+                Pendente& p = it->second;
+                p.emEntrega = false;
+                long long espera = ESPERA_BASE_MS << std::min(p.tentativas - 1, 7);
+                p.proximaTentativa = Relogio::now() + std::chrono::milliseconds(std::min(espera, ESPERA_MAXIMA_MS));
+                novasTentativas++;
+            }
+            // Sob o mutex: parar() pode destruir a caixa assim que a contagem zerar
+            mudou.notify_all();
+        }
+    }
+
+    void laco() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!parando) {
+            Relogio::time_point agora = Relogio::now();
+            Relogio::time_point proxima = Relogio::time_point::max();
+            std::vector<EventoSaida> vencidos;
+            for (auto& par : pendentes) {
+                Pendente& p = par.second;
+                if (p.emEntrega) continue;
+                if (p.proximaTentativa <= agora) {
+                    p.emEntrega = true;
+                    p.tentativas++;
+                    entregasEmCurso++;
+                    vencidos.push_back(p.evento);
+                } else if (p.proximaTentativa < proxima) {
+                    proxima = p.proximaTentativa;
+                }
+            }
+            if (!vencidos.empty()) {
+                lock.unlock();
+                for (const EventoSaida& e : vencidos) {
+                    Futuro<bool> entrega;
+                    try {
+                        entrega = entregador(e);
+                    } catch (const std::exception&) {
+                        concluirEntrega(e.id, false);
+                        continue;
+                    }
+                    entrega.quandoPronto([this, id = e.id](const Futuro<bool>& resultado) {
+                        bool sucesso = false;
+                        try {
+                            sucesso = resultado.obter();
+                        } catch (const std::exception&) {
+                            sucesso = false;
+                        }
+                        concluirEntrega(id, sucesso);
+                        return sucesso;
+                    });
+                }
+                lock.lock();
+                continue;
+            }
+            if (proxima == Relogio::time_point::max()) mudou.wait(lock);
+            else mudou.wait_until(lock, proxima);
+        }
+    }
+
+public:
+    // Recupera os eventos não entregues do log e começa a entregá-los.
+    CaixaSaida(const std::string& caminho, Entregador entregador)
+        : caminho(caminho), entregador(std::move(entregador)) {
+        recuperar();
+        despachante = std::thread(&CaixaSaida::laco, this);
+    }
+
+    // Para a thread de despacho e espera o resultado das entregas já iniciadas
+    // (cada uma termina em no máximo o prazo e as tentativas da guarda do módulo).
+    void parar() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (parando) return;
+            parando = true;
+        }
+        mudou.notify_all();
+        despachante.join();
+        std::unique_lock<std::mutex> lock(mutex);
+        mudou.wait(lock, [this] { return entregasEmCurso == 0; });
+    }
+
+    ~CaixaSaida() {
+        parar();
+        if (arquivo) std::fclose(arquivo);
+    }
+
+    CaixaSaida(const CaixaSaida&) = delete;
+    CaixaSaida& operator=(const CaixaSaida&) = delete;
+
+    // Grava de forma durável a aprovação da ordem e seus eventos (tudo ou nada:
+    // lança ComprasException se não conseguir gravar). A entrega começa em seguida.
+    void registrar(int idOrdem, int idItem, int quantidade, std::vector<EventoSaida> eventos) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Aprovacao aprovacao;
+            aprovacao.idItem = idItem;
+            aprovacao.quantidade = quantidade;
+            aprovacao.eventosPendentes = eventos.size();
+            std::string linhas = linhaAprovacao(idOrdem, aprovacao);
+            uint64_t id = proximoId;
+            for (EventoSaida& e : eventos) {
+                e.id = id++;
+                linhas += linhaEvento(e);
+            }
+            gravar(linhas);
+            proximoId = id;
+            ordensAprovadas[idOrdem] = aprovacao;
+            for (const EventoSaida& e : eventos) {
+                Pendente p;
+                p.evento = e;
+                pendentes[e.id] = p;
+            }
+            registrados += eventos.size();
+        }
+        mudou.notify_all();
+    }
+
+    // A aprovação desta ordem, com este item e quantidade, foi gravada no log?
+    // (um ID reaproveitado por outra ordem, ex: arquivo de ordens restaurado, não casa)
+    bool ordemAprovada(int idOrdem, int idItem, int quantidade) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ordensAprovadas.find(idOrdem);
+        return it != ordensAprovadas.end() && it->second.idItem == idItem && it->second.quantidade == quantidade;
+    }
+
+    // O arquivo de ordens foi gravado com estas ordens já aprovadas: as aprovações
+    // cujos eventos foram todos entregues deixam de ser guardadas
+    void confirmarPersistidas(const std::vector<int>& idsOrdens) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string linhas;
+        for (int id : idsOrdens) {
+            auto it = ordensAprovadas.find(id);
+            if (it != ordensAprovadas.end()) linhas += marcarPersistida(it);
+        }
+        gravarFinalizacoes(linhas);
+    }
+
+    // Depois de carregar o arquivo de ordens: só as aprovações que acabaram de recuperar
+    // uma ordem (ainda PENDENTE no arquivo) continuam necessárias; as demais já constam
+    // do arquivo ou não correspondem a nenhuma ordem dele
+    void reconciliarComArquivo(const std::vector<int>& idsRecuperadas) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string linhas;
+        for (auto it = ordensAprovadas.begin(); it != ordensAprovadas.end();) {
+            auto atual = it++;
+            if (std::find(idsRecuperadas.begin(), idsRecuperadas.end(), atual->first) == idsRecuperadas.end()) {
+                linhas += marcarPersistida(atual);
+            }
+        }
+        gravarFinalizacoes(linhas);
+    }
+
+    Metricas obterMetricas() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        Metricas m;
+        m.pendentes = pendentes.size();
+        m.aprovacoesGuardadas = ordensAprovadas.size();
+        m.registrados = registrados;
+        m.entregues = entregues;
+        m.novasTentativas = novasTentativas;
+        for (const auto& p : pendentes) m.maiorTentativa = std::max(m.maiorTentativa, p.second.tentativas);
+        return m;
+    }
+};
+
+#endif // CAIXA_SAIDA_H
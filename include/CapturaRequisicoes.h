@@ -0,0 +1,145 @@
+#ifndef CAPTURA_REQUISICOES_H
+#define CAPTURA_REQUISICOES_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "ComprasException.h"
+
+// Uma requisição atendida pelo servidor, como gravada na captura
+struct RegistroCaptura {
+    uint64_t chegadaNs = 0;        ///< Chegada, em ns desde o início da captura
+    uint64_t latenciaNs = 0;       ///< Da aceitação da conexão ao envio da resposta
+    uint32_t tamanhoResposta = 0;  ///< Bytes da resposta (cabeçalhos incluídos)
+    uint16_t status = 0;
+    std::string metodo;
+    std::string alvo;              ///< Caminho com a query string, como recebido
+    std::string corpo;
+    std::string chaveIdempotencia; ///< Cabeçalho Idempotency-Key (vazio se ausente)
+};
+
+/*
+ * Arquivo binário de captura do tráfego do servidor (--captura=arquivo), lido
+ * pelo reprodutor (tools/reprodutor_captura.cpp).
+ *
+ * Formato (inteiros little-endian):
+ *   cabeçalho: "CAPCOMP" + versão (1 byte) | u64 início (ns desde 1970, relógio do sistema)
+ *   registro:  u64 chegadaNs | u64 latenciaNs | u32 tamanhoResposta | u16 status
+ *              | u8 + método | u32 + alvo | u32 + corpo | u16 + chave   (tamanho + bytes)
+ * Um registro típico ocupa ~60 bytes. A gravação usa o buffer do ofstream e
+ * descarrega a cada 64 registros, então um encerramento abrupto perde no
+ * máximo os últimos registros (o leitor ignora um registro final incompleto).
+ */
+class CapturaRequisicoes {
+public:
+    using Relogio = std::chrono::steady_clock;
+
+    static constexpr char ASSINATURA[8] = {'C', 'A', 'P', 'C', 'O', 'M', 'P', 1};
+
+private:
+    std::ofstream arquivo;
+    Relogio::time_point inicio;
+    unsigned desdeDescarga = 0;
+
+    template <typename T>
+    void escreverInteiro(T valor) {
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++) bytes[i] = static_cast<char>((static_cast<uint64_t>(valor) >> (8 * i)) & 0xFF);
+        arquivo.write(bytes, sizeof(T));
+    }
+
+    template <typename Tamanho>
+    void escreverTexto(const std::string& s) {
+        size_t maximo = static_cast<Tamanho>(~Tamanho(0));
+        size_t n = s.size() < maximo ? s.size() : maximo;
+        escreverInteiro(static_cast<Tamanho>(n));
+        arquivo.write(s.data(), static_cast<std::streamsize>(n));
+    }
+
+public:
+    explicit CapturaRequisicoes(const std::string& caminho)
+        : arquivo(caminho, std::ios::binary | std::ios::trunc), inicio(Relogio::now()) {
+        if (!arquivo.is_open()) throw ComprasException("Nao foi possivel criar o arquivo de captura: " + caminho);
+        arquivo.write(ASSINATURA, sizeof(ASSINATURA));
+        escreverInteiro(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()));
+        arquivo.flush();
+    }
+
+    ~CapturaRequisicoes() { arquivo.flush(); }
+
+    CapturaRequisicoes(const CapturaRequisicoes&) = delete;
+    CapturaRequisicoes& operator=(const CapturaRequisicoes&) = delete;
+
+    // Grava uma requisição que chegou em 'chegada' e terminou agora (um escritor: o laço de accept)
+    void registrar(Relogio::time_point chegada, const std::string& metodo, const std::string& alvo,
+                   const std::string& corpo, const std::string& chaveIdempotencia, size_t tamanhoResposta,
+                   int status) {
+        auto agora = Relogio::now();
+        auto ns = [](Relogio::duration d) {
+            auto n = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+            return static_cast<uint64_t>(n > 0 ? n : 0);
+        };
+        escreverInteiro(ns(chegada - inicio));
+        escreverInteiro(ns(agora - chegada));
+        escreverInteiro(static_cast<uint32_t>(tamanhoResposta));
+        escreverInteiro(static_cast<uint16_t>(status));
+        escreverTexto<uint8_t>(metodo);
+        escreverTexto<uint32_t>(alvo);
+        escreverTexto<uint32_t>(corpo);
+        escreverTexto<uint16_t>(chaveIdempotencia);
+        if (++desdeDescarga >= 64) {
+            arquivo.flush();
+            desdeDescarga = 0;
+        }
+    }
+};
+
+// Leitura sequencial de um arquivo gravado por CapturaRequisicoes
+class LeitorCaptura {
+private:
+    std::ifstream arquivo;
+    uint64_t inicioEpochNs = 0;
+
+    template <typename T>
+    bool lerInteiro(T& valor) {
+        unsigned char bytes[sizeof(T)];
+        if (!arquivo.read(reinterpret_cast<char*>(bytes), sizeof(T))) return false;
+        uint64_t v = 0;
+        for (size_t i = 0; i < sizeof(T); i++) v |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        valor = static_cast<T>(v);
+        return true;
+    }
+
+    template <typename Tamanho>
+    bool lerTexto(std::string& s) {
+        Tamanho n;
+        if (!lerInteiro(n)) return false;
+        s.resize(n);
+        return n == 0 || static_cast<bool>(arquivo.read(&s[0], static_cast<std::streamsize>(n)));
+    }
+
+public:
+    explicit LeitorCaptura(const std::string& caminho) : arquivo(caminho, std::ios::binary) {
+        if (!arquivo.is_open()) throw ComprasException("Nao foi possivel abrir a captura: " + caminho);
+        char assinatura[sizeof(CapturaRequisicoes::ASSINATURA)];
+        if (!arquivo.read(assinatura, sizeof(assinatura)) ||
+            std::string(assinatura, 7) != std::string(CapturaRequisicoes::ASSINATURA, 7))
+            throw ComprasException("Arquivo nao e uma captura de requisicoes: " + caminho);
+        if (assinatura[7] != CapturaRequisicoes::ASSINATURA[7])
+            throw ComprasException("Versao de captura nao suportada: " + std::to_string(static_cast<int>(assinatura[7])));
+        if (!lerInteiro(inicioEpochNs)) throw ComprasException("Captura truncada no cabecalho: " + caminho);
+    }
+
+    uint64_t obterInicioEpochNs() const { return inicioEpochNs; }
+
+    // Próximo registro; false no fim do arquivo (ou num registro final incompleto)
+    bool proximo(RegistroCaptura& r) {
+        return lerInteiro(r.chegadaNs) && lerInteiro(r.latenciaNs) && lerInteiro(r.tamanhoResposta) &&
+               lerInteiro(r.status) && lerTexto<uint8_t>(r.metodo) && lerTexto<uint32_t>(r.alvo) &&
+               lerTexto<uint32_t>(r.corpo) && lerTexto<uint16_t>(r.chaveIdempotencia);
+    }
+};
+
+#endif // CAPTURA_REQUISICOES_H
@@ -0,0 +1,152 @@
+#ifndef CONFIGURACAO_COMPRAS_H
+#define CONFIGURACAO_COMPRAS_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "ComprasException.h"
+#include "Dinheiro.h"
+#include "PerfilLatencia.h"
+#include "RegistroLog.h"
+
+// Como a verba de cada ordem é conferida com o financeiro
+enum class ModoVerba {
+    DIRETO,  ///< Uma verificação remota por ordem
+    LOTE,    ///< Verificações remotas agrupadas por janela de tempo (AgrupadorVerba)
+    RAZAO    ///< Reserva local contra concessões do financeiro (RazaoOrcamento)
+};
+
+/*
+ * Configuração de execução do módulo de compras.
+ * Preenchida a partir da linha de comando (servidor e console) e repassada
+ * pelo ModuloCompras aos gerenciadores. Valores 0 significam "automático".
+ */
+struct ConfiguracaoCompras {
+    unsigned threadsIntegracao = 0; ///< Threads do executor de integrações (0 = automático)
+    ModoVerba modoVerba = ModoVerba::RAZAO;
+    Dinheiro concessaoRazao = Dinheiro::deCentavos(500000); ///< Fatia pedida ao financeiro por renovação (R$ 5000,00)
+    unsigned janelaLoteVerbaMs = 20; ///< Espera para agrupar verificações de verba no modo LOTE
+    unsigned tamanhoMaximoLoteVerba = 32; ///< Lote é enviado antes da janela ao atingir este tamanho
+    unsigned prazoIntegracaoMs = 10000;   ///< Prazo de cada tentativa de chamada a um módulo integrado
+    unsigned tentativasIntegracao = 3;    ///< Tentativas das chamadas idempotentes (1 = sem repetição)
+    unsigned disjuntorFalhas = 5;         ///< Falhas seguidas que abrem o circuito de um módulo
+    unsigned disjuntorAbertoMs = 10000;   ///< Tempo com o circuito aberto antes da chamada de teste
+    std::string arquivoCaixaSaida = "data/outbox.log"; ///< Log dos eventos das ordens aprovadas
+    PerfilLatencia latenciaModulos;       ///< Latência e falhas sorteadas dos módulos simulados
+    NivelLog nivelLog = NivelLog::INFO;   ///< Registros abaixo deste nível são ignorados
+    FormatoLog formatoLog = FormatoLog::TEXTO;
+    unsigned capacidadeIdempotencia = 10000; ///< Respostas guardadas por Idempotency-Key (servidor)
+    unsigned ttlIdempotenciaS = 86400;    ///< Validade de cada resposta guardada
+    std::string arquivoCaptura;           ///< Captura binária das requisições (servidor; vazio = desligada)
+    unsigned backlogConexoes = 128;       ///< Fila de conexões completas aguardando accept (servidor; limitada por somaxconn)
+
+    // As chamadas aos módulos integrados passam a maior parte do tempo esperando
+    // (latência de rede/simulada), então o executor usa pelo menos 4 threads
+    // mesmo em máquinas com poucos núcleos.
+    unsigned obterThreadsIntegracao() const {
+        if (threadsIntegracao > 0) return threadsIntegracao;
+        return std::max(4u, std::thread::hardware_concurrency());
+    }
+
+    // Lê opções no formato "--chave=valor". Argumentos que não começam com "--"
+    // são ignorados (ex: a porta do servidor). Lança ComprasException para
+    // opções desconhecidas ou valores inválidos.
+    static ConfiguracaoCompras deArgumentos(int argc, char** argv) {
+        ConfiguracaoCompras config;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.compare(0, 2, "--") != 0) continue;
+            auto igual = arg.find('=');
+            std::string chave = arg.substr(2, igual == std::string::npos ? std::string::npos : igual - 2);
+            std::string valor = (igual == std::string::npos) ? "" : arg.substr(igual + 1);
+
+            if (chave == "threads-integracao") {
+                config.threadsIntegracao = lerInteiro(chave, valor, 1, 256);
+            } else if (chave == "verba") {
+                if (valor == "direto") config.modoVerba = ModoVerba::DIRETO;
+                else if (valor == "lote") config.modoVerba = ModoVerba::LOTE;
+                else if (valor == "razao") config.modoVerba = ModoVerba::RAZAO;
+                else throw ComprasException("Valor invalido para --verba (direto|lote|razao): '" + valor + "'");
+            } else if (chave == "razao-concessao") {
+                Dinheiro concessao;
+                if (!Dinheiro::parsear(valor, concessao) || concessao <= Dinheiro())
+                    throw ComprasException("Valor invalido para --razao-concessao: '" + valor + "'");
+                config.concessaoRazao = concessao;
+            } else if (chave == "janela-lote-verba-ms") {
+                config.janelaLoteVerbaMs = lerInteiro(chave, valor, 0, 10000);
+            } else if (chave == "lote-verba-max") {
+                config.tamanhoMaximoLoteVerba = lerInteiro(chave, valor, 1, 10000);
+            } else if (chave == "prazo-integracao-ms") {
+                config.prazoIntegracaoMs = lerInteiro(chave, valor, 1, 600000);
+            } else if (chave == "tentativas-integracao") {
+                config.tentativasIntegracao = lerInteiro(chave, valor, 1, 10);
+            } else if (chave == "disjuntor-falhas") {
+                config.disjuntorFalhas = lerInteiro(chave, valor, 1, 1000);
+            } else if (chave == "disjuntor-aberto-ms") {
+                config.disjuntorAbertoMs = lerInteiro(chave, valor, 1, 600000);
+            } else if (chave == "latencia") {
+                if (valor == "padrao") config.latenciaModulos.tipo = TipoLatencia::PADRAO;
+                else if (valor == "zero") config.latenciaModulos.tipo = TipoLatencia::ZERO;
+                else if (valor == "fixa") config.latenciaModulos.tipo = TipoLatencia::FIXA;
+                else if (valor == "lognormal") config.latenciaModulos.tipo = TipoLatencia::LOGNORMAL;
+                else throw ComprasException("Valor invalido para --latencia (padrao|zero|fixa|lognormal): '" + valor + "'");
+            } else if (chave == "latencia-fixa-ms") {
+                config.latenciaModulos.fixaMs = lerInteiro(chave, valor, 0, 600000);
+            } else if (chave == "latencia-p50-ms") {
+                config.latenciaModulos.p50Ms = lerInteiro(chave, valor, 0, 600000);
+            } else if (chave == "latencia-p99-ms") {
+                config.latenciaModulos.p99Ms = lerInteiro(chave, valor, 0, 600000);
+            } else if (chave == "taxa-falha") {
+                char* fim = nullptr;
+                double taxa = std::strtod(valor.c_str(), &fim);
+                if (valor.empty() || *fim != '\0' || taxa < 0.0 || taxa > 1.0)
+                    throw ComprasException("Valor invalido para --taxa-falha (0 a 1): '" + valor + "'");
+                config.latenciaModulos.taxaFalha = taxa;
+            } else if (chave == "semente") {
+                config.latenciaModulos.semente = lerInteiro(chave, valor, 0, 2147483647L);
+            } else if (chave == "log-nivel") {
+                if (valor == "depuracao") config.nivelLog = NivelLog::DEPURACAO;
+                else if (valor == "info") config.nivelLog = NivelLog::INFO;
+                else if (valor == "aviso") config.nivelLog = NivelLog::AVISO;
+                else if (valor == "erro") config.nivelLog = NivelLog::ERRO;
+                else throw ComprasException("Valor invalido para --log-nivel (depuracao|info|aviso|erro): '" + valor + "'");
+            } else if (chave == "log-formato") {
+                if (valor == "texto") config.formatoLog = FormatoLog::TEXTO;
+                else if (valor == "json") config.formatoLog = FormatoLog::JSON;
+                else throw ComprasException("Valor invalido para --log-formato (texto|json): '" + valor + "'");
+            } else if (chave == "idempotencia-max") {
+                config.capacidadeIdempotencia = lerInteiro(chave, valor, 1, 10000000);
+            } else if (chave == "idempotencia-ttl-s") {
+                config.ttlIdempotenciaS = lerInteiro(chave, valor, 1, 30 * 86400);
+            } else if (chave == "caixa-saida") {
+                if (valor.empty()) throw ComprasException("Valor invalido para --caixa-saida: ''");
+                config.arquivoCaixaSaida = valor;
+            } else if (chave == "backlog") {
+                config.backlogConexoes = lerInteiro(chave, valor, 1, 65535);
+            } else if (chave == "captura") {
+                if (valor.empty()) throw ComprasException("Valor invalido para --captura: ''");
+                config.arquivoCaptura = valor;
+            } else {
+                throw ComprasException("Opcao desconhecida: --" + chave);
+            }
+        }
+        if (config.latenciaModulos.p99Ms < config.latenciaModulos.p50Ms)
+            throw ComprasException("--latencia-p99-ms deve ser maior ou igual a --latencia-p50-ms");
+        if (config.latenciaModulos.tipo == TipoLatencia::LOGNORMAL && config.latenciaModulos.p50Ms == 0)
+            throw ComprasException("--latencia-p50-ms deve ser maior que zero com --latencia=lognormal");
+        return config;
+    }
+
+private:
+    static unsigned lerInteiro(const std::string& chave, const std::string& valor, long minimo, long maximo) {
+        char* fim = nullptr;
+        long n = std::strtol(valor.c_str(), &fim, 10);
+        if (valor.empty() || *fim != '\0' || n < minimo || n > maximo) {
+            throw ComprasException("Valor invalido para --" + chave + ": '" + valor + "'");
+        }
+        return static_cast<unsigned>(n);
+    }
+};
+
+#endif // CONFIGURACAO_COMPRAS_H
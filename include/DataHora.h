@@ -0,0 +1,125 @@
+#ifndef DATA_HORA_H
+#define DATA_HORA_H
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <limits>
+#include <string>
+
+/*
+ * Utilitários de data/hora baseados em epoch (segundos desde 1970, horário local).
+ * Converte entre os formatos de texto usados no sistema ("dd/mm/aaaa HH:MM:SS"
+ * e "aaaa-mm-dd" vindo da interface web) e inteiros de 64 bits.
+ */
+class DataHora {
+public:
+    // Marcador para datas ausentes ou em texto livre
+    static constexpr int64_t SEM_DATA = std::numeric_limits<int64_t>::min();
+
+private:
+    // Converte campos de data/hora locais em epoch. Usa mktime apenas uma vez por
+    // hora distinta (cache por thread), pois as mudanças de horário de verão
+    // acontecem sempre em fronteiras de hora.
+    static int64_t paraEpoch(int ano, int mes, int dia, int hora, int minuto, int segundo) {
+        thread_local int64_t chaveCache = -1;
+        thread_local int64_t inicioHoraCache = 0;
+
+        int64_t chave = ((static_cast<int64_t>(ano) * 13 + mes) * 32 + dia) * 24 + hora;
+        if (chave != chaveCache) {
+            std::tm tm{};
+            tm.tm_year = ano - 1900;
+            tm.tm_mon = mes - 1;
+            tm.tm_mday = dia;
+            tm.tm_hour = hora;
+            tm.tm_isdst = -1;
+            inicioHoraCache = static_cast<int64_t>(std::mktime(&tm));
+            chaveCache = chave;
+        }
+        return inicioHoraCache + minuto * 60 + segundo;
+    }
+
+    static int diasNoMes(int ano, int mes) {
+        static const int DIAS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool bissexto = (ano % 4 == 0 && ano % 100 != 0) || ano % 400 == 0;
+        return (mes == 2 && bissexto) ? 29 : DIAS[mes - 1];
+    }
+
+    // Lê 'n' dígitos a partir de 'pos'; retorna false se algum não for dígito
+    static bool lerNumero(const std::string& s, size_t pos, size_t n, int& valor) {
+        if (pos + n > s.size()) return false;
+        valor = 0;
+        for (size_t i = pos; i < pos + n; i++) {
+            if (s[i] < '0' || s[i] > '9') return false;
+            valor = valor * 10 + (s[i] - '0');
+        }
+        return true;
+    }
+
+public:
+    // Interpreta "dd/mm/aaaa[ HH:MM[:SS]]" ou "aaaa-mm-dd[ HH:MM[:SS]]" (também aceita 'T').
+    // Retorna false se o texto não estiver em nenhum dos formatos ou a data não existir
+    // (ex: 31/04 ou 29/02 fora de ano bissexto).
+    static bool parsear(const std::string& texto, int64_t& epoch) {
+        int dia = 0, mes = 0, ano = 0, hora = 0, minuto = 0, segundo = 0;
+        size_t pos;
+        if (texto.size() >= 10 && texto[2] == '/' && texto[5] == '/') {
+            if (!lerNumero(texto, 0, 2, dia) || !lerNumero(texto, 3, 2, mes) || !lerNumero(texto, 6, 4, ano))
+                return false;
+        } else if (texto.size() >= 10 && texto[4] == '-' && texto[7] == '-') {
+            if (!lerNumero(texto, 0, 4, ano) || !lerNumero(texto, 5, 2, mes) || !lerNumero(texto, 8, 2, dia))
+                return false;
+        } else {
+            return false;
+        }
+        pos = 10;
+        if (texto.size() > pos) {
+            if (texto[pos] != ' ' && texto[pos] != 'T') return false;
+            if (!lerNumero(texto, pos + 1, 2, hora) || texto.size() < pos + 6 || texto[pos + 3] != ':' ||
+                !lerNumero(texto, pos + 4, 2, minuto))
+                return false;
+            if (texto.size() > pos + 6) {
+                if (texto[pos + 6] != ':' || !lerNumero(texto, pos + 7, 2, segundo)) return false;
+            }
+        }
+        if (mes < 1 || mes > 12 || dia < 1 || dia > diasNoMes(ano, mes) || hora > 23 || minuto > 59 || segundo > 60)
+            return false;
+        epoch = paraEpoch(ano, mes, dia, hora, minuto, segundo);
+        return true;
+    }
+
+    static int64_t parsearOuSemData(const std::string& texto) {
+        int64_t epoch;
+        return parsear(texto, epoch) ? epoch : SEM_DATA;
+    }
+
+    // Instante atual em segundos (barato: não formata nada)
+    static int64_t agora() {
+        return static_cast<int64_t>(std::time(nullptr));
+    }
+
+    // Formata um epoch como "dd/mm/aaaa HH:MM:SS" (horário local).
+    // Thread-safe: usa localtime_r/localtime_s e guarda por thread o último
+    // segundo formatado, já que listagens costumam repetir o mesmo instante.
+    static std::string formatar(int64_t epoch) {
+        thread_local int64_t ultimoEpoch = SEM_DATA;
+        thread_local std::string ultimoTexto;
+        if (epoch == ultimoEpoch) return ultimoTexto;
+
+        std::time_t t = static_cast<std::time_t>(epoch);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d %02d:%02d:%02d",
+                      tm.tm_mday, tm.tm_mon + 1, tm.tm_year + 1900, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        ultimoEpoch = epoch;
+        ultimoTexto = buffer;
+        return ultimoTexto;
+    }
+};
+
+#endif // DATA_HORA_H
@@ -0,0 +1,157 @@
+#ifndef DINHEIRO_H
+#define DINHEIRO_H
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include "ComprasException.h"
+
+/*
+ * Valor monetário em ponto fixo (inteiro de centavos).
+ * Substitui double em preços, saldos e totais para que somas sejam exatas
+ * e a persistência não dependa de arredondamento. As operações aritméticas
+ * verificam estouro e lançam ComprasException nesse caso.
+ */
+class Dinheiro {
+private:
+    int64_t centavos;
+
+    explicit constexpr Dinheiro(int64_t c) : centavos(c) {}
+
+    static int64_t somarVerificado(int64_t a, int64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+        int64_t r;
+        if (__builtin_add_overflow(a, b, &r)) throw ComprasException("Estouro em operacao monetaria!");
+        return r;
+#else
+        if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+            (b < 0 && a < std::numeric_limits<int64_t>::min() - b))
+            throw ComprasException("Estouro em operacao monetaria!");
+        return a + b;
+#endif
+    }
+
+    static int64_t multiplicarVerificado(int64_t a, int64_t b) {
+#if defined(__GNUC__) || defined(__clang__)
+        int64_t r;
+        if (__builtin_mul_overflow(a, b, &r)) throw ComprasException("Estouro em operacao monetaria!");
+        return r;
+#else
+        if (a != 0 && b != 0) {
+            int64_t r = a * b;
+            if (r / b != a || (a == -1 && b == std::numeric_limits<int64_t>::min()) ||
+                (b == -1 && a == std::numeric_limits<int64_t>::min()))
+                throw ComprasException("Estouro em operacao monetaria!");
+            return r;
+        }
+        return 0;
+#endif
+    }
+
+public:
+    // Maior quantidade de caracteres gerada por escrever() (sinal, 17 dígitos, ponto, 2 casas)
+    static const size_t TAMANHO_MAX_TEXTO = 24;
+
+    constexpr Dinheiro() : centavos(0) {}
+
+    static constexpr Dinheiro deCentavos(int64_t c) { return Dinheiro(c); }
+
+    int64_t emCentavos() const { return centavos; }
+
+    // Interpreta "123", "123.4", "123,45", "-0.10" (ponto ou vírgula decimal).
+    // Casas além da segunda são arredondadas pela terceira (meio para longe do zero).
+    // Retorna false se o texto não for um valor válido ou não couber em 64 bits.
+    static bool parsear(const char* ini, const char* fim, Dinheiro& resultado) {
+        while (ini < fim && (*ini == ' ' || *ini == '\t')) ini++;
+        while (fim > ini && (fim[-1] == ' ' || fim[-1] == '\t' || fim[-1] == '\r')) fim--;
+        bool negativo = false;
+        if (ini < fim && (*ini == '-' || *ini == '+')) { negativo = (*ini == '-'); ini++; }
+
+        const int64_t limite = std::numeric_limits<int64_t>::max() / 100 - 1;
+        int64_t inteiro = 0;
+        int digitos = 0;
+        while (ini < fim && *ini >= '0' && *ini <= '9') {
+            inteiro = inteiro * 10 + (*ini - '0');
+            if (inteiro > limite) return false;
+            ini++; digitos++;
+        }
+        int64_t fracao = 0;
+        if (ini < fim && (*ini == '.' || *ini == ',')) {
+            ini++;
+            int casas = 0;
+            while (ini < fim && *ini >= '0' && *ini <= '9') {
+                if (casas < 2) fracao = fracao * 10 + (*ini - '0');
+                else if (casas == 2 && *ini >= '5') fracao++;
+                ini++; casas++; digitos++;
+            }
+            if (casas == 1) fracao *= 10;
+        }
+        if (ini != fim || digitos == 0) return false;
+        int64_t total = inteiro * 100 + fracao;
+        resultado = Dinheiro(negativo ? -total : total);
+        return true;
+    }
+
+    static bool parsear(const std::string& texto, Dinheiro& resultado) {
+        return parsear(texto.data(), texto.data() + texto.size(), resultado);
+    }
+
+    // Versão que lança ComprasException para entradas inválidas
+    static Dinheiro deTexto(const std::string& texto) {
+        Dinheiro d;
+        if (!parsear(texto, d)) throw ComprasException("Valor monetario invalido: " + texto);
+        return d;
+    }
+
+    // Escreve o valor como "1234.56" em 'destino' (ao menos TAMANHO_MAX_TEXTO bytes).
+    // Retorna quantos caracteres foram escritos (sem terminador).
+    size_t escrever(char* destino) const {
+        uint64_t v = (centavos < 0) ? 0 - static_cast<uint64_t>(centavos) : static_cast<uint64_t>(centavos);
+        char tmp[TAMANHO_MAX_TEXTO];
+        size_t n = 0;
+        tmp[n++] = static_cast<char>('0' + v % 10); v /= 10;
+        tmp[n++] = static_cast<char>('0' + v % 10); v /= 10;
+        tmp[n++] = '.';
+        do { tmp[n++] = static_cast<char>('0' + v % 10); v /= 10; } while (v != 0);
+        if (centavos < 0) tmp[n++] = '-';
+        for (size_t i = 0; i < n; i++) destino[i] = tmp[n - 1 - i];
+        return n;
+    }
+
+    std::string formatar() const {
+        char buffer[TAMANHO_MAX_TEXTO];
+        return std::string(buffer, escrever(buffer));
+    }
+
+    // ========== ARITMETICA (com verificação de estouro) ==========
+    Dinheiro operator+(Dinheiro outro) const { return Dinheiro(somarVerificado(centavos, outro.centavos)); }
+    Dinheiro operator-(Dinheiro outro) const {
+        if (outro.centavos == std::numeric_limits<int64_t>::min()) throw ComprasException("Estouro em operacao monetaria!");
+        return Dinheiro(somarVerificado(centavos, -outro.centavos));
+    }
+    Dinheiro operator*(int64_t fator) const { return Dinheiro(multiplicarVerificado(centavos, fator)); }
+    // Divisão com arredondamento meio para longe do zero (ex: rateios e percentuais)
+    Dinheiro operator/(int64_t divisor) const {
+        if (divisor == 0) throw ComprasException("Divisao monetaria por zero!");
+        int64_t q = centavos / divisor, r = centavos % divisor;
+        if (r != 0 && (r < 0 ? -r : r) * 2 >= (divisor < 0 ? -divisor : divisor)) q += ((centavos < 0) != (divisor < 0)) ? -1 : 1;
+        return Dinheiro(q);
+    }
+    Dinheiro& operator+=(Dinheiro outro) { *this = *this + outro; return *this; }
+    Dinheiro& operator-=(Dinheiro outro) { *this = *this - outro; return *this; }
+
+    bool operator==(Dinheiro o) const { return centavos == o.centavos; }
+    bool operator!=(Dinheiro o) const { return centavos != o.centavos; }
+    bool operator<(Dinheiro o) const { return centavos < o.centavos; }
+    bool operator<=(Dinheiro o) const { return centavos <= o.centavos; }
+    bool operator>(Dinheiro o) const { return centavos > o.centavos; }
+    bool operator>=(Dinheiro o) const { return centavos >= o.centavos; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, Dinheiro d) {
+    char buffer[Dinheiro::TAMANHO_MAX_TEXTO];
+    return os.write(buffer, static_cast<std::streamsize>(d.escrever(buffer)));
+}
+
+#endif // DINHEIRO_H
@@ -2,15 +2,21 @@
 #define ESTOQUE_MOCK_H
 
 #include "IEstoque.h"
+#include "SimuladorFalhas.h"
+#include "PerfilLatencia.h"
+#include "RegistroLog.h"
 #include <iostream>
 #include <map>
+#include <set>
 #include <vector>
 #include <sstream>
+#include <mutex>
 
 /*
  * Implementação simulada do módulo de estoque.
  * Usado para demonstrar a integração com o módulo de compras.
  * Em um sistema real, seria substituído por um módulo de estoque completo.
+ * Thread-safe: o inventário é protegido por mutex.
  */
 class EstoqueMock : public IEstoque {
 private:
@@ -21,10 +27,14 @@ private:
     };
     
     std::map<int, ItemEstoque> inventario; // idMaterial -> dados do item
+    std::set<int> ordensRegistradas;       // Ordens cuja entrada já foi registrada
+    mutable std::mutex mutex;              // Protege o inventário
+    SimuladorFalhas falhas;                // Atraso/falha injetados (testes de resiliência)
+    ModeloLatencia latencia{3}; // Latência simulada de cada chamada (ver PerfilLatencia)
 
 public:
     EstoqueMock() {
-        std::cout << "[EstoqueMock] Módulo de estoque inicializado (simulado).\n";
+        LOG_INFO("ESTOQUE", "Modulo de estoque inicializado (simulado)");
         // Inicializa com alguns itens exemplo
         inventario[1] = {"Aço Inox", 100, 0};
         inventario[2] = {"Parafusos M10", 500, 0};
@@ -32,14 +42,26 @@ public:
     }
 
     ~EstoqueMock() override {
-        std::cout << "[EstoqueMock] Módulo de estoque finalizado.\n";
+        LOG_INFO("ESTOQUE", "Modulo de estoque finalizado");
     }
 
     bool registrarEntradaCompra(int idMaterial, int quantidade, int idOrdemCompra) override {
-        std::cout << "[EstoqueMock] Registrando entrada de compra no estoque:\n"
-                  << "             Material ID " << idMaterial << ", Quantidade: " 
-                  << quantidade << ", Ordem: #" << idOrdemCompra << "\n";
-        
+        bool aplicada = false;
+        return registrarEntradaCompra(idMaterial, quantidade, idOrdemCompra, aplicada);
+    }
+
+    // Como acima; 'aplicada' diz se a quantidade entrou no inventário agora
+    // (false quando a entrada da ordem já tinha sido registrada antes)
+    bool registrarEntradaCompra(int idMaterial, int quantidade, int idOrdemCompra, bool& aplicada) {
+        aplicada = false;
+        falhas.aplicar("ESTOQUE");
+        latencia.esperar("ESTOQUE", 0, 0);
+        std::lock_guard<std::mutex> lock(mutex);
+        // Idempotente por ordem: a entrega de eventos pode repetir a mesma entrada
+        if (idOrdemCompra > 0 && !ordensRegistradas.insert(idOrdemCompra).second) {
+            LOG_INFO("ESTOQUE", "Entrada ja registrada, ignorada idOrdem=" << idOrdemCompra);
+            return true;
+        }
         // Se o material não existe, cria com nome genérico
         if (inventario.find(idMaterial) == inventario.end()) {
             inventario[idMaterial] = {"Material " + std::to_string(idMaterial), 0, 0};
@@ -48,33 +70,27 @@ public:
         // Adiciona a quantidade
         inventario[idMaterial].quantidade += quantidade;
         inventario[idMaterial].idUltimaOrdem = idOrdemCompra;
+        aplicada = true;
         
-        std::cout << "[EstoqueMock] Entrada registrada com sucesso. "
-                  << "Quantidade total: " << inventario[idMaterial].quantidade << "\n";
+        LOG_INFO("ESTOQUE", "Entrada registrada idMaterial=" << idMaterial << " quantidade=" << quantidade
+                            << " idOrdem=" << idOrdemCompra << " total=" << inventario[idMaterial].quantidade);
         return true;
     }
 
     int consultarItem(int idMaterial) override {
+        std::lock_guard<std::mutex> lock(mutex);
         auto it = inventario.find(idMaterial);
         if (it != inventario.end()) {
-            std::cout << "[EstoqueMock] Consulta - Material ID " << idMaterial 
-                      << " (" << it->second.nome << "): " 
-                      << it->second.quantidade << " unidades\n";
             return it->second.quantidade;
         }
-        
-        std::cout << "[EstoqueMock] Material ID " << idMaterial 
-                  << " não encontrado no estoque\n";
         return -1;
     }
 
     std::vector<std::string> listarTodosItens() override {
         std::vector<std::string> lista;
-        
-        std::cout << "[EstoqueMock] Listando todos os itens do estoque:\n";
+        std::lock_guard<std::mutex> lock(mutex);
         
         if (inventario.empty()) {
-            std::cout << "[EstoqueMock] Estoque vazio.\n";
             lista.push_back("Estoque vazio");
         } else {
             for (const auto& item : inventario) {
@@ -82,7 +98,6 @@ public:
                 oss << "ID: " << item.first << " | Nome: " << item.second.nome 
                     << " | Quantidade: " << item.second.quantidade;
                 lista.push_back(oss.str());
-                std::cout << "[EstoqueMock] " << oss.str() << "\n";
             }
         }
         
@@ -90,50 +105,64 @@ public:
     }
 
     int verificarDisponibilidade(int idMaterial) override {
+        std::lock_guard<std::mutex> lock(mutex);
         auto it = inventario.find(idMaterial);
         if (it != inventario.end()) {
-            std::cout << "[EstoqueMock] Material ID " << idMaterial 
-                      << " disponível: " << it->second.quantidade << " unidades\n";
             return it->second.quantidade;
         }
-        
-        std::cout << "[EstoqueMock] Material ID " << idMaterial 
-                  << " não encontrado no estoque (0 unidades)\n";
         return 0;
     }
 
     bool reservarMaterial(int idMaterial, int quantidade) override {
+        falhas.aplicar("ESTOQUE");
+        latencia.esperar("ESTOQUE", 0, 0);
+        std::lock_guard<std::mutex> lock(mutex);
         auto it = inventario.find(idMaterial);
         
         if (it == inventario.end() || it->second.quantidade < quantidade) {
-            std::cout << "[EstoqueMock] FALHA: Quantidade insuficiente para reservar. "
-                      << "Material ID " << idMaterial << ", Solicitado: " << quantidade 
-                      << ", Disponível: " << (it != inventario.end() ? it->second.quantidade : 0) << "\n";
+            LOG_INFO("ESTOQUE", "Reserva recusada, quantidade insuficiente idMaterial=" << idMaterial
+                                << " solicitado=" << quantidade
+                                << " disponivel=" << (it != inventario.end() ? it->second.quantidade : 0));
             return false;
         }
         
         // Reduz a quantidade disponível
         inventario[idMaterial].quantidade -= quantidade;
         
-        std::cout << "[EstoqueMock] Material reservado com sucesso. "
-                  << "Material ID " << idMaterial << ", Quantidade: " << quantidade 
-                  << ", Restante: " << inventario[idMaterial].quantidade << "\n";
+        LOG_INFO("ESTOQUE", "Material reservado idMaterial=" << idMaterial << " quantidade=" << quantidade
+                            << " restante=" << inventario[idMaterial].quantidade);
         return true;
     }
 
-    // Método auxiliar para exibir o inventário completo (não faz parte da interface)
+    // Injeção de atraso/falha (teste)
+    SimuladorFalhas& getSimuladorFalhas() {
+        return falhas;
+    }
+
+    // Perfil de latência das chamadas (benchmarks e testes de carga)
+    void configurarLatencia(const PerfilLatencia& perfil) {
+        latencia.configurar(perfil);
+    }
+
+    // Método auxiliar para exibir o inventário completo (não faz parte da interface).
+    // O texto é montado sob o mutex e escrito no terminal depois de liberá-lo.
     void exibirInventario() const {
-        std::cout << "\n=== INVENTÁRIO DO ESTOQUE ===\n";
-        if (inventario.empty()) {
-            std::cout << "Estoque vazio.\n";
-        } else {
-            for (const auto& item : inventario) {
-                std::cout << "Material ID " << item.first 
-                          << " (" << item.second.nome << "): " 
-                          << item.second.quantidade << " unidades\n";
+        std::ostringstream os;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            os << "\n=== INVENTÁRIO DO ESTOQUE ===\n";
+            if (inventario.empty()) {
+                os << "Estoque vazio.\n";
+            } else {
+                for (const auto& item : inventario) {
+                    os << "Material ID " << item.first
+                       << " (" << item.second.nome << "): "
+                       << item.second.quantidade << " unidades\n";
+                }
             }
+            os << "============================\n\n";
         }
-        std::cout << "============================\n\n";
+        std::cout << os.str();
     }
 };
 
@@ -0,0 +1,480 @@
+#ifndef EXECUTOR_INTEGRACAO_H
+#define EXECUTOR_INTEGRACAO_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ComprasException.h"
+
+class ExecutorIntegracao;
+
+namespace detalhe {
+
+// Estado compartilhado entre a tarefa que produz o resultado e os Futuros que o consomem
+template <typename T>
+struct EstadoFuturo {
+    std::mutex mutex;
+    std::condition_variable concluido;
+    bool pronto = false;
+    std::optional<T> valor;
+    std::exception_ptr erro;
+    std::vector<std::function<void()>> continuacoes;
+    ExecutorIntegracao* executor = nullptr;
+
+    void concluir(std::optional<T> v, std::exception_ptr e) {
+        std::vector<std::function<void()>> pendentes;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            valor = std::move(v);
+            erro = e;
+            pronto = true;
+            pendentes.swap(continuacoes);
+        }
+        concluido.notify_all();
+        for (auto& c : pendentes) c();
+    }
+
+    void definirValor(T v) { concluir(std::optional<T>(std::move(v)), nullptr); }
+    void definirErro(std::exception_ptr e) { concluir(std::nullopt, e); }
+
+    // Executa 'c' quando o resultado existir (na hora, se já existir)
+    void aoConcluir(std::function<void()> c) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pronto) {
+                continuacoes.push_back(std::move(c));
+                return;
+            }
+        }
+        c();
+    }
+};
+
+} // namespace detalhe
+
+/*
+ * Resultado futuro de uma tarefa do ExecutorIntegracao.
+ * obter() bloqueia até o resultado existir (relançando a exceção da tarefa, se houver);
+ * entao() encadeia uma continuação que roda no executor sem bloquear ninguém, e
+ * encadear() uma continuação que devolve outro Futuro (ex: uma chamada remota).
+ * Cópias compartilham o mesmo estado. O tipo do resultado não pode ser void.
+ */
+template <typename T>
+class Futuro {
+private:
+    std::shared_ptr<detalhe::EstadoFuturo<T>> estado;
+
+    friend class ExecutorIntegracao;
+    template <typename> friend class Futuro;
+    template <typename> friend class Promessa;
+
+    explicit Futuro(std::shared_ptr<detalhe::EstadoFuturo<T>> e) : estado(std::move(e)) {}
+
+public:
+    using TipoValor = T;
+
+    Futuro() = default;
+
+    bool valido() const { return estado != nullptr; }
+
+    bool pronto() const {
+        std::lock_guard<std::mutex> lock(estado->mutex);
+        return estado->pronto;
+    }
+
+    T obter() const;
+
+    // Espera no máximo 'duracao' pelo resultado; devolve se ficou pronto.
+    // Não executa outras tarefas enquanto espera (use para futuros de outro executor).
+    template <typename Rep, typename Period>
+    bool aguardarPor(std::chrono::duration<Rep, Period> duracao) const {
+        if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+        std::unique_lock<std::mutex> lock(estado->mutex);
+        return estado->concluido.wait_for(lock, duracao, [this] { return estado->pronto; });
+    }
+
+    template <typename F>
+    auto entao(F continuacao) const -> Futuro<std::invoke_result_t<F, T>>;
+
+    // Como entao(), mas a continuação recebe o próprio Futuro (já pronto) e roda
+    // também em caso de erro; obter() dentro dela devolve o valor ou relança a exceção.
+    template <typename F>
+    auto quandoPronto(F continuacao) const -> Futuro<std::invoke_result_t<F, const Futuro<T>&>>;
+
+    // Como entao(), mas a continuação devolve um Futuro; o resultado só fica pronto
+    // quando esse Futuro interno ficar (sem ninguém esperando por ele).
+    template <typename F>
+    auto encadear(F continuacao) const -> std::invoke_result_t<F, T>;
+
+    // O mesmo resultado, com as continuações seguintes rodando em 'destino'
+    // (ex: trazer a resposta de uma chamada remota de volta ao executor do fluxo).
+    Futuro<T> transferirPara(ExecutorIntegracao& destino) const;
+};
+
+/*
+ * Executor persistente para as chamadas aos módulos integrados
+ * (financeiro, produção e estoque).
+ * Cada thread tem sua própria fila: retira tarefas do fim dela (LIFO) e,
+ * quando ela esvazia, rouba do início das filas das outras threads.
+ * Tarefas submetidas de fora do executor são distribuídas em rodízio.
+ * Mede a profundidade das filas e o tempo de espera/execução das tarefas.
+ */
+class ExecutorIntegracao {
+public:
+    struct Metricas {
+        unsigned threads = 0;
+        size_t profundidadeFila = 0;     ///< Tarefas aguardando execução agora
+        size_t profundidadeMaxima = 0;   ///< Maior profundidade observada
+        uint64_t tarefasConcluidas = 0;
+        uint64_t tarefasRoubadas = 0;    ///< Executadas por uma thread que não a dona da fila
+        double esperaMediaMs = 0.0;      ///< Tempo médio entre submissão e início
+        double execucaoMediaMs = 0.0;    ///< Tempo médio de execução
+        double latenciaMaximaMs = 0.0;   ///< Maior espera + execução observada
+    };
+
+private:
+    using Relogio = std::chrono::steady_clock;
+
+    struct Tarefa {
+        std::function<void()> funcao;
+        Relogio::time_point enfileirada;
+    };
+
+    struct FilaTrabalho {
+        std::mutex mutex;
+        std::deque<Tarefa> tarefas;
+    };
+
+    std::vector<std::unique_ptr<FilaTrabalho>> filas;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> pendentes{0};
+    std::atomic<size_t> proximaFila{0};
+    std::atomic<size_t> profundidadeMaxima{0};
+    std::atomic<uint64_t> concluidas{0};
+    std::atomic<uint64_t> roubadas{0};
+    std::atomic<uint64_t> esperaTotalNs{0};
+    std::atomic<uint64_t> execucaoTotalNs{0};
+    std::atomic<uint64_t> latenciaMaximaNs{0};
+
+    std::mutex mutexSono;             ///< Usado só para adormecer/acordar threads ociosas
+    std::condition_variable acordar;
+    bool encerrando = false;          ///< Protegido por mutexSono
+
+    template <typename> friend class Futuro;
+
+    // Executor e fila da thread atual (nullptr/0 fora do executor)
+    static ExecutorIntegracao*& executorAtual() {
+        thread_local ExecutorIntegracao* executor = nullptr;
+        return executor;
+    }
+    static size_t& filaAtual() {
+        thread_local size_t indice = 0;
+        return indice;
+    }
+
+    template <typename N>
+    static void registrarMaximo(std::atomic<N>& maximo, N valor) {
+        N atual = maximo.load(std::memory_order_relaxed);
+        while (valor > atual && !maximo.compare_exchange_weak(atual, valor, std::memory_order_relaxed)) {}
+    }
+
+    // A tarefa nunca lança: quem submete embrulha a função e guarda a exceção no Futuro
+    void enfileirar(std::function<void()> funcao) {
+        size_t indice = naThreadDoExecutor() ? filaAtual()
+                                             : proximaFila.fetch_add(1, std::memory_order_relaxed) % filas.size();
+        // Conta antes de publicar: uma thread que acorde cedo só gira até a tarefa aparecer
+        registrarMaximo(profundidadeMaxima, pendentes.fetch_add(1) + 1);
+        {
+            std::lock_guard<std::mutex> lock(filas[indice]->mutex);
+            filas[indice]->tarefas.push_back(Tarefa{std::move(funcao), Relogio::now()});
+        }
+        // Notifica com o mutex: quem enfileira de fora (ex: o temporizador) não pode tocar
+        // no executor depois que a tarefa rodou e o dono já pode tê-lo destruído
+        std::lock_guard<std::mutex> lock(mutexSono);
+        acordar.notify_one();
+    }
+
+    bool retirar(size_t indice, Tarefa& tarefa) {
+        {
+            FilaTrabalho& propria = *filas[indice];
+            std::lock_guard<std::mutex> lock(propria.mutex);
+            if (!propria.tarefas.empty()) {
+                tarefa = std::move(propria.tarefas.back());
+                propria.tarefas.pop_back();
+                pendentes.fetch_sub(1);
+                return true;
+            }
+        }
+        for (size_t k = 1; k < filas.size(); k++) {
+            FilaTrabalho& outra = *filas[(indice + k) % filas.size()];
+            std::lock_guard<std::mutex> lock(outra.mutex);
+            if (!outra.tarefas.empty()) {
+                tarefa = std::move(outra.tarefas.front());
+                outra.tarefas.pop_front();
+                pendentes.fetch_sub(1);
+                roubadas.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void executar(Tarefa& tarefa) {
+        auto inicio = Relogio::now();
+        tarefa.funcao();
+        auto fim = Relogio::now();
+        tarefa.funcao = nullptr;
+
+        auto espera = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(inicio - tarefa.enfileirada).count());
+        auto execucao = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(fim - inicio).count());
+        esperaTotalNs.fetch_add(espera, std::memory_order_relaxed);
+        execucaoTotalNs.fetch_add(execucao, std::memory_order_relaxed);
+        registrarMaximo(latenciaMaximaNs, espera + execucao);
+        concluidas.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void laco(size_t indice) {
+        executorAtual() = this;
+        filaAtual() = indice;
+        Tarefa tarefa;
+        while (true) {
+            if (retirar(indice, tarefa)) {
+                executar(tarefa);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mutexSono);
+            acordar.wait(lock, [this] { return encerrando || pendentes.load() > 0; });
+            if (encerrando && pendentes.load() == 0) return;
+        }
+    }
+
+public:
+    explicit ExecutorIntegracao(unsigned numThreads) {
+        if (numThreads == 0) numThreads = 1;
+        for (unsigned i = 0; i < numThreads; i++) filas.push_back(std::make_unique<FilaTrabalho>());
+        for (unsigned i = 0; i < numThreads; i++) threads.emplace_back(&ExecutorIntegracao::laco, this, i);
+    }
+
+    // Executa o que ainda estiver nas filas e encerra as threads
+    ~ExecutorIntegracao() {
+        {
+            std::lock_guard<std::mutex> lock(mutexSono);
+            encerrando = true;
+        }
+        acordar.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    ExecutorIntegracao(const ExecutorIntegracao&) = delete;
+    ExecutorIntegracao& operator=(const ExecutorIntegracao&) = delete;
+
+    // Agenda 'funcao' e devolve o Futuro do seu resultado
+    template <typename F>
+    auto submeter(F funcao) -> Futuro<std::invoke_result_t<F>> {
+        using R = std::invoke_result_t<F>;
+        static_assert(!std::is_void<R>::value, "Tarefas do executor devem retornar um valor");
+        auto estado = std::make_shared<detalhe::EstadoFuturo<R>>();
+        estado->executor = this;
+        enfileirar([estado, funcao]() mutable {
+            try {
+                estado->definirValor(funcao());
+            } catch (...) {
+                estado->definirErro(std::current_exception());
+            }
+        });
+        return Futuro<R>(estado);
+    }
+
+    bool naThreadDoExecutor() const { return executorAtual() == this; }
+
+    // Executa uma tarefa pendente na thread atual, se ela for do executor.
+    // Usado pela espera cooperativa de Futuro::obter().
+    bool executarPendente() {
+        if (!naThreadDoExecutor()) return false;
+        Tarefa tarefa;
+        if (!retirar(filaAtual(), tarefa)) return false;
+        executar(tarefa);
+        return true;
+    }
+
+    Metricas obterMetricas() const {
+        Metricas m;
+        m.threads = static_cast<unsigned>(threads.size());
+        m.profundidadeFila = pendentes.load();
+        m.profundidadeMaxima = profundidadeMaxima.load();
+        m.tarefasConcluidas = concluidas.load();
+        m.tarefasRoubadas = roubadas.load();
+        if (m.tarefasConcluidas > 0) {
+            m.esperaMediaMs = esperaTotalNs.load() / 1e6 / m.tarefasConcluidas;
+            m.execucaoMediaMs = execucaoTotalNs.load() / 1e6 / m.tarefasConcluidas;
+        }
+        m.latenciaMaximaMs = latenciaMaximaNs.load() / 1e6;
+        return m;
+    }
+};
+
+/*
+ * Lado produtor de um Futuro cujo resultado não vem de uma tarefa submetida
+ * (ex: respostas agrupadas em lote). As continuações do Futuro rodam no executor
+ * informado. Deve ser cumprida exatamente uma vez.
+ */
+template <typename T>
+class Promessa {
+private:
+    std::shared_ptr<detalhe::EstadoFuturo<T>> estado;
+
+public:
+    explicit Promessa(ExecutorIntegracao& executor) : estado(std::make_shared<detalhe::EstadoFuturo<T>>()) {
+        estado->executor = &executor;
+    }
+
+    Futuro<T> obterFuturo() const { return Futuro<T>(estado); }
+    void cumprir(T valor) const { estado->definirValor(std::move(valor)); }
+    void falhar(std::exception_ptr erro) const { estado->definirErro(erro); }
+};
+
+// Se quem espera é uma thread do próprio executor, ela executa outras tarefas
+// enquanto o resultado não chega: com todas as threads esperando umas pelas
+// outras, ninguém sobraria para executar a tarefa aguardada.
+template <typename T>
+T Futuro<T>::obter() const {
+    if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+    ExecutorIntegracao* executor = estado->executor;
+    if (executor && executor->naThreadDoExecutor()) {
+        while (!pronto()) {
+            if (!executor->executarPendente()) {
+                std::unique_lock<std::mutex> lock(estado->mutex);
+                estado->concluido.wait_for(lock, std::chrono::milliseconds(1), [this] { return estado->pronto; });
+            }
+        }
+    }
+    std::unique_lock<std::mutex> lock(estado->mutex);
+    estado->concluido.wait(lock, [this] { return estado->pronto; });
+    if (estado->erro) std::rethrow_exception(estado->erro);
+    return *estado->valor;
+}
+
+// A continuação recebe o valor desta tarefa; se ela falhou, a exceção é
+// repassada ao novo Futuro sem executar a continuação.
+template <typename T>
+template <typename F>
+auto Futuro<T>::entao(F continuacao) const -> Futuro<std::invoke_result_t<F, T>> {
+    using R = std::invoke_result_t<F, T>;
+    static_assert(!std::is_void<R>::value, "Continuacoes do executor devem retornar um valor");
+    if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+
+    auto origem = estado;
+    auto proximo = std::make_shared<detalhe::EstadoFuturo<R>>();
+    ExecutorIntegracao* executor = estado->executor;
+    proximo->executor = executor;
+
+    origem->aoConcluir([origem, proximo, executor, continuacao]() {
+        if (origem->erro) {
+            proximo->definirErro(origem->erro);
+            return;
+        }
+        executor->enfileirar([origem, proximo, continuacao]() mutable {
+            try {
+                proximo->definirValor(continuacao(*origem->valor));
+            } catch (...) {
+                proximo->definirErro(std::current_exception());
+            }
+        });
+    });
+    return Futuro<R>(proximo);
+}
+
+template <typename T>
+template <typename F>
+auto Futuro<T>::quandoPronto(F continuacao) const -> Futuro<std::invoke_result_t<F, const Futuro<T>&>> {
+    using R = std::invoke_result_t<F, const Futuro<T>&>;
+    static_assert(!std::is_void<R>::value, "Continuacoes do executor devem retornar um valor");
+    if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+
+    auto origem = estado;
+    auto proximo = std::make_shared<detalhe::EstadoFuturo<R>>();
+    ExecutorIntegracao* executor = estado->executor;
+    proximo->executor = executor;
+
+    origem->aoConcluir([origem, proximo, executor, continuacao]() {
+        executor->enfileirar([origem, proximo, continuacao]() mutable {
+            try {
+                proximo->definirValor(continuacao(Futuro<T>(origem)));
+            } catch (...) {
+                proximo->definirErro(std::current_exception());
+            }
+        });
+    });
+    return Futuro<R>(proximo);
+}
+
+template <typename T>
+template <typename F>
+auto Futuro<T>::encadear(F continuacao) const -> std::invoke_result_t<F, T> {
+    using FuturoInterno = std::invoke_result_t<F, T>;
+    using R = typename FuturoInterno::TipoValor;
+    if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+
+    auto origem = estado;
+    auto proximo = std::make_shared<detalhe::EstadoFuturo<R>>();
+    ExecutorIntegracao* executor = estado->executor;
+    proximo->executor = executor;
+
+    origem->aoConcluir([origem, proximo, executor, continuacao]() {
+        if (origem->erro) {
+            proximo->definirErro(origem->erro);
+            return;
+        }
+        executor->enfileirar([origem, proximo, continuacao]() mutable {
+            try {
+                auto interno = continuacao(*origem->valor).estado;
+                if (!interno) throw ComprasException("Futuro sem tarefa associada!");
+                interno->aoConcluir([interno, proximo]() { proximo->concluir(interno->valor, interno->erro); });
+            } catch (...) {
+                proximo->definirErro(std::current_exception());
+            }
+        });
+    });
+    return FuturoInterno(proximo);
+}
+
+template <typename T>
+Futuro<T> Futuro<T>::transferirPara(ExecutorIntegracao& destino) const {
+    if (!estado) throw ComprasException("Futuro sem tarefa associada!");
+    auto origem = estado;
+    auto proximo = std::make_shared<detalhe::EstadoFuturo<T>>();
+    proximo->executor = &destino;
+    origem->aoConcluir([origem, proximo]() { proximo->concluir(origem->valor, origem->erro); });
+    return Futuro<T>(proximo);
+}
+
+// Futuro já cumprido com 'valor' (ex: um caminho que não precisou de chamada remota)
+template <typename T>
+Futuro<T> futuroPronto(ExecutorIntegracao& executor, T valor) {
+    Promessa<T> pronta(executor);
+    pronta.cumprir(std::move(valor));
+    return pronta.obterFuturo();
+}
+
+// Espera todos os Futuros e devolve os resultados na mesma ordem
+template <typename T>
+std::vector<T> aguardarTodos(const std::vector<Futuro<T>>& futuros) {
+    std::vector<T> resultados;
+    resultados.reserve(futuros.size());
+    for (const auto& f : futuros) resultados.push_back(f.obter());
+    return resultados;
+}
+
+#endif // EXECUTOR_INTEGRACAO_H
@@ -2,152 +2,230 @@
 #define FINANCEIRO_MOCK_H
 
 #include "IFinanceiro.h"
-#include <iostream>
+#include "SimuladorFalhas.h"
+#include "PerfilLatencia.h"
+#include "RegistroLog.h"
 #include <iomanip>
-#include <random>
 #include <chrono>
 #include <thread>
 #include <vector>
 #include <sstream>
 #include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
 
 /*
  * Implementação mock do módulo financeiro.
  * Simula latência, decisões e logs para testes locais.
+ * Thread-safe: pode ser chamado por várias ordens ao mesmo tempo
+ * (o mutex protege o estado, nunca é mantido durante a latência simulada).
  */
 class FinanceiroMock : public IFinanceiro {
 private:
     struct ContaPagar {
         int idOrdemCompra;
-        double valorTotal;
+        Dinheiro valorTotal;
         std::string fornecedor;
         std::string dataVencimento;
         bool paga;
     };
     
-    double saldoDisponivel;     ///< Saldo simulado do módulo
-    bool estaOperacional;       ///< Se o módulo está operacional
+    Dinheiro saldoDisponivel;   ///< Saldo simulado do módulo
+    std::atomic<bool> estaOperacional; ///< Se o módulo está operacional
     std::map<int, ContaPagar> contasPagar; ///< Contas a pagar registradas
+    std::set<int> pagamentosAutorizados;   ///< Chave de idempotência de autorizarPagamento
+    mutable std::mutex mutex;   ///< Protege saldo e contas a pagar
+    SimuladorFalhas falhas;   ///< Atraso/falha injetados (testes de resiliência)
+    ModeloLatencia latencia{1}; ///< Latência simulada de cada chamada (ver PerfilLatencia)
 
 public:
     // Construtor: inicializa saldo padrão e estado operacional
-    FinanceiroMock() : saldoDisponivel(100000.0), estaOperacional(true) {}
+    FinanceiroMock() : saldoDisponivel(Dinheiro::deCentavos(10000000)), estaOperacional(true) {}
 
     // Define o saldo disponível (uso em testes)
-    void setSaldoDisponivel(double saldo) {
+    void setSaldoDisponivel(Dinheiro saldo) {
+        std::lock_guard<std::mutex> lock(mutex);
         saldoDisponivel = saldo;
     }
 
-    // Verifica disponibilidade simulada: imprime log, dorme 2-4s e compara saldo
-    bool verificarDisponibilidade(double valor) override {
+    // Verifica disponibilidade simulada: imprime log, dorme (padrão 2-4s) e compara saldo
+    bool verificarDisponibilidade(Dinheiro valor) override {
+        falhas.aplicar("FINANCEIRO");
         if (!estaOperacional) {
-            std::cout << "[FINANCEIRO] Modulo indisponivel!\n";
+            LOG_AVISO("FINANCEIRO", "Modulo indisponivel");
             return false;
         }
 
-        std::cout << "[FINANCEIRO] Verificando disponibilidade de R$ " 
-                  << std::fixed << std::setprecision(2) << valor << "...\n";
-        
-        // Simula latencia de comunicacao (2-4 segundos)
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(2000, 4000); // 2-4 segundos
-        int latencia_ms = dis(gen);
-        
-        std::cout << "[FINANCEIRO] Aguardando resposta (latencia: " 
-                  << latencia_ms << "ms)...\n";
-        
-        // Dorme na thread atual para simular latencia
-        std::this_thread::sleep_for(std::chrono::milliseconds(latencia_ms));
-
-        bool resultado = (valor <= saldoDisponivel);
-        
+        LOG_DEPURACAO("FINANCEIRO", "Verificando disponibilidade valor=" << valor);
+
+        // Simula latencia de comunicacao (padrão: 2-4 segundos), dormindo na thread atual
+        int latencia_ms = latencia.esperar("FINANCEIRO", 2000, 4000);
+
+        Dinheiro saldo = getSaldo();
+        bool resultado = (valor <= saldo);
+
         if (resultado) {
-            std::cout << "[FINANCEIRO] Verba DISPONIVEL!\n";
+            LOG_INFO("FINANCEIRO", "Verba DISPONIVEL valor=" << valor << " latenciaMs=" << latencia_ms);
         } else {
-            std::cout << "[FINANCEIRO] Verba INSUFICIENTE!\n";
-            std::cout << "[FINANCEIRO]    Saldo: R$ " << saldoDisponivel 
-                      << " | Solicitado: R$ " << valor << "\n";
+            LOG_INFO("FINANCEIRO", "Verba INSUFICIENTE valor=" << valor << " saldo=" << saldo
+                                   << " latenciaMs=" << latencia_ms);
         }
 
         return resultado;
     }
 
-    // Autoriza pagamento (simulado): log, espera 1-2s e retorna sucesso
+    // Verificação em lote: uma única latência simulada (padrão 2-4s) para todo o lote.
+    // Todos os pedidos são comparados com o mesmo saldo, lido uma vez sob o mutex,
+    // de modo que cada um recebe a mesma resposta que teria na chamada individual
+    // naquele instante (a verificação não reserva verba).
+    std::vector<bool> verificarDisponibilidadeLote(const std::vector<PedidoVerba>& pedidos) override {
+        falhas.aplicar("FINANCEIRO");
+        if (!estaOperacional) {
+            LOG_AVISO("FINANCEIRO", "Modulo indisponivel");
+            return std::vector<bool>(pedidos.size(), false);
+        }
+
+        LOG_DEPURACAO("FINANCEIRO", "Verificando lote pedidos=" << pedidos.size());
+
+        latencia.esperar("FINANCEIRO", 2000, 4000);
+
+        Dinheiro saldo = getSaldo();
+        std::vector<bool> resultados;
+        resultados.reserve(pedidos.size());
+        for (const auto& p : pedidos) {
+            bool disponivel = (p.valor <= saldo);
+            resultados.push_back(disponivel);
+            if (!disponivel) {
+                LOG_INFO("FINANCEIRO", "Verba INSUFICIENTE idOrdem=" << p.idOrdem << " valor=" << p.valor
+                                       << " saldo=" << saldo);
+            }
+        }
+        LOG_INFO("FINANCEIRO", "Lote verificado pedidos=" << pedidos.size());
+        return resultados;
+    }
+
+    // Concessão de verba (simulada): mesma latência de uma verificação; o valor
+    // concedido sai do saldo na hora, sob o mutex, então concessões simultâneas
+    // nunca somam mais que o saldo.
+    Dinheiro solicitarVerba(Dinheiro valorDesejado) override {
+        falhas.aplicar("FINANCEIRO");
+        if (!estaOperacional) {
+            LOG_AVISO("FINANCEIRO", "Modulo indisponivel");
+            return Dinheiro();
+        }
+
+        latencia.esperar("FINANCEIRO", 2000, 4000);
+
+        Dinheiro concedido;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            concedido = (valorDesejado < saldoDisponivel) ? valorDesejado : saldoDisponivel;
+            if (concedido < Dinheiro()) concedido = Dinheiro();
+            saldoDisponivel -= concedido;
+        }
+        LOG_INFO("FINANCEIRO", "Verba concedida valor=" << concedido << " solicitado=" << valorDesejado);
+        return concedido;
+    }
+
+    void devolverVerba(Dinheiro valor) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        saldoDisponivel += valor;
+    }
+
+    // Autoriza pagamento (simulado): log, espera (padrão 1-2s) e retorna sucesso.
+    // Idempotente por ordem: a autorização é registrada ao ser recebida, e uma
+    // repetição (nova tentativa após prazo excedido) só confirma a que já existe.
     bool autorizarPagamento(int idOrdem) override {
+        falhas.aplicar("FINANCEIRO");
         if (!estaOperacional) {
-            std::cout << "[FINANCEIRO] Modulo indisponivel!\n";
+            LOG_AVISO("FINANCEIRO", "Modulo indisponivel");
             return false;
         }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pagamentosAutorizados.insert(idOrdem).second) {
+                LOG_INFO("FINANCEIRO", "Pagamento ja autorizado, repeticao ignorada idOrdem=" << idOrdem);
+                return true;
+            }
+        }
+
+        LOG_DEPURACAO("FINANCEIRO", "Autorizando pagamento idOrdem=" << idOrdem);
+
+        // Simula processamento (padrão: 1-2 segundos)
+        latencia.esperar("FINANCEIRO", 1000, 2000);
 
-        std::cout << "[FINANCEIRO] Autorizando pagamento para ordem #" 
-                  << idOrdem << "...\n";
-        
-        // Simula processamento (1-2 segundos)
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(1000, 2000); // 1-2 segundos
-        int latencia_ms = dis(gen);
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(latencia_ms));
-
-        std::cout << "[FINANCEIRO] Pagamento AUTORIZADO!\n";
+        LOG_INFO("FINANCEIRO", "Pagamento AUTORIZADO idOrdem=" << idOrdem);
         return true;
     }
 
-    bool registrarContaPagar(int idOrdemCompra, double valorTotal, 
+    bool registrarContaPagar(int idOrdemCompra, Dinheiro valorTotal, 
                             const std::string& fornecedor, 
                             const std::string& dataVencimento) override {
+        falhas.aplicar("FINANCEIRO");
         if (!estaOperacional) {
-            std::cout << "[FINANCEIRO] Modulo indisponivel!\n";
+            LOG_AVISO("FINANCEIRO", "Modulo indisponivel");
             return false;
         }
 
-        contasPagar[idOrdemCompra] = {idOrdemCompra, valorTotal, fornecedor, dataVencimento, false};
+        latencia.esperar("FINANCEIRO", 0, 0);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            contasPagar[idOrdemCompra] = {idOrdemCompra, valorTotal, fornecedor, dataVencimento, false};
+        }
 
-        std::cout << "[FINANCEIRO] Conta a pagar registrada!\n"
-                  << "[FINANCEIRO]    Ordem de Compra: #" << idOrdemCompra << "\n"
-                  << "[FINANCEIRO]    Fornecedor: " << fornecedor << "\n"
-                  << "[FINANCEIRO]    Valor: R$ " << std::fixed << std::setprecision(2) 
-                  << valorTotal << "\n"
-                  << "[FINANCEIRO]    Vencimento: " << dataVencimento << "\n"
-                  << "[FINANCEIRO] Registro concluido com sucesso!\n";
+        LOG_INFO("FINANCEIRO", "Conta a pagar registrada idOrdem=" << idOrdemCompra << " fornecedor=\""
+                               << fornecedor << "\" valor=" << valorTotal << " vencimento=\"" << dataVencimento << "\"");
 
         return true;
     }
 
     std::vector<std::string> listarContasPagar() override {
         std::vector<std::string> lista;
-
-        std::cout << "[FINANCEIRO] Listando contas a pagar:\n";
+        std::lock_guard<std::mutex> lock(mutex);
 
         if (contasPagar.empty()) {
-            std::cout << "[FINANCEIRO] Nenhuma conta a pagar registrada.\n";
             lista.push_back("Nenhuma conta a pagar");
         } else {
             for (const auto& c : contasPagar) {
                 std::ostringstream oss;
                 oss << "Ordem #" << c.second.idOrdemCompra 
                     << " | Fornecedor: " << c.second.fornecedor
-                    << " | Valor: R$ " << std::fixed << std::setprecision(2) << c.second.valorTotal
+                    << " | Valor: R$ " << c.second.valorTotal
                     << " | Venc: " << c.second.dataVencimento
                     << " | Status: " << (c.second.paga ? "PAGA" : "PENDENTE");
                 
                 lista.push_back(oss.str());
-                std::cout << "[FINANCEIRO] " << oss.str() << "\n";
             }
         }
 
         return lista;
     }
 
+    // Autorizações distintas recebidas (repetições da mesma ordem não contam)
+    size_t obterQuantidadeAutorizacoes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pagamentosAutorizados.size();
+    }
+
+    // Injeção de atraso/falha (teste)
+    SimuladorFalhas& getSimuladorFalhas() {
+        return falhas;
+    }
+
+    // Perfil de latência das chamadas (benchmarks e testes de carga)
+    void configurarLatencia(const PerfilLatencia& perfil) {
+        latencia.configurar(perfil);
+    }
+
     // Define se o módulo está operacional (teste)
     void setOperacional(bool estado) {
         estaOperacional = estado;
     }
 
     // Retorna o saldo simulado
-    double getSaldo() const {
+    Dinheiro getSaldo() const {
+        std::lock_guard<std::mutex> lock(mutex);
         return saldoDisponivel;
     }
 };
@@ -3,6 +3,8 @@
 
 #include <string>
 #include "Pessoa.h"
+#include "Dinheiro.h"
+#include "MemoriaEstimada.h"
 
 /*
  * Classe Fornecedor que herda de Pessoa.
@@ -16,20 +18,20 @@ private:
     std::string cnpj;  // CNPJ do fornecedor
     int id;            // ID único do fornecedor no sistema
     std::string produto; // Produto fornecido
-    double precoProduto; // Preço do produto fornecido
+    Dinheiro precoProduto; // Preço do produto fornecido
 
 public:
     // Construtor padrão
-    Fornecedor() : Pessoa(), cnpj(""), id(0), produto(""), precoProduto(0.0) {}
+    Fornecedor() : Pessoa(), cnpj(""), id(0), produto(""), precoProduto() {}
 
     // Construtor parametrizado: recebe nome, endereço, CNPJ, identificador, produto e preço
     Fornecedor(const std::string& n, const std::string& e, 
-               const std::string& c, int identificador, const std::string& prod, double preco)
+               const std::string& c, int identificador, const std::string& prod, Dinheiro preco)
         : Pessoa(n, e), cnpj(c), id(identificador), produto(prod), precoProduto(preco) {}
 
     // Construtor legado usado pela persistencia antiga (sem produto/preco)
     Fornecedor(const std::string& n, const std::string& e, const std::string& c, int identificador)
-        : Pessoa(n, e), cnpj(c), id(identificador), produto(""), precoProduto(0.0) {}
+        : Pessoa(n, e), cnpj(c), id(identificador), produto(""), precoProduto() {}
 
     // Destrutor padrão
     ~Fornecedor() override = default;
@@ -38,13 +40,19 @@ public:
     std::string getCNPJ() const { return cnpj; }
     int getId() const { return id; }
     std::string getProduto() const { return produto; }
-    double getPrecoProduto() const { return precoProduto; }
+    Dinheiro getPrecoProduto() const { return precoProduto; }
 
     // Setters
     void setCNPJ(const std::string& c) { cnpj = c; }
     void setId(int identificador) { id = identificador; }
     void setProduto(const std::string& prod) { produto = prod; }
-    void setPrecoProduto(double preco) { precoProduto = preco; }
+    void setPrecoProduto(Dinheiro preco) { precoProduto = preco; }
+
+    // Bytes dos textos fora do objeto (ver MemoriaEstimada)
+    size_t bytesTexto() const {
+        return MemoriaEstimada::texto(nome) + MemoriaEstimada::texto(endereco) + MemoriaEstimada::texto(cnpj) +
+               MemoriaEstimada::texto(produto);
+    }
 
     // Implementação de exibirDetalhes() que formata e retorna as informações do fornecedor
     std::string exibirDetalhes() const override {
@@ -53,7 +61,7 @@ public:
                "  CNPJ: " + cnpj +
                "  Endereco: " + endereco +
                "  Produto: " + produto +
-               " | Preco: R$ " + std::to_string(precoProduto);
+               " | Preco: R$ " + precoProduto.formatar();
     }
 
     // Compara dois fornecedores pelo ID (útil para buscas e operações)
@@ -1,11 +1,12 @@
 #ifndef GERENCIADOR_FORNECEDORES_H
 #define GERENCIADOR_FORNECEDORES_H
 
-#include <mutex>
 #include <memory>
 #include "Fornecedor.h"
 #include "ListaGenerica.h"
 #include "ComprasException.h"
+#include "MutexInstrumentado.h"
+#include "MemoriaEstimada.h"
 
 /*
  * Gerenciador de fornecedores.
@@ -16,13 +17,13 @@ class GerenciadorFornecedores {
 private:
     ListaGenerica<Fornecedor> fornecedores;
     int proximoId;
-    mutable std::mutex mutex;
+    mutable MutexInstrumentado mutex{"GerenciadorFornecedores::mutex"}; ///< Mede a própria contenção (ver /api/debug/locks)
 
 public:
     GerenciadorFornecedores();
     ~GerenciadorFornecedores();
 
-    int adicionar(const std::string& nome, const std::string& endereco, const std::string& cnpj, const std::string& produto, double precoProduto);
+    int adicionar(const std::string& nome, const std::string& endereco, const std::string& cnpj, const std::string& produto, Dinheiro precoProduto);
 
     // Lista fornecedores de um determinado produto
     void listarPorProduto(const std::string& produto) const;
@@ -30,13 +31,27 @@ public:
     // Lista fornecedores ordenados por preço do produto (maior para menor)
     void listarOrdenadoPorPreco() const;
     void listar() const;
+    // O ponteiro só é seguro enquanto nenhuma outra thread altera a lista (ex: console);
+    // com acesso concorrente, use existe() ou copiarPorId()
     Fornecedor* buscarPorId(int id);
+    bool existe(int id) const;
+    bool copiarPorId(int id, Fornecedor& destino) const;
     void remover(int id);
     size_t obterQuantidade() const;
     
-    // Acesso para persistencia
+    // Acesso para persistencia (a referência não é protegida pelo mutex: ver comLista)
     const ListaGenerica<Fornecedor>& obterLista() const;
+
+    // Executa 'leitura' com o mutex adquirido
+    template <typename F>
+    void comLista(F leitura) const {
+        GuardaMutex lock(mutex);
+        leitura(fornecedores);
+    }
     void carregarDeLista(const ListaGenerica<Fornecedor>& lista, int proximoIdArmazenado);
+
+    // Acrescenta em 'destino' a memória estimada da lista (ver MemoriaEstimada)
+    void medirMemoria(std::vector<UsoMemoria>& destino) const;
 };
 
 #endif // GERENCIADOR_FORNECEDORES_H
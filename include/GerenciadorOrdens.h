@@ -1,15 +1,56 @@
 #ifndef GERENCIADOR_ORDENS_H
 #define GERENCIADOR_ORDENS_H
 
-#include <mutex>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #include "OrdemCompra.h"
 #include "ListaGenerica.h"
+#include "ProjecaoEstoque.h"
+#include "TabelaOrdens.h"
+#include "IndiceTemporal.h"
+#include "ExecutorIntegracao.h"
+#include "AgrupadorVerba.h"
+#include "RazaoOrcamento.h"
+#include "ConfiguracaoCompras.h"
+#include "IntegracoesResilientes.h"
+#include "Temporizador.h"
+#include "CaixaSaida.h"
 #include "ComprasException.h"
+#include "MutexInstrumentado.h"
 #include "FinanceiroMock.h"
 #include "ProducaoMock.h"
 #include "EstoqueMock.h"
-#include <thread>
+
+// Resultado de uma chamada a um módulo integrado (financeiro, produção, estoque)
+struct ResultadoIntegracao {
+    std::string nome;         ///< Identificação da chamada (ex: "estoque.registrarEntradaCompra")
+    bool sucesso = false;
+    std::string erro;         ///< Motivo da falha (vazio em caso de sucesso)
+    double duracaoMs = 0.0;   ///< Duração medida da chamada
+};
+
+// Campo de data usado nas consultas por período
+enum class CampoData {
+    SOLICITACAO,
+    CHEGADA_PREVISTA
+};
+
+// Página de resultado de uma consulta por período
+struct PaginaOrdens {
+    std::vector<OrdemCompra> ordens;
+    bool temMais = false;        ///< Há mais ordens no intervalo após esta página
+    CursorTemporal proximo;      ///< Cursor para pedir a próxima página (válido se temMais)
+};
+
+// Ordem aceita como PENDENTE cujo fluxo de aprovação segue em segundo plano
+struct SubmissaoOrdem {
+    int idOrdem;
+    Futuro<StatusOrdem> conclusao;  ///< Status final (APROVADO ou REJEITADO)
+};
 
 /*
  * Gerenciador de ordens de compra.
@@ -19,29 +60,143 @@
 class GerenciadorOrdens {
 private:
     ListaGenerica<OrdemCompra> ordens;
+    TabelaOrdens tabela;          ///< Cópia colunar das ordens para varreduras analíticas
+    ProjecaoEstoque projecaoEstoque;
+    IndiceTemporal indiceSolicitacao; ///< Ordens por data de solicitação
+    IndiceTemporal indiceChegada;     ///< Ordens por data prevista de chegada (só as que têm data válida)
+    std::unordered_map<int, size_t> linhaPorId; ///< ID da ordem -> posição na lista
     int proximoId;
-    mutable std::mutex mutex;
+    mutable MutexInstrumentado mutex{"GerenciadorOrdens::mutex"}; ///< Mede a própria contenção (ver /api/debug/locks)
     
     std::unique_ptr<FinanceiroMock> modulo_financeiro;
     std::unique_ptr<ProducaoMock> modulo_producao;
     std::unique_ptr<EstoqueMock> modulo_estoque;
+    // Prazos e esperas entre tentativas das chamadas remotas. Destruído depois dos
+    // decoradores e do executor de chamadas remotas (que ainda cancelam prazos nele).
+    std::unique_ptr<Temporizador> temporizador;
+    // Prazo, novas tentativas e disjuntor sobre os módulos acima; todo o fluxo de
+    // aprovação chama os módulos através destes
+    std::unique_ptr<FinanceiroResiliente> financeiro;
+    std::unique_ptr<ProducaoResiliente> producao;
+    std::unique_ptr<EstoqueResiliente> estoque;
+    // Threads que executam as chamadas remotas protegidas (uma chamada que estoura o
+    // prazo é abandonada aqui, sem prender o executor do fluxo). Destruído antes dos
+    // decoradores e dos módulos, depois do executor que o alimenta.
+    std::unique_ptr<ExecutorIntegracao> chamadasRemotas;
+    // Eventos das ordens aprovadas, entregues em segundo plano (o despacho é parado,
+    // e as entregas em curso esperadas, no destrutor).
+    std::unique_ptr<CaixaSaida> caixaSaida;
+    std::unique_ptr<RazaoOrcamento> razaoOrcamento; ///< nullptr fora do modo RAZAO
+    // Declarado após os módulos: é destruído (e termina as tarefas pendentes) antes deles
+    std::unique_ptr<ExecutorIntegracao> executor;
+    std::unique_ptr<AgrupadorVerba> agrupadorVerba; ///< nullptr fora do modo LOTE
+
+    // Ordens cujo fluxo de aprovação ainda não terminou. As etapas do fluxo esperam
+    // respostas remotas sem ocupar threads, então o executor pode ficar ocioso com
+    // ordens em curso: o destrutor espera o conjunto esvaziar.
+    std::mutex mutexEmCurso;
+    std::condition_variable semOrdensEmCurso;
+    std::set<int> ordensEmCurso;   ///< IDs; protegido por mutexEmCurso
+
+    // Resultado das etapas do financeiro (verba + autorização)
+    enum class DecisaoFinanceiro {
+        APROVADA,
+        VERBA_INSUFICIENTE,
+        PAGAMENTO_RECUSADO,
+        FALHA_MODULO
+    };
+
+    // Adiciona a ordem à lista, à tabela colunar e à projeção de estoque (chamar com o mutex adquirido)
+    void registrarOrdem(const OrdemCompra& ordem);
 
-    void threadVerificarVerba(double valor, bool* resultado);
+    // Inicia a entrega de um evento da caixa de saída ao módulo de destino
+    Futuro<bool> entregarEvento(const EventoSaida& evento);
+
+    void encerrarOrdemEmCurso(int idOrdem);
+
+    // Fases 2 e 3 do fluxo de uma ordem já registrada como PENDENTE e em curso:
+    // verba, autorização e efetivação do status
+    Futuro<StatusOrdem> aprovar(int idOrdem, int idItem, int quantidade, Dinheiro valorTotal, int idFornecedor,
+                                std::chrono::steady_clock::time_point inicio);
+
+    // Última etapa do fluxo de aprovação (roda no executor)
+    StatusOrdem finalizarOrdem(int idOrdem, DecisaoFinanceiro decisao, int idItem, int quantidade,
+                               Dinheiro valorTotal, int idFornecedor);
+
+    // Fase final do fluxo de criação: grava o status decidido (adquire o mutex)
+    bool concluirOrdem(int idOrdem, StatusOrdem novoStatus);
 
 public:
-    GerenciadorOrdens();
+    explicit GerenciadorOrdens(const ConfiguracaoCompras& config = ConfiguracaoCompras());
     ~GerenciadorOrdens();
 
-    int criar(int idItem, int quantidade, double valorUnitario, int idFornecedor, const std::string& dataChegada = "");
+    int criar(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor, const std::string& dataChegada = "");
+    SubmissaoOrdem submeter(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor,
+                            const std::string& dataChegada = "");
     void listar() const;
+    // O ponteiro só é seguro enquanto nenhuma outra thread altera a lista (o executor muda
+    // status em segundo plano); com acesso concorrente, use copiarPorId()
     OrdemCompra* buscarPorId(int id);
+    bool copiarPorId(int id, OrdemCompra& destino) const;
     size_t obterQuantidade() const;
     void exibirEstatisticas() const;
+
+    // Estatísticas agregadas calculadas sobre a tabela colunar
+    ResumoOrdens obterResumo() const;
+
+    // Ordens cuja data (solicitação ou chegada prevista) está em [de, ate], paginadas por cursor
+    PaginaOrdens consultarPorPeriodo(CampoData campo, int64_t de, int64_t ate,
+                                     const CursorTemporal* apos, size_t limite) const;
     
-    // Acesso para persistencia
+    // Acesso para persistencia (a referência não é protegida pelo mutex: ver comLista)
     const ListaGenerica<OrdemCompra>& obterLista() const;
-    void carregarDeLista(const ListaGenerica<OrdemCompra>& lista, int proximoIdArmazenado);
+
+    // Executa 'leitura' com o mutex adquirido (leituras concorrentes com o executor)
+    template <typename F>
+    void comLista(F leitura) const {
+        GuardaMutex lock(mutex);
+        leitura(ordens);
+    }
+    // 'ajustesEstoque': entradas/reservas manuais salvas (ver ProjecaoEstoque::obterAjustes)
+    void carregarDeLista(const ListaGenerica<OrdemCompra>& lista, int proximoIdArmazenado,
+                         const std::map<int, int>& ajustesEstoque);
+    // Chamar depois de gravar 'salvas' no arquivo de ordens
+    void confirmarPersistencia(const ListaGenerica<OrdemCompra>& salvas);
+
+    // Projeção de estoque atual (mantida incrementalmente)
+    const ProjecaoEstoque& obterProjecaoEstoque() const;
+    template <typename F>
+    void comProjecaoEstoque(F leitura) const {
+        GuardaMutex lock(mutex);
+        leitura(projecaoEstoque);
+    }
+    void ajustarProjecaoEstoque(int idItem, int delta);
+
+    // Acrescenta em 'destino' a memória estimada da lista e de cada índice derivado dela
+    void medirMemoria(std::vector<UsoMemoria>& destino) const;
+    bool verificarProjecaoEstoque(std::vector<std::string>& divergencias, bool reconstruirSeDivergente);
     
+    // Profundidade de fila e latência das tarefas de integração
+    ExecutorIntegracao::Metricas obterMetricasExecutor() const { return executor->obterMetricas(); }
+    // Lotes enviados ao financeiro (zerado fora do modo LOTE)
+    AgrupadorVerba::Metricas obterMetricasLoteVerba() const {
+        return agrupadorVerba ? agrupadorVerba->obterMetricas() : AgrupadorVerba::Metricas();
+    }
+    // Saldo e reservas da razão local (false fora do modo RAZAO)
+    bool obterMetricasRazao(RazaoOrcamento::Metricas& metricas) const {
+        if (!razaoOrcamento) return false;
+        metricas = razaoOrcamento->obterMetricas();
+        return true;
+    }
+
+    // Eventos pendentes e entregues da caixa de saída
+    CaixaSaida::Metricas obterMetricasCaixaSaida() const { return caixaSaida->obterMetricas(); }
+
+    // Chamadas, falhas e estado do disjuntor de cada módulo integrado
+    std::vector<GuardaIntegracao::Metricas> obterMetricasResiliencia() const {
+        return {financeiro->obterMetricas(), producao->obterMetricas(), estoque->obterMetricas()};
+    }
+
     // Acesso aos modulos
     FinanceiroMock* getModuloFinanceiro() { return modulo_financeiro.get(); }
     ProducaoMock* getModuloProducao() { return modulo_producao.get(); }
@@ -0,0 +1,110 @@
+#ifndef HISTOGRAMA_LATENCIA_H
+#define HISTOGRAMA_LATENCIA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Histograma de latências em nanossegundos no estilo HDR: faixas lineares até
+ * 64 ns e, acima disso, 32 faixas por potência de 2 (erro relativo de no
+ * máximo ~3%), até ~137 s.
+ * Um escritor por vez (thread dona, ou quem detém o lock que o protege): os
+ * contadores são atômicos só para que a leitura concorrente seja segura, e a
+ * escrita não usa operações de leitura-modificação-escrita.
+ */
+class HistogramaLatencia {
+private:
+    static constexpr int BITS_SUBFAIXA = 5;
+    static constexpr int SUBFAIXAS = 1 << BITS_SUBFAIXA;   // 32
+    static constexpr int MAIOR_BIT = 36;                    // valores até 2^37 ns
+
+public:
+    static constexpr int FAIXAS = (MAIOR_BIT - BITS_SUBFAIXA + 2) * SUBFAIXAS;
+
+    struct Resumo {
+        uint64_t contagem = 0;
+        double mediaUs = 0.0;
+        double p50Us = 0.0;
+        double p90Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maximoUs = 0.0;
+    };
+
+    // Soma de vários histogramas (ex: um por thread), para calcular o resumo
+    struct Acumulado {
+        std::vector<uint64_t> contagens = std::vector<uint64_t>(FAIXAS, 0);
+        uint64_t somaNs = 0;
+        uint64_t maximoNs = 0;
+
+        Resumo resumir() const {
+            Resumo r;
+            for (uint64_t c : contagens) r.contagem += c;
+            if (r.contagem == 0) return r;
+            auto percentil = [&](double p) {
+                uint64_t alvo = std::max<uint64_t>(1, static_cast<uint64_t>(p * r.contagem + 0.999999));
+                uint64_t acumulado = 0;
+                for (int f = 0; f < FAIXAS; f++) {
+                    acumulado += contagens[f];
+                    if (acumulado >= alvo) return std::min(limiteSuperior(f), maximoNs) / 1e3;
+                }
+                return maximoNs / 1e3;
+            };
+            r.mediaUs = somaNs / 1e3 / r.contagem;
+            r.p50Us = percentil(0.50);
+            r.p90Us = percentil(0.90);
+            r.p99Us = percentil(0.99);
+            r.p999Us = percentil(0.999);
+            r.maximoUs = maximoNs / 1e3;
+            return r;
+        }
+    };
+
+private:
+    std::atomic<uint64_t> contagens[FAIXAS] = {};
+    std::atomic<uint64_t> somaNs{0};
+    std::atomic<uint64_t> maximoNs{0};
+
+    static void incrementar(std::atomic<uint64_t>& contador, uint64_t valor) {
+        contador.store(contador.load(std::memory_order_relaxed) + valor, std::memory_order_relaxed);
+    }
+
+public:
+    static int faixa(uint64_t ns) {
+        if (ns < 2 * SUBFAIXAS) return static_cast<int>(ns);
+        int bit = 63 - __builtin_clzll(ns);
+        if (bit > MAIOR_BIT) return FAIXAS - 1;
+        int deslocamento = bit - BITS_SUBFAIXA;
+        return (deslocamento + 1) * SUBFAIXAS + static_cast<int>((ns >> deslocamento) - SUBFAIXAS);
+    }
+
+    // Maior valor que cai na faixa (o que o HDR chama de valor equivalente)
+    static uint64_t limiteSuperior(int indice) {
+        if (indice < 2 * SUBFAIXAS) return static_cast<uint64_t>(indice);
+        int deslocamento = indice / SUBFAIXAS - 1;
+        uint64_t base = static_cast<uint64_t>(indice % SUBFAIXAS + SUBFAIXAS);
+        return ((base + 1) << deslocamento) - 1;
+    }
+
+    void registrar(uint64_t ns) {
+        incrementar(contagens[faixa(ns)], 1);
+        incrementar(somaNs, ns);
+        if (ns > maximoNs.load(std::memory_order_relaxed)) maximoNs.store(ns, std::memory_order_relaxed);
+    }
+
+    void somarEm(Acumulado& total) const {
+        for (int f = 0; f < FAIXAS; f++) total.contagens[f] += contagens[f].load(std::memory_order_relaxed);
+        total.somaNs += somaNs.load(std::memory_order_relaxed);
+        total.maximoNs = std::max(total.maximoNs, maximoNs.load(std::memory_order_relaxed));
+    }
+
+    Resumo resumir() const {
+        Acumulado a;
+        somarEm(a);
+        return a.resumir();
+    }
+};
+
+#endif // HISTOGRAMA_LATENCIA_H
@@ -3,6 +3,13 @@
 
 #include <string>
 #include <vector>
+#include "Dinheiro.h"
+
+// Pedido de verificação de verba de uma ordem (verificação em lote)
+struct PedidoVerba {
+    int idOrdem;
+    Dinheiro valor;
+};
 
 // Interface para o módulo financeiro (simulado).
 // Define operações para verificar disponibilidade de verba, autorizar pagamentos
@@ -13,7 +20,23 @@ public:
 
     // Verifica se há verba disponível para uma compra (simulado).
     // Recebe o valor a ser verificado e retorna true se houver orçamento.
-    virtual bool verificarDisponibilidade(double valor) = 0;
+    virtual bool verificarDisponibilidade(Dinheiro valor) = 0;
+
+    // Verifica vários pedidos numa única chamada; o resultado i corresponde ao pedido i.
+    // Implementação padrão (módulos sem suporte a lote): uma chamada por pedido.
+    virtual std::vector<bool> verificarDisponibilidadeLote(const std::vector<PedidoVerba>& pedidos) {
+        std::vector<bool> resultados;
+        resultados.reserve(pedidos.size());
+        for (const auto& p : pedidos) resultados.push_back(verificarDisponibilidade(p.valor));
+        return resultados;
+    }
+
+    // Concede uma fatia de verba para uso local (razão de orçamento), debitando-a do saldo.
+    // Retorna o valor efetivamente concedido (até 'valorDesejado'; zero se não houver saldo).
+    virtual Dinheiro solicitarVerba(Dinheiro valorDesejado) = 0;
+
+    // Devolve ao saldo uma verba concedida e não utilizada.
+    virtual void devolverVerba(Dinheiro valor) = 0;
 
     // Autoriza o pagamento de uma ordem de compra (simulado).
     // Deve ser chamado após verificação de disponibilidade.
@@ -25,7 +48,7 @@ public:
     // fornecedor: nome do fornecedor
     // dataVencimento: data de vencimento do pagamento
     // retorna true se o registro foi bem-sucedido
-    virtual bool registrarContaPagar(int idOrdemCompra, double valorTotal, 
+    virtual bool registrarContaPagar(int idOrdemCompra, Dinheiro valorTotal, 
                                      const std::string& fornecedor, 
                                      const std::string& dataVencimento) = 0;
 
@@ -15,8 +15,9 @@ public:
 
     // Notifica o módulo de produção sobre a compra de um material
     // idMaterial: ID do material comprado
+    // idOrdemCompra: ID da ordem de compra (a notificação é idempotente por ordem)
     // retorna true se a notificação foi processada com sucesso
-    virtual bool notificarMaterialComprado(int idMaterial) = 0;
+    virtual bool notificarMaterialComprado(int idMaterial, int idOrdemCompra) = 0;
 
     // Recebe um pedido de material da produção
     // idMaterial: ID do material solicitado
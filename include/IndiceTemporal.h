@@ -0,0 +1,84 @@
+#ifndef INDICE_TEMPORAL_H
+#define INDICE_TEMPORAL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "MemoriaEstimada.h"
+
+/*
+ * Posição de continuação para consultas paginadas por data.
+ * Identifica a última entrada devolvida (data + ID da ordem).
+ */
+struct CursorTemporal {
+    int64_t epoch = 0;
+    int idOrdem = 0;
+};
+
+/*
+ * Índice ordenado por data (epoch) para consultas de intervalo.
+ * Cada entrada aponta para a linha da ordem na lista do gerenciador.
+ * As consultas usam busca binária; inserções em ordem crescente (caso comum,
+ * pois as ordens chegam em ordem de solicitação) são apenas push_back.
+ * Não é thread-safe: quem o possui deve protegê-lo com o próprio mutex.
+ */
+class IndiceTemporal {
+public:
+    struct Entrada {
+        int64_t epoch;
+        int idOrdem;
+        size_t linha;
+
+        bool operator<(const Entrada& o) const {
+            return epoch < o.epoch || (epoch == o.epoch && idOrdem < o.idOrdem);
+        }
+    };
+
+private:
+    std::vector<Entrada> entradas;
+
+public:
+    void adicionar(int64_t epoch, int idOrdem, size_t linha) {
+        Entrada e{epoch, idOrdem, linha};
+        if (entradas.empty() || !(e < entradas.back())) {
+            entradas.push_back(e);
+        } else {
+            entradas.insert(std::upper_bound(entradas.begin(), entradas.end(), e), e);
+        }
+    }
+
+    void limpar() { entradas.clear(); }
+    void medirMemoria(UsoMemoria& uso) const { MemoriaEstimada::vetor(uso, entradas); }
+
+    // Ordena tudo de uma vez (usado após carregar muitas entradas fora de ordem)
+    void reservar(size_t n) { entradas.reserve(n); }
+    void acrescentarSemOrdenar(int64_t epoch, int idOrdem, size_t linha) { entradas.push_back({epoch, idOrdem, linha}); }
+    void ordenar() { std::stable_sort(entradas.begin(), entradas.end()); }
+
+    size_t tamanho() const { return entradas.size(); }
+
+    // Retorna até 'limite' entradas com epoch em [de, ate], começando após 'apos' (se informado).
+    // 'temMais' indica se existem entradas adicionais no intervalo.
+    std::vector<Entrada> consultar(int64_t de, int64_t ate, const CursorTemporal* apos,
+                                   size_t limite, bool& temMais) const {
+        std::vector<Entrada> resultado;
+        temMais = false;
+        if (de > ate) return resultado;
+
+        auto inicio = std::lower_bound(entradas.begin(), entradas.end(),
+                                       Entrada{de, std::numeric_limits<int>::min(), 0});
+        if (apos) {
+            auto depoisCursor = std::upper_bound(entradas.begin(), entradas.end(),
+                                                 Entrada{apos->epoch, apos->idOrdem, 0});
+            if (depoisCursor > inicio) inicio = depoisCursor;
+        }
+        for (auto it = inicio; it != entradas.end() && it->epoch <= ate; ++it) {
+            if (resultado.size() == limite) { temMais = true; break; }
+            resultado.push_back(*it);
+        }
+        return resultado;
+    }
+};
+
+#endif // INDICE_TEMPORAL_H
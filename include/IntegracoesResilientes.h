@@ -0,0 +1,179 @@
+#ifndef INTEGRACOES_RESILIENTES_H
+#define INTEGRACOES_RESILIENTES_H
+
+#include <string>
+#include <vector>
+#include "IFinanceiro.h"
+#include "IProducao.h"
+#include "IEstoque.h"
+#include "Resiliencia.h"
+
+/*
+ * Decoradores que aplicam GuardaIntegracao (prazo, novas tentativas e disjuntor)
+ * às interfaces dos módulos integrados. O GerenciadorOrdens fala com estes em vez
+ * de falar direto com os módulos.
+ * Só consultas e operações que podem ser repetidas sem efeito duplicado recebem
+ * novas tentativas; as demais têm prazo e disjuntor, mas uma única tentativa.
+ * As variantes ...Assincrona/...Assincrono devolvem um Futuro sem bloquear (usadas
+ * pelo fluxo de aprovação); as da interface esperam o resultado.
+ */
+class FinanceiroResiliente : public IFinanceiro {
+private:
+    IFinanceiro& alvo;
+    GuardaIntegracao guarda;
+
+public:
+    FinanceiroResiliente(IFinanceiro& alvo, const PoliticaResiliencia& politica, ExecutorIntegracao& chamadas,
+                         Temporizador& temporizador)
+        : alvo(alvo), guarda("FINANCEIRO", politica, chamadas, temporizador) {}
+
+    Futuro<bool> verificarDisponibilidadeAssincrona(Dinheiro valor) {
+        return guarda.executarAssincrono("verificarDisponibilidade",
+                                         [this, valor] { return alvo.verificarDisponibilidade(valor); }, true);
+    }
+
+    bool verificarDisponibilidade(Dinheiro valor) override {
+        return verificarDisponibilidadeAssincrona(valor).obter();
+    }
+
+    Futuro<std::vector<bool>> verificarDisponibilidadeLoteAssincrona(const std::vector<PedidoVerba>& pedidos) {
+        return guarda.executarAssincrono("verificarDisponibilidadeLote",
+                                         [this, pedidos] { return alvo.verificarDisponibilidadeLote(pedidos); }, true);
+    }
+
+    std::vector<bool> verificarDisponibilidadeLote(const std::vector<PedidoVerba>& pedidos) override {
+        return verificarDisponibilidadeLoteAssincrona(pedidos).obter();
+    }
+
+    // Debita saldo no financeiro: não é repetida. Se a resposta chegar depois do
+    // prazo, a verba concedida (que ninguém vai usar) é devolvida.
+    Futuro<Dinheiro> solicitarVerbaAssincrona(Dinheiro valorDesejado) {
+        return guarda.executarAssincrono("solicitarVerba",
+                                         [this, valorDesejado] { return alvo.solicitarVerba(valorDesejado); }, false,
+                                         [this](const Dinheiro& concedido) {
+                                             if (concedido > Dinheiro()) alvo.devolverVerba(concedido);
+                                         });
+    }
+
+    Dinheiro solicitarVerba(Dinheiro valorDesejado) override {
+        return solicitarVerbaAssincrona(valorDesejado).obter();
+    }
+
+    // Chamada direta: é a própria compensação, e falhar aqui perderia verba
+    void devolverVerba(Dinheiro valor) override { alvo.devolverVerba(valor); }
+
+    // Idempotente por ordem: o financeiro guarda a autorização de cada idOrdem e
+    // responde a uma repetição sem autorizar de novo
+    Futuro<bool> autorizarPagamentoAssincrono(int idOrdem) {
+        return guarda.executarAssincrono("autorizarPagamento",
+                                         [this, idOrdem] { return alvo.autorizarPagamento(idOrdem); }, idOrdem > 0);
+    }
+
+    bool autorizarPagamento(int idOrdem) override { return autorizarPagamentoAssincrono(idOrdem).obter(); }
+
+    Futuro<bool> registrarContaPagarAssincrono(int idOrdemCompra, Dinheiro valorTotal, const std::string& fornecedor,
+                                               const std::string& dataVencimento) {
+        return guarda.executarAssincrono("registrarContaPagar", [=] {
+            return alvo.registrarContaPagar(idOrdemCompra, valorTotal, fornecedor, dataVencimento);
+        }, true);
+    }
+
+    bool registrarContaPagar(int idOrdemCompra, Dinheiro valorTotal, const std::string& fornecedor,
+                             const std::string& dataVencimento) override {
+        return registrarContaPagarAssincrono(idOrdemCompra, valorTotal, fornecedor, dataVencimento).obter();
+    }
+
+    std::vector<std::string> listarContasPagar() override {
+        return guarda.executar("listarContasPagar", [this] { return alvo.listarContasPagar(); }, true);
+    }
+
+    GuardaIntegracao::Metricas obterMetricas() const { return guarda.obterMetricas(); }
+};
+
+class ProducaoResiliente : public IProducao {
+private:
+    IProducao& alvo;
+    GuardaIntegracao guarda;
+
+public:
+    ProducaoResiliente(IProducao& alvo, const PoliticaResiliencia& politica, ExecutorIntegracao& chamadas,
+                       Temporizador& temporizador)
+        : alvo(alvo), guarda("PRODUCAO", politica, chamadas, temporizador) {}
+
+    Futuro<bool> notificarMaterialCompradoAssincrono(int idMaterial, int idOrdemCompra) {
+        return guarda.executarAssincrono("notificarMaterialComprado", [this, idMaterial, idOrdemCompra] {
+            return alvo.notificarMaterialComprado(idMaterial, idOrdemCompra);
+        }, true);
+    }
+
+    bool notificarMaterialComprado(int idMaterial, int idOrdemCompra) override {
+        return notificarMaterialCompradoAssincrono(idMaterial, idOrdemCompra).obter();
+    }
+
+    int receberPedidoMaterial(int idMaterial, int quantidade, int prioridade) override {
+        return guarda.executar("receberPedidoMaterial", [=] {
+            return alvo.receberPedidoMaterial(idMaterial, quantidade, prioridade);
+        }, false);
+    }
+
+    Futuro<bool> atualizarPrevisaoEntregaAssincrona(int idOrdemCompra, const std::string& dataPrevisao) {
+        return guarda.executarAssincrono("atualizarPrevisaoEntrega", [this, idOrdemCompra, dataPrevisao] {
+            return alvo.atualizarPrevisaoEntrega(idOrdemCompra, dataPrevisao);
+        }, true);
+    }
+
+    bool atualizarPrevisaoEntrega(int idOrdemCompra, const std::string& dataPrevisao) override {
+        return atualizarPrevisaoEntregaAssincrona(idOrdemCompra, dataPrevisao).obter();
+    }
+
+    std::vector<std::string> listarPedidosPendentes() override {
+        return guarda.executar("listarPedidosPendentes", [this] { return alvo.listarPedidosPendentes(); }, true);
+    }
+
+    GuardaIntegracao::Metricas obterMetricas() const { return guarda.obterMetricas(); }
+};
+
+class EstoqueResiliente : public IEstoque {
+private:
+    IEstoque& alvo;
+    GuardaIntegracao guarda;
+
+public:
+    EstoqueResiliente(IEstoque& alvo, const PoliticaResiliencia& politica, ExecutorIntegracao& chamadas,
+                      Temporizador& temporizador)
+        : alvo(alvo), guarda("ESTOQUE", politica, chamadas, temporizador) {}
+
+    // Idempotente por ordem (o estoque ignora a segunda entrada da mesma ordem)
+    Futuro<bool> registrarEntradaCompraAssincrona(int idMaterial, int quantidade, int idOrdemCompra) {
+        return guarda.executarAssincrono("registrarEntradaCompra", [=] {
+            return alvo.registrarEntradaCompra(idMaterial, quantidade, idOrdemCompra);
+        }, idOrdemCompra > 0);
+    }
+
+    bool registrarEntradaCompra(int idMaterial, int quantidade, int idOrdemCompra) override {
+        return registrarEntradaCompraAssincrona(idMaterial, quantidade, idOrdemCompra).obter();
+    }
+
+    int consultarItem(int idMaterial) override {
+        return guarda.executar("consultarItem", [this, idMaterial] { return alvo.consultarItem(idMaterial); }, true);
+    }
+
+    std::vector<std::string> listarTodosItens() override {
+        return guarda.executar("listarTodosItens", [this] { return alvo.listarTodosItens(); }, true);
+    }
+
+    int verificarDisponibilidade(int idMaterial) override {
+        return guarda.executar("verificarDisponibilidade",
+                               [this, idMaterial] { return alvo.verificarDisponibilidade(idMaterial); }, true);
+    }
+
+    bool reservarMaterial(int idMaterial, int quantidade) override {
+        return guarda.executar("reservarMaterial",
+                               [this, idMaterial, quantidade] { return alvo.reservarMaterial(idMaterial, quantidade); },
+                               false);
+    }
+
+    GuardaIntegracao::Metricas obterMetricas() const { return guarda.obterMetricas(); }
+};
+
+#endif // INTEGRACOES_RESILIENTES_H
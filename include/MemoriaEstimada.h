@@ -0,0 +1,90 @@
+#ifndef MEMORIA_ESTIMADA_H
+#define MEMORIA_ESTIMADA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Bytes vivos estimados de uma coleção ou índice, separados por origem.
+ * Um índice é derivado (reconstruível a partir da coleção que indexa).
+ */
+struct UsoMemoria {
+    std::string colecao;          ///< Ex: "ordens", "ordens.linhaPorId"
+    bool indice = false;
+    size_t elementos = 0;
+    size_t bytesElementos = 0;    ///< sizeof dos elementos nos vetores, ou nós alocados (árvores, listas, hash)
+    size_t bytesFolga = 0;        ///< Capacidade reservada e não usada dos vetores
+    size_t bytesTexto = 0;        ///< std::string que não cabem no buffer interno (SSO)
+    size_t bytesEstrutura = 0;    ///< Buckets de hash e arredondamento do alocador nos vetores
+
+    explicit UsoMemoria(std::string colecao = "", bool indice = false) : colecao(std::move(colecao)), indice(indice) {}
+
+    size_t total() const { return bytesElementos + bytesFolga + bytesTexto + bytesEstrutura; }
+
+    double bytesPorElemento() const {
+        return elementos > 0 ? static_cast<double>(total()) / static_cast<double>(elementos) : 0.0;
+    }
+};
+
+/*
+ * Estimativas no layout da libstdc++ e do malloc da glibc: cada alocação ganha
+ * um cabeçalho de 8 bytes e é arredondada para múltiplos de 16 (mínimo 32).
+ * Não adquire locks: quem chama deve proteger a coleção medida. Custo O(n)
+ * quando há textos a percorrer, então é para diagnóstico, não para cada requisição.
+ */
+class MemoriaEstimada {
+private:
+    // Nó de std::map/std::set: cor e três ponteiros antes do valor
+    static constexpr size_t CABECALHO_NO_ARVORE = 4 * sizeof(void*);
+    // Nó de std::list: dois ponteiros antes do valor
+    static constexpr size_t CABECALHO_NO_LISTA = 2 * sizeof(void*);
+
+public:
+    // Bytes que o alocador entrega para um pedido de 'pedido' bytes
+    static size_t alocacao(size_t pedido) {
+        if (pedido == 0) return 0;
+        return std::max<size_t>(32, (pedido + 8 + 15) & ~static_cast<size_t>(15));
+    }
+
+    // Heap de uma string; as curtas (até 15 caracteres na libstdc++) ficam dentro do objeto
+    static size_t texto(const std::string& s) {
+        static const size_t capacidadeInterna = std::string().capacity();
+        return s.capacity() > capacidadeInterna ? alocacao(s.capacity() + 1) : 0;
+    }
+
+    template <typename T>
+    static void vetor(UsoMemoria& uso, const std::vector<T>& v) {
+        uso.elementos += v.size();
+        uso.bytesElementos += v.size() * sizeof(T);
+        uso.bytesFolga += (v.capacity() - v.size()) * sizeof(T);
+        uso.bytesEstrutura += alocacao(v.capacity() * sizeof(T)) - v.capacity() * sizeof(T);
+    }
+
+    // std::map e std::set (os textos dentro dos valores ficam por conta de quem chama)
+    template <typename C>
+    static void arvore(UsoMemoria& uso, const C& c) {
+        uso.elementos += c.size();
+        uso.bytesElementos += c.size() * alocacao(CABECALHO_NO_ARVORE + sizeof(typename C::value_type));
+    }
+
+    template <typename C>
+    static void lista(UsoMemoria& uso, const C& c) {
+        uso.elementos += c.size();
+        uso.bytesElementos += c.size() * alocacao(CABECALHO_NO_LISTA + sizeof(typename C::value_type));
+    }
+
+    // std::unordered_map/set: nó com ponteiro para o próximo e o valor, mais o hash
+    // guardado no nó quando a chave não é inteira; e o vetor de buckets
+    template <typename C>
+    static void hash(UsoMemoria& uso, const C& c) {
+        constexpr size_t hashNoNo = std::is_integral<typename C::key_type>::value ? 0 : sizeof(size_t);
+        uso.elementos += c.size();
+        uso.bytesElementos += c.size() * alocacao(sizeof(void*) + sizeof(typename C::value_type) + hashNoNo);
+        if (c.bucket_count() > 1) uso.bytesEstrutura += alocacao(c.bucket_count() * sizeof(void*));
+    }
+};
+
+#endif // MEMORIA_ESTIMADA_H
@@ -0,0 +1,176 @@
+#ifndef METRICAS_SERVIDOR_H
+#define METRICAS_SERVIDOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/*
+ * Histograma com limites fixos (em segundos) no formato do Prometheus.
+ * Cada faixa é um contador atômico; a exportação acumula as faixas (le="...").
+ */
+class HistogramaPrometheus {
+public:
+    using Relogio = std::chrono::steady_clock;
+
+private:
+    static constexpr int FAIXAS = 16;
+    static constexpr double LIMITES[FAIXAS] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+                                               0.05,   0.1,     0.25,   0.5,   1.0,    2.5,   5.0,  10.0};
+    std::atomic<uint64_t> contagens[FAIXAS + 1] = {};   ///< Última = acima de 10 s (+Inf)
+    std::atomic<uint64_t> somaNs{0};
+    std::atomic<uint64_t> total{0};
+
+public:
+    void observar(std::chrono::nanoseconds duracao) {
+        double segundos = duracao.count() / 1e9;
+        int f = 0;
+        while (f < FAIXAS && segundos > LIMITES[f]) f++;
+        contagens[f].fetch_add(1, std::memory_order_relaxed);
+        somaNs.fetch_add(static_cast<uint64_t>(duracao.count() > 0 ? duracao.count() : 0), std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void observarDesde(Relogio::time_point inicio) {
+        observar(std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - inicio));
+    }
+
+    // Escreve as linhas _bucket/_sum/_count; 'rotulos' vem sem chaves (ex: rota="/x",status="200")
+    void exportar(std::ostream& os, const std::string& nome, const std::string& rotulos) const {
+        std::string prefixo = rotulos.empty() ? "" : rotulos + ",";
+        uint64_t acumulado = 0;
+        for (int f = 0; f <= FAIXAS; f++) {
+            acumulado += contagens[f].load(std::memory_order_relaxed);
+            os << nome << "_bucket{" << prefixo << "le=\"";
+            if (f < FAIXAS) os << LIMITES[f];
+            else os << "+Inf";
+            os << "\"} " << acumulado << "\n";
+        }
+        std::string chaves = rotulos.empty() ? "" : "{" + rotulos + "}";
+        os << nome << "_sum" << chaves << " " << somaNs.load(std::memory_order_relaxed) / 1e9 << "\n";
+        os << nome << "_count" << chaves << " " << total.load(std::memory_order_relaxed) << "\n";
+    }
+};
+
+/*
+ * Contadores operacionais do servidor HTTP, exportados em /metrics.
+ * Tudo é atômico: quem atende requisições só incrementa, e a coleta só lê,
+ * sem g_mutex. As séries por (método, rota, status) são criadas na primeira
+ * ocorrência (lock exclusivo, raro); depois, atender e coletar usam o lock
+ * compartilhado e não esperam um pelo outro.
+ */
+class MetricasServidor {
+public:
+    std::atomic<uint64_t> conexoesAceitas{0};
+    std::atomic<uint64_t> filaAcceptSoma{0};         ///< Soma da fila de accept vista em cada accept (Linux)
+    std::atomic<uint64_t> filaAcceptCheia{0};        ///< Accepts que encontraram a fila no limite do backlog
+    std::atomic<uint64_t> conexoesDescartadas{0};   ///< Falha no accept, na leitura ou no envio
+    std::atomic<uint64_t> bytesRecebidos{0};
+    std::atomic<uint64_t> bytesEnviados{0};
+    HistogramaPrometheus esperaMutex;                ///< Espera por g_mutex
+    HistogramaPrometheus persistenciaModulo;         ///< Gravação de fornecedores e ordens
+    HistogramaPrometheus persistenciaProducao;
+    HistogramaPrometheus persistenciaPrevisto;
+
+private:
+    using ChaveSerie = std::tuple<std::string, std::string, int>;   // método, rota, status
+
+    struct Serie {
+        std::atomic<uint64_t> requisicoes{0};
+        HistogramaPrometheus duracao;
+    };
+
+    mutable std::shared_mutex mutexSeries;
+    std::map<ChaveSerie, std::unique_ptr<Serie>> series;
+
+    static std::string escaparRotulo(const std::string& valor) {
+        std::string out;
+        for (char c : valor) {
+            if (c == '"' || c == '\\') out += '\\';
+            if (c == '\n') { out += "\\n"; continue; }
+            out += c;
+        }
+        return out;
+    }
+
+    static std::string rotulos(const ChaveSerie& chave) {
+        return "metodo=\"" + std::get<0>(chave) + "\",rota=\"" + escaparRotulo(std::get<1>(chave)) +
+               "\",status=\"" + std::to_string(std::get<2>(chave)) + "\"";
+    }
+
+public:
+    // Rotas desconhecidas (404) são agrupadas para não criar uma série por URL
+    void registrarRequisicao(const std::string& metodo, const std::string& rota, int status,
+                             std::chrono::nanoseconds duracao) {
+        ChaveSerie chave(metodo == "GET" || metodo == "POST" || metodo == "OPTIONS" ? metodo : "OUTRO",
+                         status == 404 ? "desconhecida" : rota, status);
+        Serie* serie = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutexSeries);
+            auto it = series.find(chave);
+            if (it != series.end()) serie = it->second.get();
+        }
+        if (!serie) {
+            std::unique_lock<std::shared_mutex> lock(mutexSeries);
+            auto& nova = series[chave];
+            if (!nova) nova = std::make_unique<Serie>();
+            serie = nova.get();
+        }
+        serie->requisicoes.fetch_add(1, std::memory_order_relaxed);
+        serie->duracao.observar(duracao);
+    }
+
+    // Texto no formato de exposição do Prometheus (versão 0.0.4)
+    std::string exportar() const {
+        std::ostringstream os;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutexSeries);
+            os << "# HELP compras_http_requisicoes_total Requisicoes atendidas por metodo, rota e status.\n"
+               << "# TYPE compras_http_requisicoes_total counter\n";
+            for (const auto& s : series) {
+                os << "compras_http_requisicoes_total{" << rotulos(s.first) << "} "
+                   << s.second->requisicoes.load(std::memory_order_relaxed) << "\n";
+            }
+            os << "# HELP compras_http_duracao_segundos Tempo entre o accept e o fim do envio da resposta.\n"
+               << "# TYPE compras_http_duracao_segundos histogram\n";
+            for (const auto& s : series) s.second->duracao.exportar(os, "compras_http_duracao_segundos", rotulos(s.first));
+        }
+        os << "# HELP compras_http_conexoes_aceitas_total Conexoes aceitas.\n"
+           << "# TYPE compras_http_conexoes_aceitas_total counter\n"
+           << "compras_http_conexoes_aceitas_total " << conexoesAceitas.load() << "\n"
+           << "# HELP compras_http_fila_accept_amostras_soma Soma das conexoes que ainda aguardavam a cada accept.\n"
+           << "# TYPE compras_http_fila_accept_amostras_soma counter\n"
+           << "compras_http_fila_accept_amostras_soma " << filaAcceptSoma.load() << "\n"
+           << "# HELP compras_http_fila_accept_cheia_total Accepts feitos com a fila de accept no limite do backlog.\n"
+           << "# TYPE compras_http_fila_accept_cheia_total counter\n"
+           << "compras_http_fila_accept_cheia_total " << filaAcceptCheia.load() << "\n"
+           << "# HELP compras_http_conexoes_descartadas_total Conexoes encerradas sem resposta (accept, leitura ou envio).\n"
+           << "# TYPE compras_http_conexoes_descartadas_total counter\n"
+           << "compras_http_conexoes_descartadas_total " << conexoesDescartadas.load() << "\n"
+           << "# HELP compras_http_bytes_recebidos_total Bytes lidos das conexoes.\n"
+           << "# TYPE compras_http_bytes_recebidos_total counter\n"
+           << "compras_http_bytes_recebidos_total " << bytesRecebidos.load() << "\n"
+           << "# HELP compras_http_bytes_enviados_total Bytes de resposta enviados.\n"
+           << "# TYPE compras_http_bytes_enviados_total counter\n"
+           << "compras_http_bytes_enviados_total " << bytesEnviados.load() << "\n"
+           << "# HELP compras_mutex_global_espera_segundos Espera pelo mutex global do servidor.\n"
+           << "# TYPE compras_mutex_global_espera_segundos histogram\n";
+        esperaMutex.exportar(os, "compras_mutex_global_espera_segundos", "");
+        os << "# HELP compras_persistencia_segundos Duracao das gravacoes em disco por arquivo.\n"
+           << "# TYPE compras_persistencia_segundos histogram\n";
+        persistenciaModulo.exportar(os, "compras_persistencia_segundos", "alvo=\"fornecedores_ordens\"");
+        persistenciaProducao.exportar(os, "compras_persistencia_segundos", "alvo=\"producao\"");
+        persistenciaPrevisto.exportar(os, "compras_persistencia_segundos", "alvo=\"estoque_previsto\"");
+        return os.str();
+    }
+};
+
+#endif // METRICAS_SERVIDOR_H
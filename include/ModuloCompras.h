@@ -8,6 +8,7 @@
 #include "GerenciadorOrdens.h"
 #include "PersistenciaCompras.h"
 #include "ComprasException.h"
+#include "RegistroLog.h"
 
 /*
  * Classe coordenadora do módulo de compras.
@@ -19,10 +20,12 @@ private:
     std::unique_ptr<GerenciadorFornecedores> gerenciadorFornecedores;
     std::unique_ptr<GerenciadorOrdens> gerenciadorOrdens;
     std::unique_ptr<PersistenciaCompras> persistencia;
+    // Serializa salvar/carregar: os arquivos são compartilhados e escritos por inteiro
+    mutable MutexInstrumentado mutexPersistencia{"ModuloCompras::persistencia"};
 
 public:
-    // Construtor: inicializa os módulos internos
-    ModuloCompras();
+    // Construtor: inicializa os módulos internos com a configuração de execução
+    explicit ModuloCompras(const ConfiguracaoCompras& config = ConfiguracaoCompras());
 
     // Destrutor: libera recursos
     ~ModuloCompras();
@@ -30,7 +33,7 @@ public:
     // ========== OPERACOES COM FORNECEDORES ==========
 
     int adicionarFornecedor(const std::string& nome, const std::string& endereco,
-                           const std::string& cnpj, const std::string& produto, double precoProduto) {
+                           const std::string& cnpj, const std::string& produto, Dinheiro precoProduto) {
         return gerenciadorFornecedores->adicionar(nome, endereco, cnpj, produto, precoProduto);
     }
 
@@ -50,6 +53,14 @@ public:
         return gerenciadorFornecedores->buscarPorId(id);
     }
 
+    bool fornecedorExiste(int id) const {
+        return gerenciadorFornecedores->existe(id);
+    }
+
+    bool copiarFornecedorPorId(int id, Fornecedor& destino) const {
+        return gerenciadorFornecedores->copiarPorId(id, destino);
+    }
+
     void removerFornecedor(int id) {
         gerenciadorFornecedores->remover(id);
     }
@@ -60,13 +71,22 @@ public:
 
     // ========== OPERACOES COM ORDENS DE COMPRA ==========
 
-    int criarOrdemCompra(int idItem, int quantidade, double valorUnitario, int idFornecedor, const std::string& dataChegada = "") {
-        if (buscarFornecedorPorId(idFornecedor) == nullptr) {
+    int criarOrdemCompra(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor, const std::string& dataChegada = "") {
+        if (!fornecedorExiste(idFornecedor)) {
             throw ComprasException("Fornecedor nao encontrado!");
         }
         return gerenciadorOrdens->criar(idItem, quantidade, valorUnitario, idFornecedor, dataChegada);
     }
 
+    // Aceita a ordem como PENDENTE e devolve sem esperar a aprovação
+    SubmissaoOrdem submeterOrdemCompra(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor,
+                                       const std::string& dataChegada = "") {
+        if (!fornecedorExiste(idFornecedor)) {
+            throw ComprasException("Fornecedor nao encontrado!");
+        }
+        return gerenciadorOrdens->submeter(idItem, quantidade, valorUnitario, idFornecedor, dataChegada);
+    }
+
     void listarOrdens() const {
         gerenciadorOrdens->listar();
     }
@@ -75,10 +95,31 @@ public:
         return gerenciadorOrdens->buscarPorId(id);
     }
 
+    bool copiarOrdemPorId(int id, OrdemCompra& destino) const {
+        return gerenciadorOrdens->copiarPorId(id, destino);
+    }
+
+    PaginaOrdens consultarOrdensPorPeriodo(CampoData campo, int64_t de, int64_t ate,
+                                           const CursorTemporal* apos, size_t limite) const {
+        return gerenciadorOrdens->consultarPorPeriodo(campo, de, ate, apos, limite);
+    }
+
     size_t obterQuantidadeOrdens() const {
         return gerenciadorOrdens->obterQuantidade();
     }
 
+    ResumoOrdens obterResumoOrdens() const {
+        return gerenciadorOrdens->obterResumo();
+    }
+
+    // Memória estimada por coleção e por índice (ver MemoriaEstimada)
+    std::vector<UsoMemoria> medirMemoria() const {
+        std::vector<UsoMemoria> usos;
+        gerenciadorFornecedores->medirMemoria(usos);
+        gerenciadorOrdens->medirMemoria(usos);
+        return usos;
+    }
+
     void exibirEstatisticas() const {
         std::cout << "\nTotal de Fornecedores: " << obterQuantidadeFornecedores() << "\n";
         std::cout << "Total de Ordens: " << obterQuantidadeOrdens() << "\n";
@@ -88,9 +129,18 @@ public:
     // ========== PERSISTENCIA DE DADOS ==========
 
     void salvarTodosDados() {
-        persistencia->salvarFornecedores(gerenciadorFornecedores->obterLista());
-        persistencia->salvarOrdens(gerenciadorOrdens->obterLista());
-        std::cout << "Dados salvos com sucesso!\n";
+        GuardaMutex lock(mutexPersistencia);
+        gerenciadorFornecedores->comLista([this](const ListaGenerica<Fornecedor>& fornecedores) {
+            persistencia->salvarFornecedores(fornecedores);
+        });
+        gerenciadorOrdens->comLista([this](const ListaGenerica<OrdemCompra>& ordens) {
+            persistencia->salvarOrdens(ordens);
+            gerenciadorOrdens->confirmarPersistencia(ordens);
+        });
+        gerenciadorOrdens->comProjecaoEstoque([this](const ProjecaoEstoque& projecao) {
+            persistencia->salvarAjustesEstoque(projecao.obterAjustes());
+        });
+        LOG_INFO("COMPRAS", "Dados salvos com sucesso");
     }
 
     void carregarTodosDados();
@@ -109,6 +159,26 @@ public:
         return gerenciadorOrdens->getModuloEstoque();
     }
 
+    ExecutorIntegracao::Metricas obterMetricasExecutor() const {
+        return gerenciadorOrdens->obterMetricasExecutor();
+    }
+
+    AgrupadorVerba::Metricas obterMetricasLoteVerba() const {
+        return gerenciadorOrdens->obterMetricasLoteVerba();
+    }
+
+    bool obterMetricasRazao(RazaoOrcamento::Metricas& metricas) const {
+        return gerenciadorOrdens->obterMetricasRazao(metricas);
+    }
+
+    CaixaSaida::Metricas obterMetricasCaixaSaida() const {
+        return gerenciadorOrdens->obterMetricasCaixaSaida();
+    }
+
+    std::vector<GuardaIntegracao::Metricas> obterMetricasResiliencia() const {
+        return gerenciadorOrdens->obterMetricasResiliencia();
+    }
+
     // ========== OPERACOES COM ESTOQUE ==========
 
     int consultarEstoque(int idMaterial) {
@@ -132,6 +202,24 @@ public:
         gerenciadorOrdens->getModuloEstoque()->exibirInventario();
     }
 
+    // Projeção do estoque atual derivada das ordens (servida pela API sem recálculo)
+    const ProjecaoEstoque& obterProjecaoEstoque() const {
+        return gerenciadorOrdens->obterProjecaoEstoque();
+    }
+
+    template <typename F>
+    void comProjecaoEstoque(F leitura) const {
+        gerenciadorOrdens->comProjecaoEstoque(leitura);
+    }
+
+    void ajustarProjecaoEstoque(int idItem, int delta) {
+        gerenciadorOrdens->ajustarProjecaoEstoque(idItem, delta);
+    }
+
+    bool verificarProjecaoEstoque(std::vector<std::string>& divergencias, bool reconstruirSeDivergente = false) {
+        return gerenciadorOrdens->verificarProjecaoEstoque(divergencias, reconstruirSeDivergente);
+    }
+
     // ========== OPERACOES COM PRODUCAO ==========
 
     int criarPedidoMaterial(int idMaterial, int quantidade, int prioridade) {
@@ -158,23 +246,37 @@ public:
         std::cout << "======================\n";
     }
 
-    double consultarSaldoFinanceiro() {
+    Dinheiro consultarSaldoFinanceiro() {
         return gerenciadorOrdens->getModuloFinanceiro()->getSaldo();
     }
 
     // Metodos auxiliares para menu
     auto obterTodasAsOrdens() const {
-        return std::make_unique<ListaGenerica<OrdemCompra>>(gerenciadorOrdens->obterLista());
+        auto copia = std::make_unique<ListaGenerica<OrdemCompra>>();
+        gerenciadorOrdens->comLista([&copia](const ListaGenerica<OrdemCompra>& ordens) { *copia = ordens; });
+        return copia;
     }
 
     const ListaGenerica<OrdemCompra>& obterListaOrdens() const {
         return gerenciadorOrdens->obterLista();
     }
 
+    // Leitura da lista de ordens sob o mutex do gerenciador
+    template <typename F>
+    void comListaOrdens(F leitura) const {
+        gerenciadorOrdens->comLista(leitura);
+    }
+
     const ListaGenerica<Fornecedor>& obterListaFornecedores() const {
         return gerenciadorFornecedores->obterLista();
     }
 
+    // Leitura da lista de fornecedores sob o mutex do gerenciador
+    template <typename F>
+    void comListaFornecedores(F leitura) const {
+        gerenciadorFornecedores->comLista(leitura);
+    }
+
     void exibirTodasAsOrdens() const {
         gerenciadorOrdens->listar();
     }
@@ -0,0 +1,185 @@
+#ifndef MUTEX_INSTRUMENTADO_H
+#define MUTEX_INSTRUMENTADO_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "HistogramaLatencia.h"
+
+/*
+ * std::mutex que mede a própria contenção: número de aquisições (e quantas
+ * encontraram o mutex ocupado), histogramas de espera e de posse, e o ponto
+ * do código que ficou mais tempo com ele. Os contadores são escritos por quem
+ * detém o mutex (um escritor por vez) e lidos sem adquiri-lo.
+ * O ponto de chamada vem de __builtin_FILE/FUNCTION/LINE avaliados em quem
+ * constrói o GuardaMutex (ou chama lock() diretamente).
+ * Cada instância se registra numa lista global lida por resumirTodos().
+ * Custo: duas leituras de relógio a mais por aquisição e duas por liberação.
+ */
+class MutexInstrumentado {
+public:
+    using Relogio = std::chrono::steady_clock;
+
+    struct Resumo {
+        std::string nome;
+        uint64_t aquisicoes = 0;
+        uint64_t contendidas = 0;            ///< Aquisições que encontraram o mutex ocupado
+        HistogramaLatencia::Resumo espera;
+        HistogramaLatencia::Resumo posse;
+        std::string localMaiorPosse;         ///< "arquivo:linha (funcao)"
+        double maiorPosseUs = 0.0;
+    };
+
+private:
+    struct Registro {
+        std::mutex mutex;
+        std::vector<const MutexInstrumentado*> instancias;
+    };
+
+    // Lista global (nunca destruída: mutexes estáticos se removem dela na saída)
+    static Registro& registro() {
+        static Registro* unico = new Registro();
+        return *unico;
+    }
+
+    std::mutex mutex;
+    const char* nome;
+
+    // Posse atual (escritos e lidos só por quem detém o mutex)
+    Relogio::time_point inicioPosse;
+    const char* arquivoAtual = "";
+    const char* funcaoAtual = "";
+    int linhaAtual = 0;
+
+    std::atomic<uint64_t> aquisicoes{0};
+    std::atomic<uint64_t> contendidas{0};
+    HistogramaLatencia espera;
+    HistogramaLatencia posse;
+
+    mutable std::mutex mutexMaior;           ///< Protege o ponto de maior posse (atualizado raramente)
+    std::atomic<uint64_t> maiorPosseNs{0};
+    std::string localMaiorPosse;
+
+    static uint64_t nanos(Relogio::duration d) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return ns > 0 ? static_cast<uint64_t>(ns) : 0;
+    }
+
+    static const char* nomeArquivo(const char* caminho) {
+        const char* barra = std::strrchr(caminho, '/');
+        const char* contraBarra = std::strrchr(caminho, '\\');
+        const char* ultimo = std::max(barra ? barra : caminho, contraBarra ? contraBarra : caminho);
+        return ultimo == caminho ? caminho : ultimo + 1;
+    }
+
+    void adquirido(Relogio::time_point inicio, bool contendida, const char* arquivo, const char* funcao, int linha) {
+        inicioPosse = Relogio::now();
+        arquivoAtual = arquivo;
+        funcaoAtual = funcao;
+        linhaAtual = linha;
+        aquisicoes.store(aquisicoes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (contendida) contendidas.store(contendidas.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        espera.registrar(nanos(inicioPosse - inicio));
+    }
+
+public:
+    explicit MutexInstrumentado(const char* nome) : nome(nome) {
+        Registro& r = registro();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.instancias.push_back(this);
+    }
+
+    ~MutexInstrumentado() {
+        Registro& r = registro();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.instancias.erase(std::remove(r.instancias.begin(), r.instancias.end(), this), r.instancias.end());
+    }
+
+    MutexInstrumentado(const MutexInstrumentado&) = delete;
+    MutexInstrumentado& operator=(const MutexInstrumentado&) = delete;
+
+    void lock(const char* arquivo = __builtin_FILE(), const char* funcao = __builtin_FUNCTION(),
+              int linha = __builtin_LINE()) {
+        Relogio::time_point inicio = Relogio::now();
+        bool contendida = !mutex.try_lock();
+        if (contendida) mutex.lock();
+        adquirido(inicio, contendida, arquivo, funcao, linha);
+    }
+
+    bool try_lock(const char* arquivo = __builtin_FILE(), const char* funcao = __builtin_FUNCTION(),
+                  int linha = __builtin_LINE()) {
+        Relogio::time_point inicio = Relogio::now();
+        if (!mutex.try_lock()) return false;
+        adquirido(inicio, false, arquivo, funcao, linha);
+        return true;
+    }
+
+    void unlock() {
+        uint64_t ns = nanos(Relogio::now() - inicioPosse);
+        posse.registrar(ns);
+        if (ns > maiorPosseNs.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutexMaior);
+            maiorPosseNs.store(ns, std::memory_order_relaxed);
+            localMaiorPosse = std::string(nomeArquivo(arquivoAtual)) + ":" + std::to_string(linhaAtual) +
+                              " (" + funcaoAtual + ")";
+        }
+        mutex.unlock();
+    }
+
+    // Leitura sem adquirir o mutex medido (os números podem estar uma aquisição atrasados)
+    Resumo resumir() const {
+        Resumo r;
+        r.nome = nome;
+        r.aquisicoes = aquisicoes.load(std::memory_order_relaxed);
+        r.contendidas = contendidas.load(std::memory_order_relaxed);
+        r.espera = espera.resumir();
+        r.posse = posse.resumir();
+        std::lock_guard<std::mutex> lock(mutexMaior);
+        r.localMaiorPosse = localMaiorPosse;
+        r.maiorPosseUs = maiorPosseNs.load(std::memory_order_relaxed) / 1e3;
+        return r;
+    }
+
+    // Todos os mutexes instrumentados vivos, do que passou mais tempo ocupado ao que passou menos
+    static std::vector<Resumo> resumirTodos() {
+        std::vector<Resumo> lista;
+        {
+            Registro& reg = registro();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            for (const MutexInstrumentado* m : reg.instancias) lista.push_back(m->resumir());
+        }
+        std::sort(lista.begin(), lista.end(), [](const Resumo& a, const Resumo& b) {
+            return a.posse.mediaUs * a.posse.contagem > b.posse.mediaUs * b.posse.contagem;
+        });
+        return lista;
+    }
+};
+
+/*
+ * Equivalente ao std::lock_guard para MutexInstrumentado, registrando o ponto
+ * de chamada de quem o constrói.
+ * Uso: GuardaMutex lock(mutex);
+ */
+class GuardaMutex {
+private:
+    MutexInstrumentado& mutex;
+
+public:
+    explicit GuardaMutex(MutexInstrumentado& m, const char* arquivo = __builtin_FILE(),
+                         const char* funcao = __builtin_FUNCTION(), int linha = __builtin_LINE())
+        : mutex(m) {
+        mutex.lock(arquivo, funcao, linha);
+    }
+
+    ~GuardaMutex() { mutex.unlock(); }
+
+    GuardaMutex(const GuardaMutex&) = delete;
+    GuardaMutex& operator=(const GuardaMutex&) = delete;
+};
+
+#endif // MUTEX_INSTRUMENTADO_H
@@ -1,11 +1,13 @@
 #ifndef ORDEM_COMPRA_H
 #define ORDEM_COMPRA_H
 
+#include <cstdint>
 #include <string>
-#include <chrono>
-#include <iomanip>
 #include <sstream>
 #include "IExibivel.h"
+#include "Dinheiro.h"
+#include "DataHora.h"
+#include "MemoriaEstimada.h"
 
 /*
  * Enum que representa os possíveis status de uma ordem de compra.
@@ -35,31 +37,30 @@ private:
     int idItem;                    ///< ID do item/material a ser comprado
     int quantidade;                ///< Quantidade a ser comprada
     StatusOrdem status;            ///< Status atual da ordem
-    std::string dataSolicitacao;   ///< Data em que foi solicitada
-    std::string dataChegadaPrevista; ///< Data prevista de chegada
-    double valorUnitario;          ///< Valor unitário do item
+    int64_t dataSolicitacao;       ///< Epoch (segundos) em que foi solicitada; formatada só ao exibir
+    std::string dataChegadaPrevista; ///< Data prevista de chegada (texto informado)
+    int64_t dataChegadaEpoch;      ///< Data prevista interpretada (DataHora::SEM_DATA se texto livre)
+    Dinheiro valorUnitario;        ///< Valor unitário do item (centavos)
     int idFornecedor;              ///< ID do fornecedor
 
 public:
     // Construtor padrão
     OrdemCompra() 
         : idTransacao(0), idItem(0), quantidade(0), 
-          status(StatusOrdem::PENDENTE), dataSolicitacao(""), 
-          dataChegadaPrevista(""), valorUnitario(0.0), idFornecedor(0) {}
+          status(StatusOrdem::PENDENTE), dataSolicitacao(0), 
+          dataChegadaPrevista(""), dataChegadaEpoch(DataHora::SEM_DATA), valorUnitario(), idFornecedor(0) {}
 
-    // Construtor parametrizado: inicializa campos e define a data atual como solicitação
-    OrdemCompra(int idTx, int idI, int qtd, double valorUnit, int idForn, const std::string& dataChegada = "")
+    // Construtor parametrizado: inicializa campos e define o instante atual como solicitação
+    OrdemCompra(int idTx, int idI, int qtd, Dinheiro valorUnit, int idForn, const std::string& dataChegada = "")
+        : OrdemCompra(idTx, idI, qtd, valorUnit, idForn, dataChegada, DataHora::agora()) {}
+
+    // Construtor com a data de solicitação já conhecida (ex: carregada do arquivo)
+    OrdemCompra(int idTx, int idI, int qtd, Dinheiro valorUnit, int idForn,
+                const std::string& dataChegada, int64_t dataSolicitacaoEpoch)
         : idTransacao(idTx), idItem(idI), quantidade(qtd),
-          status(StatusOrdem::PENDENTE), dataChegadaPrevista(dataChegada), valorUnitario(valorUnit),
-          idFornecedor(idForn) {
-        
-        // Define a data atual da solicitação
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        std::ostringstream oss;
-        oss << std::put_time(std::localtime(&time), "%d/%m/%Y %H:%M:%S");
-        dataSolicitacao = oss.str();
-    }
+          status(StatusOrdem::PENDENTE), dataSolicitacao(dataSolicitacaoEpoch),
+          dataChegadaPrevista(dataChegada), dataChegadaEpoch(DataHora::parsearOuSemData(dataChegada)),
+          valorUnitario(valorUnit), idFornecedor(idForn) {}
 
     // Destrutor padrão
     ~OrdemCompra() override = default;
@@ -69,21 +70,34 @@ public:
     int getIdItem() const { return idItem; }
     int getQuantidade() const { return quantidade; }
     StatusOrdem getStatus() const { return status; }
-    std::string getDataSolicitacao() const { return dataSolicitacao; }
+    std::string getDataSolicitacao() const { return DataHora::formatar(dataSolicitacao); }
+    int64_t getDataSolicitacaoEpoch() const { return dataSolicitacao; }
     std::string getDataChegadaPrevista() const { return dataChegadaPrevista; }
-    double getValorUnitario() const { return valorUnitario; }
+    int64_t getDataChegadaPrevistaEpoch() const { return dataChegadaEpoch; }
+    // Bytes do texto da data fora do objeto (ver MemoriaEstimada)
+    size_t bytesTexto() const { return MemoriaEstimada::texto(dataChegadaPrevista); }
+    Dinheiro getValorUnitario() const { return valorUnitario; }
     int getIdFornecedor() const { return idFornecedor; }
     
-    double getValorTotal() const {
+    // Valor total exato (lança ComprasException em caso de estouro)
+    Dinheiro getValorTotal() const {
         return valorUnitario * quantidade;
     }
 
     // ========== SETTERS ==========
     void setStatus(StatusOrdem novoStatus) { status = novoStatus; }
     void setQuantidade(int qtd) { quantidade = qtd; }
-    void setValorUnitario(double valor) { valorUnitario = valor; }
-    void setDataSolicitacao(const std::string& data) { dataSolicitacao = data; }
-    void setDataChegadaPrevista(const std::string& data) { dataChegadaPrevista = data; }
+    void setValorUnitario(Dinheiro valor) { valorUnitario = valor; }
+    void setDataSolicitacaoEpoch(int64_t epoch) { dataSolicitacao = epoch; }
+    // Aceita os formatos de DataHora::parsear; textos inválidos são ignorados
+    void setDataSolicitacao(const std::string& data) {
+        int64_t epoch;
+        if (DataHora::parsear(data, epoch)) dataSolicitacao = epoch;
+    }
+    void setDataChegadaPrevista(const std::string& data) {
+        dataChegadaPrevista = data;
+        dataChegadaEpoch = DataHora::parsearOuSemData(data);
+    }
 
     // Retorna o status como string para exibição
     std::string getStatusString() const {
@@ -106,8 +120,6 @@ public:
     // Implementação de exibirDetalhes() que formata e retorna as informações da ordem
     std::string exibirDetalhes() const override {
         std::ostringstream oss;
-        oss << std::fixed << std::setprecision(2);
-        
         oss << "Ordem de Compra \n"
             << " ID Transacao: " << idTransacao << "\n"
             << " ID Item: " << idItem << "\n"
@@ -116,7 +128,7 @@ public:
             << " Valor Total: R$ " << getValorTotal() << "\n"
             << " Status: " << getStatusString() << "\n"
             << " Fornecedor ID: " << idFornecedor << "\n"
-            << " Data Solicitacao: " << dataSolicitacao << "\n"
+            << " Data Solicitacao: " << getDataSolicitacao() << "\n"
             << " Data Prevista de Chegada: " << (dataChegadaPrevista.empty() ? "Nao informada" : dataChegadaPrevista) << "\n";
 
         
@@ -0,0 +1,112 @@
+#ifndef PERFIL_LATENCIA_H
+#define PERFIL_LATENCIA_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include "ComprasException.h"
+
+// Como os módulos simulados escolhem a latência de cada chamada
+enum class TipoLatencia {
+    PADRAO,    ///< Faixas originais de cada operação (ex: 2-4 s na verificação de verba)
+    ZERO,      ///< Sem espera: mede só o código do módulo de compras
+    FIXA,      ///< Sempre 'fixaMs'
+    LOGNORMAL  ///< Distribuição log-normal ajustada a 'p50Ms' e 'p99Ms'
+};
+
+// Perfil de latência e falhas dos módulos simulados (ver ConfiguracaoCompras)
+struct PerfilLatencia {
+    TipoLatencia tipo = TipoLatencia::PADRAO;
+    unsigned fixaMs = 0;
+    unsigned p50Ms = 200;
+    unsigned p99Ms = 2000;
+    double taxaFalha = 0.0;   ///< Fração das chamadas que lançam exceção (0 a 1)
+    uint64_t semente = 42;    ///< Mesma semente e mesma ordem de chamadas = mesmas latências
+
+    // Lança ComprasException se o perfil não puder ser amostrado
+    // (a log-normal precisa de p50 > 0 e p99 >= p50)
+    void validar() const {
+        if (taxaFalha < 0.0 || taxaFalha > 1.0) {
+            throw ComprasException("Perfil de latencia: taxa de falha deve estar entre 0 e 1");
+        }
+        if (tipo == TipoLatencia::LOGNORMAL && p50Ms == 0) {
+            throw ComprasException("Perfil de latencia: p50 deve ser maior que zero na distribuicao log-normal");
+        }
+        if (p99Ms < p50Ms) {
+            throw ComprasException("Perfil de latencia: p99 deve ser maior ou igual ao p50");
+        }
+    }
+};
+
+/*
+ * Gerador de latências de um módulo simulado, a partir de um PerfilLatencia.
+ * Um único gerador com semente fixa por módulo (sob mutex) substitui o
+ * random_device + mt19937 criados a cada chamada: duas execuções com a mesma
+ * semente e a mesma sequência de chamadas dormem exatamente os mesmos tempos.
+ * Com chamadas concorrentes a sequência continua fixa; só a atribuição de cada
+ * amostra a uma chamada depende da ordem de chegada.
+ */
+class ModeloLatencia {
+private:
+    mutable std::mutex mutex;
+    PerfilLatencia perfil;
+    std::mt19937_64 gerador;
+    uint64_t deslocamento;   ///< Diferencia os módulos que usam a mesma semente
+
+public:
+    explicit ModeloLatencia(uint64_t deslocamento) : gerador(PerfilLatencia().semente + deslocamento),
+                                                     deslocamento(deslocamento) {}
+
+    // Lança ComprasException (sem alterar o perfil atual) se 'novo' for inválido
+    void configurar(const PerfilLatencia& novo) {
+        novo.validar();
+        std::lock_guard<std::mutex> lock(mutex);
+        perfil = novo;
+        gerador.seed(novo.semente + deslocamento);
+    }
+
+    PerfilLatencia obterPerfil() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return perfil;
+    }
+
+    // Sorteia a latência de uma chamada cuja faixa original é [minPadraoMs, maxPadraoMs]
+    // e se ela deve falhar. Não dorme (quem chama decide quando esperar).
+    int amostrar(int minPadraoMs, int maxPadraoMs, bool& falhar) {
+        std::lock_guard<std::mutex> lock(mutex);
+        falhar = perfil.taxaFalha > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(gerador) < perfil.taxaFalha;
+        switch (perfil.tipo) {
+            case TipoLatencia::ZERO:
+                return 0;
+            case TipoLatencia::FIXA:
+                return static_cast<int>(perfil.fixaMs);
+            case TipoLatencia::LOGNORMAL: {
+                // Sem cauda (p99 == p50) o sigma seria 0, que a distribuição não aceita: latência fixa
+                if (perfil.p99Ms <= perfil.p50Ms) return static_cast<int>(perfil.p50Ms);
+                // p99 = p50 * exp(2.326 * sigma)
+                double mu = std::log(static_cast<double>(perfil.p50Ms));
+                double sigma = std::log(static_cast<double>(perfil.p99Ms) / perfil.p50Ms) / 2.326348;
+                return static_cast<int>(std::lognormal_distribution<double>(mu, sigma)(gerador));
+            }
+            case TipoLatencia::PADRAO:
+            default:
+                if (maxPadraoMs <= minPadraoMs) return minPadraoMs;
+                return std::uniform_int_distribution<int>(minPadraoMs, maxPadraoMs)(gerador);
+        }
+    }
+
+    // Dorme a latência sorteada e, se sorteada uma falha, lança ComprasException
+    int esperar(const char* modulo, int minPadraoMs, int maxPadraoMs) {
+        bool falhar = false;
+        int latenciaMs = amostrar(minPadraoMs, maxPadraoMs, falhar);
+        if (latenciaMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(latenciaMs));
+        if (falhar) throw ComprasException(std::string(modulo) + ": falha sorteada pelo perfil de latencia");
+        return latenciaMs;
+    }
+};
+
+#endif // PERFIL_LATENCIA_H
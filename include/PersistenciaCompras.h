@@ -1,6 +1,7 @@
 #ifndef PERSISTENCIA_COMPRAS_H
 #define PERSISTENCIA_COMPRAS_H
 
+#include <map>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -12,17 +13,19 @@
 
 /*
  * Gerenciador de persistência de dados.
- * Responsável por carregar e salvar fornecedores e ordens em arquivos
- * no formato pipe-delimitado.
+ * Responsável por carregar e salvar fornecedores, ordens e os ajustes manuais
+ * da projeção de estoque em arquivos no formato pipe-delimitado.
  */
 class PersistenciaCompras {
 private:
     std::string caminhoFornecedores;
     std::string caminhoOrdens;
+    std::string caminhoAjustes;
 
 public:
     PersistenciaCompras(const std::string& caminhoForn = "data/fornecedores.txt",
-                       const std::string& caminhoOrd = "data/ordens.txt");
+                       const std::string& caminhoOrd = "data/ordens.txt",
+                       const std::string& caminhoAjust = "data/ajustes_estoque.txt");
 
     // Fornecedores
     void salvarFornecedores(const ListaGenerica<Fornecedor>& lista);
@@ -31,6 +34,10 @@ public:
     // Ordens
     void salvarOrdens(const ListaGenerica<OrdemCompra>& lista);
     void carregarOrdens(ListaGenerica<OrdemCompra>& lista, int& proximoId);
+
+    // Ajustes manuais da projeção de estoque (idItem -> soma das entradas/reservas)
+    void salvarAjustesEstoque(const std::map<int, int>& ajustes);
+    void carregarAjustesEstoque(std::map<int, int>& ajustes);
 };
 
 #endif // PERSISTENCIA_COMPRAS_H
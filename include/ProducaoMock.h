@@ -2,15 +2,21 @@
 #define PRODUCAO_MOCK_H
 
 #include "IProducao.h"
-#include <iostream>
+#include "SimuladorFalhas.h"
+#include "PerfilLatencia.h"
+#include "RegistroLog.h"
 #include <iomanip>
 #include <vector>
 #include <map>
+#include <set>
 #include <sstream>
+#include <mutex>
+#include <atomic>
 
 /*
  * Implementação mock do módulo de produção.
  * Simula notificações, pedidos de materiais e previsões de entrega.
+ * Thread-safe: o estado interno é protegido por mutex.
  */
 class ProducaoMock : public IProducao {
 private:
@@ -22,10 +28,14 @@ private:
     };
     
     int notificacoesEnviadas;  ///< Contador de notificações enviadas
-    bool estaOperacional;      ///< Se o módulo está operacional
+    std::atomic<bool> estaOperacional; ///< Se o módulo está operacional
     int proximoIdPedido;       ///< Próximo ID de pedido
     std::map<int, PedidoMaterial> pedidos; ///< Mapa de pedidos
     std::map<int, std::string> previsoesEntrega; ///< Ordem -> Data previsão
+    std::set<int> ordensNotificadas; ///< Ordens cuja compra já foi notificada
+    mutable std::mutex mutex;  ///< Protege pedidos, previsões e contador
+    SimuladorFalhas falhas;    ///< Atraso/falha injetados (testes de resiliência)
+    ModeloLatencia latencia{2}; ///< Latência simulada de cada chamada (ver PerfilLatencia)
 
 public:
     // Construtor: inicializa contador e estado operacional
@@ -37,24 +47,29 @@ public:
     }
 
     // Notifica o módulo de produção sobre material comprado (simulado)
-    bool notificarMaterialComprado(int idMaterial) override {
+    bool notificarMaterialComprado(int idMaterial, int idOrdemCompra) override {
+        falhas.aplicar("PRODUCAO");
+        latencia.esperar("PRODUCAO", 0, 0);
         if (!estaOperacional) {
-            std::cout << "[PRODUCAO] Modulo indisponivel!\n";
+            LOG_AVISO("PRODUCAO", "Modulo indisponivel");
             return false;
         }
 
+        std::lock_guard<std::mutex> lock(mutex);
+        // Idempotente por ordem: a entrega de eventos pode repetir a mesma notificação
+        if (idOrdemCompra > 0 && !ordensNotificadas.insert(idOrdemCompra).second) {
+            LOG_INFO("PRODUCAO", "Notificacao ja recebida, ignorada idOrdem=" << idOrdemCompra);
+            return true;
+        }
         notificacoesEnviadas++;
 
-        std::cout << "[PRODUCAO] Notificacao enviada!\n"
-                  << "[PRODUCAO]    Material ID: " << idMaterial << "\n"
-                  << "[PRODUCAO]    Preparando linha de producao...\n"
-                  << "[PRODUCAO] Notificacao recebida com sucesso!\n";
+        LOG_INFO("PRODUCAO", "Material comprado notificado idMaterial=" << idMaterial << " idOrdem=" << idOrdemCompra);
 
         // Marca pedidos relacionados como atendidos
         for (auto& p : pedidos) {
             if (p.second.idMaterial == idMaterial && !p.second.atendido) {
                 p.second.atendido = true;
-                std::cout << "[PRODUCAO] Pedido #" << p.first << " marcado como atendido.\n";
+                LOG_INFO("PRODUCAO", "Pedido atendido idPedido=" << p.first);
             }
         }
 
@@ -62,46 +77,46 @@ public:
     }
 
     int receberPedidoMaterial(int idMaterial, int quantidade, int prioridade) override {
+        falhas.aplicar("PRODUCAO");
+        latencia.esperar("PRODUCAO", 0, 0);
         if (!estaOperacional) {
-            std::cout << "[PRODUCAO] Modulo indisponivel!\n";
+            LOG_AVISO("PRODUCAO", "Modulo indisponivel");
             return -1;
         }
 
+        std::lock_guard<std::mutex> lock(mutex);
         int idPedido = proximoIdPedido++;
         pedidos[idPedido] = {idMaterial, quantidade, prioridade, false};
 
         std::string nivelPrioridade = (prioridade == 3) ? "ALTA" : 
                                       (prioridade == 2) ? "MEDIA" : "BAIXA";
 
-        std::cout << "[PRODUCAO] Pedido de material recebido!\n"
-                  << "[PRODUCAO]    Pedido ID: #" << idPedido << "\n"
-                  << "[PRODUCAO]    Material ID: " << idMaterial << "\n"
-                  << "[PRODUCAO]    Quantidade: " << quantidade << "\n"
-                  << "[PRODUCAO]    Prioridade: " << nivelPrioridade << "\n";
+        LOG_INFO("PRODUCAO", "Pedido de material recebido idPedido=" << idPedido << " idMaterial=" << idMaterial
+                             << " quantidade=" << quantidade << " prioridade=" << nivelPrioridade);
 
         return idPedido;
     }
 
     bool atualizarPrevisaoEntrega(int idOrdemCompra, const std::string& dataPrevisao) override {
+        falhas.aplicar("PRODUCAO");
+        latencia.esperar("PRODUCAO", 0, 0);
         if (!estaOperacional) {
-            std::cout << "[PRODUCAO] Modulo indisponivel!\n";
+            LOG_AVISO("PRODUCAO", "Modulo indisponivel");
             return false;
         }
 
+        std::lock_guard<std::mutex> lock(mutex);
         previsoesEntrega[idOrdemCompra] = dataPrevisao;
 
-        std::cout << "[PRODUCAO] Previsao de entrega atualizada!\n"
-                  << "[PRODUCAO]    Ordem de Compra: #" << idOrdemCompra << "\n"
-                  << "[PRODUCAO]    Data Prevista: " << dataPrevisao << "\n"
-                  << "[PRODUCAO] Linha de producao informada com sucesso!\n";
+        LOG_INFO("PRODUCAO", "Previsao de entrega atualizada idOrdem=" << idOrdemCompra << " previsao=\""
+                             << dataPrevisao << "\"");
 
         return true;
     }
 
     std::vector<std::string> listarPedidosPendentes() override {
         std::vector<std::string> lista;
-
-        std::cout << "[PRODUCAO] Listando pedidos pendentes:\n";
+        std::lock_guard<std::mutex> lock(mutex);
 
         bool temPendentes = false;
         for (const auto& p : pedidos) {
@@ -116,18 +131,26 @@ public:
                     << " | Prioridade: " << nivelPrioridade;
                 
                 lista.push_back(oss.str());
-                std::cout << "[PRODUCAO] " << oss.str() << "\n";
             }
         }
 
         if (!temPendentes) {
-            std::cout << "[PRODUCAO] Nenhum pedido pendente.\n";
             lista.push_back("Nenhum pedido pendente");
         }
 
         return lista;
     }
 
+    // Injeção de atraso/falha (teste)
+    SimuladorFalhas& getSimuladorFalhas() {
+        return falhas;
+    }
+
+    // Perfil de latência das chamadas (benchmarks e testes de carga)
+    void configurarLatencia(const PerfilLatencia& perfil) {
+        latencia.configurar(perfil);
+    }
+
     // Define se o módulo está operacional (teste)
     void setOperacional(bool estado) {
         estaOperacional = estado;
@@ -135,11 +158,13 @@ public:
 
     // Retorna o número de notificações enviadas
     int getNotificacoesEnviadas() const {
+        std::lock_guard<std::mutex> lock(mutex);
         return notificacoesEnviadas;
     }
 
     // Reseta o contador de notificações
     void resetarContador() {
+        std::lock_guard<std::mutex> lock(mutex);
         notificacoesEnviadas = 0;
     }
 };
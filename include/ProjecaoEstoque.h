@@ -0,0 +1,116 @@
+#ifndef PROJECAO_ESTOQUE_H
+#define PROJECAO_ESTOQUE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "OrdemCompra.h"
+#include "ListaGenerica.h"
+#include "MemoriaEstimada.h"
+
+/*
+ * Projeção materializada do estoque atual por item.
+ * Mantida de forma incremental pelo GerenciadorOrdens (criação e rejeição de ordens)
+ * e pelos ajustes manuais de entrada/reserva, evitando recalcular tudo a cada consulta.
+ * Os ajustes não são deriváveis das ordens: são salvos junto com elas (obterAjustes)
+ * e devolvidos ao reiniciar.
+ * Não é thread-safe: quem a possui deve protegê-la com o próprio mutex.
+ */
+class ProjecaoEstoque {
+private:
+    std::map<int, int> totalPorItem;   ///< idItem -> quantidade projetada (servida diretamente)
+    std::map<int, int> ajustesPorItem; ///< idItem -> soma das entradas/reservas manuais
+    unsigned long versao;              ///< Incrementada a cada alteração (usada para cache)
+
+    // Uma ordem conta no estoque projetado enquanto não estiver rejeitada
+    static bool contaNoEstoque(StatusOrdem status) {
+        return status != StatusOrdem::REJEITADO;
+    }
+
+    // Calcula a projeção esperada a partir das ordens e dos ajustes registrados
+    std::map<int, int> calcular(const ListaGenerica<OrdemCompra>& ordens) const {
+        std::map<int, int> esperado;
+        for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+            const auto& o = ordens.obter(i);
+            if (contaNoEstoque(o.getStatus())) {
+                esperado[o.getIdItem()] += o.getQuantidade();
+            }
+        }
+        for (const auto& kv : ajustesPorItem) {
+            esperado[kv.first] += kv.second;
+        }
+        return esperado;
+    }
+
+public:
+    ProjecaoEstoque() : versao(0) {}
+
+    // Registra uma ordem recém-criada com o status informado
+    void registrarOrdem(int idItem, int quantidade, StatusOrdem status) {
+        if (!contaNoEstoque(status)) return;
+        totalPorItem[idItem] += quantidade;
+        versao++;
+    }
+
+    // Atualiza a projeção quando uma ordem muda de status (ex: PENDENTE -> REJEITADO)
+    void alterarStatus(int idItem, int quantidade, StatusOrdem antigo, StatusOrdem novo) {
+        bool antes = contaNoEstoque(antigo);
+        bool depois = contaNoEstoque(novo);
+        if (antes == depois) return;
+        totalPorItem[idItem] += depois ? quantidade : -quantidade;
+        versao++;
+    }
+
+    // Aplica um ajuste manual (entrada positiva, reserva negativa)
+    void ajustar(int idItem, int delta) {
+        ajustesPorItem[idItem] += delta;
+        totalPorItem[idItem] += delta;
+        versao++;
+    }
+
+    // Reconstrói a projeção do zero a partir das ordens (mantendo os ajustes manuais)
+    void reconstruir(const ListaGenerica<OrdemCompra>& ordens) {
+        totalPorItem = calcular(ordens);
+        versao++;
+    }
+
+    // Substitui os ajustes pelos salvos e reconstrói a partir das ordens (usado ao recarregar dados)
+    void reiniciar(const ListaGenerica<OrdemCompra>& ordens, const std::map<int, int>& ajustes) {
+        ajustesPorItem = ajustes;
+        reconstruir(ordens);
+    }
+
+    // Compara a projeção mantida com uma reconstrução completa.
+    // Retorna true se forem iguais; caso contrário preenche 'divergencias' com descrições.
+    bool verificarConsistencia(const ListaGenerica<OrdemCompra>& ordens,
+                               std::vector<std::string>& divergencias) const {
+        std::map<int, int> esperado = calcular(ordens);
+        std::map<int, int> uniao = esperado;
+        for (const auto& kv : totalPorItem) uniao.emplace(kv.first, 0);
+
+        for (const auto& kv : uniao) {
+            auto itEsp = esperado.find(kv.first);
+            auto itAtual = totalPorItem.find(kv.first);
+            int valorEsperado = (itEsp != esperado.end()) ? itEsp->second : 0;
+            int valorAtual = (itAtual != totalPorItem.end()) ? itAtual->second : 0;
+            if (valorEsperado != valorAtual) {
+                divergencias.push_back("Item " + std::to_string(kv.first) +
+                                       ": projetado " + std::to_string(valorAtual) +
+                                       ", esperado " + std::to_string(valorEsperado));
+            }
+        }
+        return divergencias.empty();
+    }
+
+    const std::map<int, int>& obterTotais() const { return totalPorItem; }
+    const std::map<int, int>& obterAjustes() const { return ajustesPorItem; }
+
+    // Elementos = itens distintos nos dois mapas somados
+    void medirMemoria(UsoMemoria& uso) const {
+        MemoriaEstimada::arvore(uso, totalPorItem);
+        MemoriaEstimada::arvore(uso, ajustesPorItem);
+    }
+    unsigned long obterVersao() const { return versao; }
+};
+
+#endif // PROJECAO_ESTOQUE_H
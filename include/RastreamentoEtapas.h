@@ -0,0 +1,142 @@
+#ifndef RASTREAMENTO_ETAPAS_H
+#define RASTREAMENTO_ETAPAS_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "HistogramaLatencia.h"
+
+// Etapas medidas do fluxo de uma ordem (da requisição HTTP à entrega dos efeitos)
+enum class Etapa {
+    HTTP_ESPERA_LOCK = 0,     ///< Espera pelo mutex global do servidor
+    HTTP_POST,                ///< handlePost inteiro, incluindo a espera acima
+    HTTP_PERSISTENCIA,        ///< Gravação dos arquivos após criar a ordem
+    ORDEM_ESPERA_LOCK,        ///< Espera pelo mutex do gerenciador na fase 1
+    ORDEM_REGISTRO,           ///< Registro como PENDENTE (mutex adquirido)
+    ORDEM_VERIFICACAO_VERBA,  ///< Da submissão até a resposta de verba
+    ORDEM_AUTORIZACAO,        ///< financeiro.autorizarPagamento
+    ORDEM_FINALIZACAO,        ///< Caixa de saída + efetivação do status
+    ORDEM_TOTAL,              ///< Da submissão ao status final
+    CAIXA_SAIDA_ENTREGA,      ///< Entrega de um evento a um módulo
+    TOTAL_ETAPAS
+};
+
+/*
+ * Histogramas de latência por etapa (ver HistogramaLatencia). Cada thread
+ * acumula num buffer próprio, sem lock e sem operações atômicas de
+ * leitura-modificação-escrita (um único escritor por contador); a leitura soma
+ * os buffers de todas as threads.
+ * Registrar uma duração custa uma leitura de relógio (steady_clock) e alguns
+ * nanossegundos de aritmética. Buffers de threads encerradas continuam somando.
+ */
+class RastreamentoEtapas {
+public:
+    using Relogio = std::chrono::steady_clock;
+
+    struct ResumoEtapa : HistogramaLatencia::Resumo {
+        const char* nome = "";
+    };
+
+private:
+    static constexpr int ETAPAS = static_cast<int>(Etapa::TOTAL_ETAPAS);
+
+    struct BufferThread {
+        HistogramaLatencia etapas[ETAPAS];
+    };
+
+    std::mutex mutex;   ///< Protege a lista de buffers (só no primeiro registro de cada thread)
+    std::vector<std::unique_ptr<BufferThread>> buffers;
+
+    RastreamentoEtapas() = default;
+
+    BufferThread& bufferDaThread() {
+        thread_local BufferThread* proprio = nullptr;
+        if (!proprio) {
+            auto novo = std::make_unique<BufferThread>();
+            proprio = novo.get();
+            std::lock_guard<std::mutex> lock(mutex);
+            buffers.push_back(std::move(novo));
+        }
+        return *proprio;
+    }
+
+public:
+    // Instância única do processo (nunca destruída: threads do executor registram até o fim)
+    static RastreamentoEtapas& instancia() {
+        static RastreamentoEtapas* unico = new RastreamentoEtapas();
+        return *unico;
+    }
+
+    RastreamentoEtapas(const RastreamentoEtapas&) = delete;
+    RastreamentoEtapas& operator=(const RastreamentoEtapas&) = delete;
+
+    static Relogio::time_point agora() { return Relogio::now(); }
+
+    void registrar(Etapa etapa, uint64_t ns) {
+        bufferDaThread().etapas[static_cast<int>(etapa)].registrar(ns);
+    }
+
+    // Registra o tempo decorrido desde 'inicio' (etapas que atravessam continuações)
+    void registrarDesde(Etapa etapa, Relogio::time_point inicio) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - inicio).count();
+        registrar(etapa, ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+
+    static const char* nomeEtapa(Etapa etapa) {
+        switch (etapa) {
+            case Etapa::HTTP_ESPERA_LOCK: return "http.esperaLock";
+            case Etapa::HTTP_POST: return "http.post";
+            case Etapa::HTTP_PERSISTENCIA: return "http.persistencia";
+            case Etapa::ORDEM_ESPERA_LOCK: return "ordem.esperaLock";
+            case Etapa::ORDEM_REGISTRO: return "ordem.registroPendente";
+            case Etapa::ORDEM_VERIFICACAO_VERBA: return "ordem.verificacaoVerba";
+            case Etapa::ORDEM_AUTORIZACAO: return "ordem.autorizacaoPagamento";
+            case Etapa::ORDEM_FINALIZACAO: return "ordem.finalizacao";
+            case Etapa::ORDEM_TOTAL: return "ordem.total";
+            case Etapa::CAIXA_SAIDA_ENTREGA: return "caixaSaida.entrega";
+            default: return "?";
+        }
+    }
+
+    // Soma os buffers de todas as threads e calcula média, percentis e máximo de cada etapa
+    std::vector<ResumoEtapa> obterResumo() {
+        std::vector<HistogramaLatencia::Acumulado> acumulados(ETAPAS);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& b : buffers) {
+                for (int e = 0; e < ETAPAS; e++) b->etapas[e].somarEm(acumulados[e]);
+            }
+        }
+        std::vector<ResumoEtapa> resumo;
+        for (int e = 0; e < ETAPAS; e++) {
+            ResumoEtapa r;
+            static_cast<HistogramaLatencia::Resumo&>(r) = acumulados[e].resumir();
+            r.nome = nomeEtapa(static_cast<Etapa>(e));
+            resumo.push_back(r);
+        }
+        return resumo;
+    }
+};
+
+/*
+ * Mede o trecho entre a construção e a destruição (escopo) como uma etapa.
+ * Uso: MedidorEtapa medidor(Etapa::ORDEM_FINALIZACAO);
+ */
+class MedidorEtapa {
+private:
+    Etapa etapa;
+    RastreamentoEtapas::Relogio::time_point inicio;
+
+public:
+    explicit MedidorEtapa(Etapa etapa, RastreamentoEtapas::Relogio::time_point inicio = RastreamentoEtapas::agora())
+        : etapa(etapa), inicio(inicio) {}
+
+    ~MedidorEtapa() { RastreamentoEtapas::instancia().registrarDesde(etapa, inicio); }
+
+    MedidorEtapa(const MedidorEtapa&) = delete;
+    MedidorEtapa& operator=(const MedidorEtapa&) = delete;
+};
+
+#endif // RASTREAMENTO_ETAPAS_H
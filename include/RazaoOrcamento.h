@@ -0,0 +1,186 @@
+#ifndef RAZAO_ORCAMENTO_H
+#define RAZAO_ORCAMENTO_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include "IntegracoesResilientes.h"
+#include "ExecutorIntegracao.h"
+#include "RegistroLog.h"
+
+/*
+ * Razão local de orçamento.
+ * Obtém do financeiro uma fatia de verba (concessão, já debitada do saldo lá)
+ * e reserva cada ordem contra essa fatia com compare-and-swap num inteiro de
+ * centavos: a maioria das ordens é aprovada sem ida ao financeiro e duas ordens
+ * concorrentes nunca consomem a mesma verba.
+ * Quando o saldo local cai abaixo do limite de renovação, uma nova concessão é
+ * pedida em segundo plano (sem bloquear o executor: a resposta chega como
+ * continuação); há no máximo uma renovação em curso, e
+ * as ordens que não cabem no saldo local esperam por ela em vez de pedir cada uma
+ * a sua. Se ainda assim não couberem, pedem uma concessão de pelo menos o próprio
+ * valor antes de serem recusadas.
+ */
+class RazaoOrcamento {
+public:
+    struct Metricas {
+        Dinheiro disponivel;                ///< Saldo local ainda não reservado
+        Dinheiro concedidoTotal;            ///< Soma das concessões recebidas do financeiro
+        unsigned long long reservasLocais = 0;   ///< Reservas feitas sem chamada remota
+        unsigned long long reservasRemotas = 0;  ///< Reservas que precisaram esperar uma concessão
+        unsigned long long recusas = 0;
+        unsigned long long renovacoes = 0;       ///< Concessões pedidas em segundo plano
+    };
+
+private:
+    FinanceiroResiliente& financeiro;
+    ExecutorIntegracao& executor;
+    const Dinheiro tamanhoConcessao;
+    const Dinheiro limiteRenovacao;
+
+    std::atomic<int64_t> disponivelCentavos{0};
+
+    std::mutex mutexRenovacao;
+    Futuro<bool> renovacaoEmCurso;   ///< Protegido por mutexRenovacao
+    bool renovando = false;          ///< Protegido por mutexRenovacao
+
+    std::atomic<int64_t> concedidoCentavos{0};
+    std::atomic<unsigned long long> reservasLocais{0};
+    std::atomic<unsigned long long> reservasRemotas{0};
+    std::atomic<unsigned long long> recusas{0};
+    std::atomic<unsigned long long> renovacoes{0};
+
+    // Debita 'valor' do saldo local se couber (sem bloqueio: CAS em loop)
+    bool tentarReservar(int64_t valor) {
+        int64_t atual = disponivelCentavos.load(std::memory_order_relaxed);
+        do {
+            if (atual < valor) return false;
+        } while (!disponivelCentavos.compare_exchange_weak(atual, atual - valor, std::memory_order_acq_rel,
+                                                           std::memory_order_relaxed));
+        return true;
+    }
+
+    // Pede uma concessão ao financeiro (chamada remota) e credita no saldo local.
+    // Uma concessão menor que 'minimo' não serve a quem pediu e volta na hora ao financeiro.
+    Futuro<bool> obterConcessao(Dinheiro valor, Dinheiro minimo) {
+        return financeiro.solicitarVerbaAssincrona(valor).transferirPara(executor).quandoPronto(
+            [this, minimo](const Futuro<Dinheiro>& resposta) {
+                Dinheiro concedido = resposta.obter();
+                if (concedido <= Dinheiro()) return false;
+                if (concedido < minimo) {
+                    financeiro.devolverVerba(concedido);
+                    return false;
+                }
+                disponivelCentavos.fetch_add(concedido.emCentavos());
+                concedidoCentavos.fetch_add(concedido.emCentavos(), std::memory_order_relaxed);
+                return true;
+            });
+    }
+
+    // Devolve a renovação em curso ou inicia uma nova
+    Futuro<bool> iniciarRenovacao() {
+        std::lock_guard<std::mutex> lock(mutexRenovacao);
+        if (renovando) return renovacaoEmCurso;
+        renovando = true;
+        renovacoes.fetch_add(1, std::memory_order_relaxed);
+        renovacaoEmCurso = obterConcessao(tamanhoConcessao, Dinheiro::deCentavos(1))
+            .quandoPronto([this](const Futuro<bool>& resposta) {
+                bool concedida = false;
+                try {
+                    concedida = resposta.obter();
+                } catch (const std::exception& e) {
+                    LOG_ERRO("RAZAO", "Falha ao renovar concessao: " << e.what());
+                }
+                std::lock_guard<std::mutex> lock(mutexRenovacao);
+                renovando = false;
+                return concedida;
+            });
+        return renovacaoEmCurso;
+    }
+
+    void renovarSeNecessario() {
+        if (disponivelCentavos.load(std::memory_order_relaxed) < limiteRenovacao.emCentavos()) iniciarRenovacao();
+    }
+
+    bool contabilizar(bool reservado) {
+        (reservado ? reservasRemotas : recusas).fetch_add(1, std::memory_order_relaxed);
+        if (reservado) renovarSeNecessario();
+        return reservado;
+    }
+
+    // Caminho lento: tenta de novo e, se preciso, pede uma concessão só para esta ordem.
+    // Uma falha do financeiro chega a quem reservou como erro do Futuro.
+    Futuro<bool> reservarComConcessao(Dinheiro valor) {
+        int64_t centavos = valor.emCentavos();
+        if (tentarReservar(centavos)) return futuroPronto(executor, contabilizar(true));
+        return obterConcessao(valor > tamanhoConcessao ? valor : tamanhoConcessao, valor)
+            .entao([this, centavos](bool obtida) { return contabilizar(obtida && tentarReservar(centavos)); });
+    }
+
+public:
+    // 'limiteRenovacao': abaixo deste saldo local uma nova concessão é pedida
+    RazaoOrcamento(FinanceiroResiliente& financeiro, ExecutorIntegracao& executor, Dinheiro tamanhoConcessao,
+                   Dinheiro limiteRenovacao)
+        : financeiro(financeiro), executor(executor), tamanhoConcessao(tamanhoConcessao),
+          limiteRenovacao(limiteRenovacao) {
+        // Primeira concessão já na inicialização, para as primeiras ordens não esperarem
+        renovarSeNecessario();
+    }
+
+    // Devolve ao financeiro a verba concedida e não usada.
+    // A renovação em curso deve ter terminado (ver aguardarRenovacao).
+    ~RazaoOrcamento() {
+        int64_t sobra = disponivelCentavos.exchange(0);
+        if (sobra > 0) financeiro.devolverVerba(Dinheiro::deCentavos(sobra));
+    }
+
+    RazaoOrcamento(const RazaoOrcamento&) = delete;
+    RazaoOrcamento& operator=(const RazaoOrcamento&) = delete;
+
+    // Espera a renovação em curso, se houver (encerramento: antes de destruir o executor).
+    // Não chamar de uma thread do executor.
+    void aguardarRenovacao() {
+        Futuro<bool> renovacao;
+        {
+            std::lock_guard<std::mutex> lock(mutexRenovacao);
+            if (!renovando) return;
+            renovacao = renovacaoEmCurso;
+        }
+        renovacao.obter();
+    }
+
+    // Reserva a verba da ordem. O Futuro já vem pronto quando o saldo local basta;
+    // caso contrário, resolve após uma concessão de pelo menos 'valor' (false se o
+    // financeiro não tiver saldo suficiente).
+    Futuro<bool> reservar(Dinheiro valor) {
+        int64_t centavos = valor.emCentavos();
+        if (tentarReservar(centavos)) {
+            reservasLocais.fetch_add(1, std::memory_order_relaxed);
+            renovarSeNecessario();
+            return futuroPronto(executor, true);
+        }
+        if (valor <= tamanhoConcessao) {
+            // Cabe numa concessão normal: espera a renovação compartilhada (que nunca falha)
+            return iniciarRenovacao().encadear([this, valor](bool) { return reservarComConcessao(valor); });
+        }
+        return reservarComConcessao(valor);
+    }
+
+    // Estorna uma reserva cuja ordem não foi aprovada (ex: pagamento recusado)
+    void devolver(Dinheiro valor) {
+        disponivelCentavos.fetch_add(valor.emCentavos());
+    }
+
+    Metricas obterMetricas() const {
+        Metricas m;
+        m.disponivel = Dinheiro::deCentavos(disponivelCentavos.load());
+        m.concedidoTotal = Dinheiro::deCentavos(concedidoCentavos.load());
+        m.reservasLocais = reservasLocais.load();
+        m.reservasRemotas = reservasRemotas.load();
+        m.recusas = recusas.load();
+        m.renovacoes = renovacoes.load();
+        return m;
+    }
+};
+
+#endif // RAZAO_ORCAMENTO_H
@@ -0,0 +1,257 @@
+#ifndef REGISTRO_LOG_H
+#define REGISTRO_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// Níveis do log, do mais detalhado ao mais grave
+enum class NivelLog { DEPURACAO = 0, INFO = 1, AVISO = 2, ERRO = 3 };
+
+enum class FormatoLog {
+    TEXTO,  ///< "12:34:56.789 INFO  [MODULO] mensagem" (UTC)
+    JSON    ///< Um objeto JSON por linha
+};
+
+// Níveis abaixo deste nem são compilados (ex: -DNIVEL_LOG_MINIMO=2 remove DEPURACAO e INFO)
+#ifndef NIVEL_LOG_MINIMO
+    #define NIVEL_LOG_MINIMO 0
+#endif
+
+/*
+ * Log assíncrono com níveis.
+ * Quem registra só formata a mensagem e a coloca num anel de tamanho fixo sem
+ * bloqueio (fila MPMC limitada com número de sequência por posição); uma thread
+ * própria esvazia o anel e escreve no terminal em blocos. Nenhuma escrita em
+ * std::cout acontece na thread que registrou, então seções críticas que registram
+ * não incluem mais E/S de terminal. Com o anel cheio, o registro é descartado e
+ * contado (quem registra nunca espera pelo terminal).
+ * Cada registro é estruturado: instante, nível, módulo, thread e mensagem.
+ * No encerramento do processo o anel é esvaziado e o log passa a escrever direto.
+ */
+class RegistroLog {
+private:
+    struct Registro {
+        std::chrono::system_clock::time_point instante;
+        NivelLog nivel = NivelLog::INFO;
+        const char* modulo = "";
+        size_t thread = 0;
+        std::string mensagem;
+    };
+
+    struct Posicao {
+        std::atomic<size_t> sequencia{0};
+        Registro registro;
+    };
+
+    static constexpr size_t CAPACIDADE = 8192;   // potência de 2
+    std::unique_ptr<Posicao[]> anel;
+    alignas(64) std::atomic<size_t> cauda{0};    ///< Próxima posição a escrever (produtores)
+    alignas(64) size_t cabeca = 0;               ///< Próxima posição a ler (só a thread do log)
+
+    std::atomic<int> nivelMinimo{static_cast<int>(NivelLog::INFO)};
+    std::atomic<int> formato{static_cast<int>(FormatoLog::TEXTO)};
+    std::atomic<unsigned long long> descartados{0};
+    std::atomic<bool> consumidorDormindo{false};
+    std::atomic<bool> encerrado{false};
+
+    std::mutex mutexEscrita;   ///< Serializa a escrita no terminal depois do encerramento
+    std::mutex mutexSono;
+    std::condition_variable acordar;
+    bool parar = false;        ///< Protegido por mutexSono
+    std::thread escritor;
+
+    RegistroLog() : anel(new Posicao[CAPACIDADE]) {
+        for (size_t i = 0; i < CAPACIDADE; i++) anel[i].sequencia.store(i, std::memory_order_relaxed);
+        escritor = std::thread(&RegistroLog::laco, this);
+        std::atexit([] { RegistroLog::instancia().encerrar(); });
+    }
+
+    bool enfileirar(Registro&& r) {
+        size_t pos = cauda.load(std::memory_order_relaxed);
+        Posicao* p;
+        while (true) {
+            p = &anel[pos & (CAPACIDADE - 1)];
+            size_t seq = p->sequencia.load(std::memory_order_acquire);
+            intptr_t diferenca = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diferenca == 0) {
+                if (cauda.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diferenca < 0) {
+                return false; // anel cheio
+            } else {
+                pos = cauda.load(std::memory_order_relaxed);
+            }
+        }
+        p->registro = std::move(r);
+        p->sequencia.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool desenfileirar(Registro& r) {
+        Posicao& p = anel[cabeca & (CAPACIDADE - 1)];
+        if (p.sequencia.load(std::memory_order_acquire) != cabeca + 1) return false;
+        r = std::move(p.registro);
+        p.sequencia.store(cabeca + CAPACIDADE, std::memory_order_release);
+        cabeca++;
+        return true;
+    }
+
+    static const char* nomeNivel(NivelLog nivel) {
+        switch (nivel) {
+            case NivelLog::DEPURACAO: return "DEPURACAO";
+            case NivelLog::INFO: return "INFO";
+            case NivelLog::AVISO: return "AVISO";
+            default: return "ERRO";
+        }
+    }
+
+    static std::string escaparJson(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s) {
+            if (c == '"' || c == '\\') { out += '\\'; out += c; }
+            else if (c == '\n') out += "\\n";
+            else if (static_cast<unsigned char>(c) < 0x20) out += ' ';
+            else out += c;
+        }
+        return out;
+    }
+
+    void formatar(const Registro& r, std::string& saida) const {
+        // Horário UTC calculado aqui mesmo: gmtime/localtime/strftime passam pelo
+        // estado de fuso da libc, que o mktime do resto do programa reescreve
+        long long totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(r.instante.time_since_epoch()).count();
+        long long dias = totalMs / 86400000;
+        long long msDia = totalMs % 86400000;
+        // Dias desde 1970-01-01 para ano/mês/dia (calendário gregoriano)
+        long long z = dias + 719468;
+        long long era = z / 146097;
+        long long doe = z - era * 146097;
+        long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        long long mp = (5 * doy + 2) / 153;
+        int dia = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        int mes = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        int ano = static_cast<int>(yoe + era * 400 + (mes <= 2 ? 1 : 0));
+        char hora[32];
+        std::snprintf(hora, sizeof(hora), "%02d:%02d:%02d.%03d", static_cast<int>(msDia / 3600000),
+                      static_cast<int>(msDia / 60000 % 60), static_cast<int>(msDia / 1000 % 60), static_cast<int>(msDia % 1000));
+        std::ostringstream os;
+        if (static_cast<FormatoLog>(formato.load(std::memory_order_relaxed)) == FormatoLog::JSON) {
+            os << "{\"ts\":\"" << std::setfill('0') << ano << "-" << std::setw(2) << mes << "-" << std::setw(2) << dia << "T" << hora << "Z\",\"nivel\":\"" << nomeNivel(r.nivel) << "\",\"modulo\":\"" << r.modulo
+               << "\",\"thread\":" << r.thread << ",\"msg\":\"" << escaparJson(r.mensagem) << "\"}\n";
+        } else {
+            os << hora << " "
+               << std::setfill(' ') << std::left << std::setw(5) << nomeNivel(r.nivel) << " [" << r.modulo << "] "
+               << r.mensagem << "\n";
+        }
+        saida += os.str();
+    }
+
+    // Esvazia o anel num único bloco de escrita; devolve se havia algo
+    bool drenar() {
+        std::string bloco;
+        Registro r;
+        while (desenfileirar(r)) formatar(r, bloco);
+        unsigned long long perdidos = descartados.exchange(0);
+        if (perdidos > 0) {
+            bloco += "[LOG] " + std::to_string(perdidos) + " registro(s) descartado(s): anel cheio\n";
+        }
+        if (bloco.empty()) return false;
+        std::cout << bloco << std::flush;
+        return true;
+    }
+
+    void laco() {
+        while (true) {
+            if (drenar()) continue;
+            std::unique_lock<std::mutex> lock(mutexSono);
+            if (parar) break;
+            consumidorDormindo.store(true);
+            acordar.wait_for(lock, std::chrono::milliseconds(50));
+            consumidorDormindo.store(false);
+        }
+        drenar();
+    }
+
+public:
+    // Instância única do processo (nunca destruída: objetos estáticos podem registrar até o fim)
+    static RegistroLog& instancia() {
+        static RegistroLog* unico = new RegistroLog();
+        return *unico;
+    }
+
+    RegistroLog(const RegistroLog&) = delete;
+    RegistroLog& operator=(const RegistroLog&) = delete;
+
+    void configurar(NivelLog minimo, FormatoLog novoFormato) {
+        nivelMinimo.store(static_cast<int>(minimo));
+        formato.store(static_cast<int>(novoFormato));
+    }
+
+    bool habilitado(NivelLog nivel) const {
+        return static_cast<int>(nivel) >= nivelMinimo.load(std::memory_order_relaxed);
+    }
+
+    void registrar(NivelLog nivel, const char* modulo, std::string mensagem) {
+        Registro r;
+        r.instante = std::chrono::system_clock::now();
+        r.nivel = nivel;
+        r.modulo = modulo;
+        r.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        r.mensagem = std::move(mensagem);
+        if (encerrado.load(std::memory_order_acquire)) {
+            std::string linha;
+            formatar(r, linha);
+            std::lock_guard<std::mutex> lock(mutexEscrita);
+            std::cout << linha << std::flush;
+            return;
+        }
+        if (!enfileirar(std::move(r))) {
+            descartados.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (consumidorDormindo.load(std::memory_order_relaxed)) acordar.notify_one();
+    }
+
+    // Escreve o que estiver no anel e passa a escrever direto (chamado na saída do processo).
+    // Um registro feito exatamente durante o encerramento pode se perder.
+    void encerrar() {
+        if (encerrado.exchange(true)) return;
+        {
+            std::lock_guard<std::mutex> lock(mutexSono);
+            parar = true;
+        }
+        acordar.notify_one();
+        escritor.join();
+    }
+};
+
+#define LOG_REGISTRAR(nivel, modulo, mensagem)                                               \
+    do {                                                                                     \
+        if constexpr (static_cast<int>(nivel) >= NIVEL_LOG_MINIMO) {                         \
+            if (RegistroLog::instancia().habilitado(nivel)) {                                \
+                std::ostringstream log_os_;                                                  \
+                log_os_ << mensagem;                                                         \
+                RegistroLog::instancia().registrar(nivel, modulo, log_os_.str());            \
+            }                                                                                \
+        }                                                                                    \
+    } while (0)
+
+#define LOG_DEPURACAO(modulo, mensagem) LOG_REGISTRAR(NivelLog::DEPURACAO, modulo, mensagem)
+#define LOG_INFO(modulo, mensagem) LOG_REGISTRAR(NivelLog::INFO, modulo, mensagem)
+#define LOG_AVISO(modulo, mensagem) LOG_REGISTRAR(NivelLog::AVISO, modulo, mensagem)
+#define LOG_ERRO(modulo, mensagem) LOG_REGISTRAR(NivelLog::ERRO, modulo, mensagem)
+
+#endif // REGISTRO_LOG_H
@@ -0,0 +1,274 @@
+#ifndef RESILIENCIA_H
+#define RESILIENCIA_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include "ComprasException.h"
+#include "ExecutorIntegracao.h"
+#include "Temporizador.h"
+
+// Parâmetros de proteção das chamadas a um módulo integrado
+struct PoliticaResiliencia {
+    std::chrono::milliseconds prazo{10000};       ///< Tempo máximo de cada tentativa
+    int tentativas = 3;                           ///< Total de tentativas (só operações idempotentes repetem)
+    std::chrono::milliseconds esperaBase{100};    ///< Espera antes da 2ª tentativa (dobra a cada nova, com jitter)
+    int falhasParaAbrir = 5;                      ///< Falhas seguidas que abrem o circuito
+    std::chrono::milliseconds tempoAberto{10000}; ///< Tempo em que o circuito recusa chamadas antes de testar de novo
+};
+
+/*
+ * Disjuntor (circuit breaker) de um módulo.
+ * FECHADO: chamadas passam. Após 'falhasParaAbrir' falhas seguidas, ABERTO:
+ * chamadas são recusadas na hora. Passado 'tempoAberto', MEIO_ABERTO: uma única
+ * chamada de teste passa; se der certo o circuito fecha, senão abre de novo.
+ */
+class DisjuntorCircuito {
+public:
+    enum class Estado { FECHADO, ABERTO, MEIO_ABERTO };
+
+private:
+    using Relogio = std::chrono::steady_clock;
+
+    mutable std::mutex mutex;
+    Estado estado = Estado::FECHADO;
+    int falhasSeguidas = 0;
+    bool testeEmCurso = false;
+    Relogio::time_point abertoAte;
+    const int falhasParaAbrir;
+    const std::chrono::milliseconds tempoAberto;
+
+public:
+    DisjuntorCircuito(int falhasParaAbrir, std::chrono::milliseconds tempoAberto)
+        : falhasParaAbrir(falhasParaAbrir > 0 ? falhasParaAbrir : 1), tempoAberto(tempoAberto) {}
+
+    bool permitir() {
+        std::lock_guard<std::mutex> lock(mutex);
+        switch (estado) {
+            case Estado::FECHADO:
+                return true;
+            case Estado::ABERTO:
+                if (Relogio::now() < abertoAte) return false;
+                estado = Estado::MEIO_ABERTO;
+                testeEmCurso = true;
+                return true;
+            case Estado::MEIO_ABERTO:
+            default:
+                if (testeEmCurso) return false;
+                testeEmCurso = true;
+                return true;
+        }
+    }
+
+    void registrarSucesso() {
+        std::lock_guard<std::mutex> lock(mutex);
+        estado = Estado::FECHADO;
+        falhasSeguidas = 0;
+        testeEmCurso = false;
+    }
+
+    void registrarFalha() {
+        std::lock_guard<std::mutex> lock(mutex);
+        falhasSeguidas++;
+        if (estado == Estado::MEIO_ABERTO || falhasSeguidas >= falhasParaAbrir) {
+            estado = Estado::ABERTO;
+            abertoAte = Relogio::now() + tempoAberto;
+            testeEmCurso = false;
+        }
+    }
+
+    Estado obterEstado() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return estado;
+    }
+
+    static const char* nomeEstado(Estado e) {
+        switch (e) {
+            case Estado::FECHADO: return "FECHADO";
+            case Estado::ABERTO: return "ABERTO";
+            default: return "MEIO_ABERTO";
+        }
+    }
+};
+
+/*
+ * Aplica prazo, novas tentativas e disjuntor às chamadas de um módulo.
+ * Nada aqui bloqueia quem chama: cada tentativa roda no executor de chamadas
+ * remotas, o prazo é uma ação agendada no Temporizador que abandona a tentativa
+ * se ela não responder a tempo, e a espera antes de uma nova tentativa também é
+ * agendada nele. A thread de uma tentativa abandonada fica ocupada até o módulo
+ * responder (o disjuntor evita que módulos travados esgotem esse executor).
+ * Falhas são exceções ou prazo excedido; um retorno false do módulo é uma
+ * resposta válida, não uma falha. Esgotadas as tentativas, ou com o circuito
+ * aberto, o Futuro falha com ComprasException.
+ */
+class GuardaIntegracao {
+public:
+    struct Metricas {
+        std::string modulo;
+        DisjuntorCircuito::Estado estado = DisjuntorCircuito::Estado::FECHADO;
+        uint64_t chamadas = 0;
+        uint64_t falhas = 0;               ///< Tentativas que falharam (inclui prazo excedido)
+        uint64_t prazosExcedidos = 0;
+        uint64_t novasTentativas = 0;
+        uint64_t recusadasCircuitoAberto = 0;
+    };
+
+private:
+    const std::string modulo;
+    const PoliticaResiliencia politica;
+    ExecutorIntegracao& chamadasRemotas;
+    Temporizador& temporizador;
+    DisjuntorCircuito disjuntor;
+
+    std::atomic<uint64_t> chamadas{0};
+    std::atomic<uint64_t> falhas{0};
+    std::atomic<uint64_t> prazosExcedidos{0};
+    std::atomic<uint64_t> novasTentativas{0};
+    std::atomic<uint64_t> recusadas{0};
+
+    // Estados do resultado de uma tentativa, decididos por quem chegar primeiro
+    enum Desfecho : int { AGUARDANDO = 0, ENTREGUE = 1, ABANDONADO = 2 };
+
+    // Uma chamada e todas as suas tentativas
+    template <typename R>
+    struct Chamada {
+        std::string operacao;
+        std::function<R()> funcao;
+        std::function<void(const R&)> compensar;
+        int maximo = 1;
+        int tentativa = 0;   ///< Só muda quando não há tentativa em curso
+        Promessa<R> resultado;
+
+        explicit Chamada(ExecutorIntegracao& executor) : resultado(executor) {}
+    };
+
+    static std::string descrever(std::exception_ptr erro) {
+        try {
+            std::rethrow_exception(erro);
+        } catch (const std::exception& e) {
+            return e.what();
+        } catch (...) {
+            return "excecao desconhecida";
+        }
+    }
+
+    // Uma tentativa com prazo. Se o prazo vencer, a tentativa é marcada como abandonada;
+    // quando o módulo enfim responder, 'compensar' recebe o resultado descartado.
+    template <typename R>
+    void iniciarTentativa(std::shared_ptr<Chamada<R>> c) {
+        c->tentativa++;
+        if (!disjuntor.permitir()) {
+            recusadas.fetch_add(1, std::memory_order_relaxed);
+            c->resultado.falhar(std::make_exception_ptr(
+                ComprasException(modulo + "." + c->operacao + ": circuito aberto, chamada recusada")));
+            return;
+        }
+        auto desfecho = std::make_shared<std::atomic<int>>(AGUARDANDO);
+        Temporizador::Identificador prazo = temporizador.agendar(politica.prazo, [this, c, desfecho] {
+            int esperado = AGUARDANDO;
+            if (!desfecho->compare_exchange_strong(esperado, ABANDONADO)) return; // a resposta chegou antes
+            prazosExcedidos.fetch_add(1, std::memory_order_relaxed);
+            registrarFalha(c, std::make_exception_ptr(ComprasException(
+                modulo + "." + c->operacao + ": prazo de " + std::to_string(politica.prazo.count()) + " ms excedido")));
+        });
+        chamadasRemotas.submeter([this, c, desfecho, prazo] {
+            std::optional<R> r;
+            std::exception_ptr erro;
+            try {
+                r = c->funcao();
+            } catch (...) {
+                erro = std::current_exception();
+            }
+            int esperado = AGUARDANDO;
+            if (!desfecho->compare_exchange_strong(esperado, ENTREGUE)) {
+                // Abandonada pelo prazo: o resultado não vale mais, o efeito é desfeito
+                if (r && c->compensar) c->compensar(*r);
+                return true;
+            }
+            temporizador.cancelar(prazo);
+            if (erro) {
+                registrarFalha(c, erro);
+            } else {
+                disjuntor.registrarSucesso();
+                c->resultado.cumprir(std::move(*r));
+            }
+            return true;
+        });
+    }
+
+    // Conta a falha e agenda a próxima tentativa, ou falha a chamada se elas acabaram
+    template <typename R>
+    void registrarFalha(std::shared_ptr<Chamada<R>> c, std::exception_ptr erro) {
+        disjuntor.registrarFalha();
+        falhas.fetch_add(1, std::memory_order_relaxed);
+        if (c->tentativa >= c->maximo) {
+            c->resultado.falhar(std::make_exception_ptr(ComprasException(
+                descrever(erro) + " (" + std::to_string(c->tentativa) + " tentativa(s))")));
+            return;
+        }
+        novasTentativas.fetch_add(1, std::memory_order_relaxed);
+        temporizador.agendar(esperaAntesDe(c->tentativa + 1), [this, c] { iniciarTentativa(c); });
+    }
+
+    // Espera exponencial com jitter: esperaBase * 2^(tentativa-2) * [0.5, 1.5)
+    std::chrono::milliseconds esperaAntesDe(int tentativa) {
+        thread_local std::mt19937 gerador(std::random_device{}());
+        std::uniform_real_distribution<double> jitter(0.5, 1.5);
+        auto base = politica.esperaBase.count() * (1LL << std::min(tentativa - 2, 20));
+        return std::chrono::milliseconds(static_cast<long long>(base * jitter(gerador)));
+    }
+
+public:
+    GuardaIntegracao(std::string modulo, const PoliticaResiliencia& politica, ExecutorIntegracao& chamadasRemotas,
+                     Temporizador& temporizador)
+        : modulo(std::move(modulo)), politica(politica), chamadasRemotas(chamadasRemotas),
+          temporizador(temporizador), disjuntor(politica.falhasParaAbrir, politica.tempoAberto) {}
+
+    // 'idempotente': só operações que podem ser repetidas sem efeito duplicado
+    // recebem novas tentativas. 'compensar' desfaz o efeito de uma tentativa abandonada.
+    // Devolve na hora; as continuações do Futuro rodam no executor de chamadas remotas.
+    template <typename F, typename R = std::invoke_result_t<F&>>
+    Futuro<R> executarAssincrono(const std::string& operacao, F chamada, bool idempotente,
+                                 const std::function<void(const std::invoke_result_t<F&>&)>& compensar = nullptr) {
+        chamadas.fetch_add(1, std::memory_order_relaxed);
+        auto c = std::make_shared<Chamada<R>>(chamadasRemotas);
+        c->operacao = operacao;
+        c->funcao = std::move(chamada);
+        c->compensar = compensar;
+        c->maximo = idempotente ? (politica.tentativas > 0 ? politica.tentativas : 1) : 1;
+        Futuro<R> futuro = c->resultado.obterFuturo();
+        iniciarTentativa(c);
+        return futuro;
+    }
+
+    // Versão que espera o resultado (para quem está fora do fluxo de aprovação,
+    // ex: consultas do console); lança ComprasException como executarAssincrono falharia.
+    template <typename F, typename R = std::invoke_result_t<F&>>
+    R executar(const std::string& operacao, F chamada, bool idempotente,
+               const std::function<void(const std::invoke_result_t<F&>&)>& compensar = nullptr) {
+        return executarAssincrono(operacao, std::move(chamada), idempotente, compensar).obter();
+    }
+
+    Metricas obterMetricas() const {
+        Metricas m;
+        m.modulo = modulo;
+        m.estado = disjuntor.obterEstado();
+        m.chamadas = chamadas.load();
+        m.falhas = falhas.load();
+        m.prazosExcedidos = prazosExcedidos.load();
+        m.novasTentativas = novasTentativas.load();
+        m.recusadasCircuitoAberto = recusadas.load();
+        return m;
+    }
+};
+
+#endif // RESILIENCIA_H
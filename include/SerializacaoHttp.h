@@ -0,0 +1,111 @@
+#ifndef SERIALIZACAO_HTTP_H
+#define SERIALIZACAO_HTTP_H
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include "Fornecedor.h"
+#include "ListaGenerica.h"
+#include "OrdemCompra.h"
+
+/*
+ * Serialização JSON das coleções e leitura de parâmetros de URL usadas pelo
+ * servidor HTTP. Ficam fora de servidor.cpp para que outros alvos (os
+ * benchmarks, por exemplo) usem o mesmo código sem compilar o servidor junto.
+ */
+
+inline std::string jsonEscape(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (char c : in) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: out += c; break;
+        }
+    }
+    return out;
+}
+
+// "a=1&b=x+y" -> {a: "1", b: "x y"}; sequências %XX ficam como vieram (ver urlDecode)
+inline std::map<std::string, std::string> parseQuery(const std::string& query) {
+    std::map<std::string, std::string> params;
+    std::stringstream ss(query);
+    std::string kv;
+    while (std::getline(ss, kv, '&')) {
+        auto pos = kv.find('=');
+        if (pos != std::string::npos) {
+            std::string k = kv.substr(0, pos);
+            std::string v = kv.substr(pos + 1);
+            std::replace(v.begin(), v.end(), '+', ' ');
+            params[k] = v;
+        }
+    }
+    return params;
+}
+
+// Decodifica sequências %XX (datas como 24/10/2025 chegam como 24%2F10%2F2025)
+inline std::string urlDecode(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] == '%' && i + 2 < in.size() && std::isxdigit(static_cast<unsigned char>(in[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(in[i + 2]))) {
+            out += static_cast<char>(std::stoi(in.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            out += in[i];
+        }
+    }
+    return out;
+}
+
+inline std::string jsonFornecedores(const ListaGenerica<Fornecedor>& lista) {
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < lista.obterTamanho(); ++i) {
+        const auto& f = lista.obter(i);
+        os << "{";
+        os << "\"id\":" << f.getId() << ",";
+        os << "\"nome\":\"" << jsonEscape(f.getNome()) << "\",";
+        os << "\"produto\":\"" << jsonEscape(f.getProduto()) << "\",";
+        os << "\"preco\":" << f.getPrecoProduto() << ",";
+        os << "\"cnpj\":\"" << jsonEscape(f.getCNPJ()) << "\",";
+        os << "\"endereco\":\"" << jsonEscape(f.getEndereco()) << "\"";
+        os << "}";
+        if (i + 1 < lista.obterTamanho()) os << ",";
+    }
+    os << "]";
+    return os.str();
+}
+
+inline void jsonOrdem(std::ostream& os, const OrdemCompra& o) {
+    os << "{";
+    os << "\"id\":" << o.getIdTransacao() << ",";
+    os << "\"idItem\":" << o.getIdItem() << ",";
+    os << "\"quantidade\":" << o.getQuantidade() << ",";
+    os << "\"valor\":" << o.getValorUnitario() << ",";
+    os << "\"status\":" << static_cast<int>(o.getStatus()) << ",";
+    os << "\"descricao\":\"" << jsonEscape(o.getDataSolicitacao()) << "\",";
+    os << "\"data_chegada\":\"" << jsonEscape(o.getDataChegadaPrevista()) << "\"";
+    os << "}";
+}
+
+inline std::string jsonOrdens(const ListaGenerica<OrdemCompra>& lista) {
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < lista.obterTamanho(); ++i) {
+        jsonOrdem(os, lista.obter(i));
+        if (i + 1 < lista.obterTamanho()) os << ",";
+    }
+    os << "]";
+    return os.str();
+}
+
+#endif // SERIALIZACAO_HTTP_H
@@ -0,0 +1,37 @@
+#ifndef SIMULADOR_FALHAS_H
+#define SIMULADOR_FALHAS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "ComprasException.h"
+
+/*
+ * Injeção de falhas nos módulos simulados, para exercitar a camada de resiliência.
+ * Permite forçar, em tempo de execução, um atraso extra antes de cada chamada
+ * (módulo lento) e/ou que as chamadas lancem exceção (módulo fora do ar).
+ */
+class SimuladorFalhas {
+private:
+    std::atomic<int> atrasoExtraMs{0};
+    std::atomic<bool> falhar{false};
+
+public:
+    void configurar(int atrasoMs, bool falharChamadas) {
+        atrasoExtraMs = (atrasoMs > 0) ? atrasoMs : 0;
+        falhar = falharChamadas;
+    }
+
+    int obterAtrasoExtraMs() const { return atrasoExtraMs; }
+    bool estaFalhando() const { return falhar; }
+
+    // Chamado no início de cada operação remota do módulo simulado
+    void aplicar(const char* modulo) const {
+        int atraso = atrasoExtraMs;
+        if (atraso > 0) std::this_thread::sleep_for(std::chrono::milliseconds(atraso));
+        if (falhar) throw ComprasException(std::string(modulo) + ": falha simulada");
+    }
+};
+
+#endif // SIMULADOR_FALHAS_H
@@ -0,0 +1,157 @@
+#ifndef TABELA_ORDENS_H
+#define TABELA_ORDENS_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "OrdemCompra.h"
+#include "ListaGenerica.h"
+#include "DataHora.h"
+#include "MemoriaEstimada.h"
+
+/*
+ * Resultado agregado de uma varredura sobre as ordens.
+ * Contagens indexadas pelo valor numérico de StatusOrdem.
+ */
+struct ResumoOrdens {
+    static const int NUM_STATUS = 5;
+
+    long long contagemPorStatus[NUM_STATUS] = {0, 0, 0, 0, 0};
+    long long quantidadeTotal = 0;
+    Dinheiro valorTotal;              ///< Soma de quantidade * valor unitário de todas as ordens
+    Dinheiro valorTotalAprovado;      ///< Mesma soma restrita às ordens APROVADAS
+    size_t totalOrdens = 0;
+
+    long long contagem(StatusOrdem s) const { return contagemPorStatus[static_cast<int>(s)]; }
+
+    // Combina o resultado de outra partição (varredura paralela)
+    void acumular(const ResumoOrdens& outro) {
+        for (int i = 0; i < NUM_STATUS; i++) contagemPorStatus[i] += outro.contagemPorStatus[i];
+        quantidadeTotal += outro.quantidadeTotal;
+        valorTotal += outro.valorTotal;
+        valorTotalAprovado += outro.valorTotalAprovado;
+        totalOrdens += outro.totalOrdens;
+    }
+};
+
+/*
+ * Armazenamento colunar (struct-of-arrays) das ordens de compra.
+ * Cada campo numérico fica em um vetor próprio e contíguo, de modo que as
+ * varreduras de estatística percorrem só as colunas necessárias, sem arrastar
+ * vtable e strings de cada OrdemCompra pela cache. A linha i corresponde à
+ * i-ésima ordem registrada; OrdemCompra continua sendo o tipo de visão.
+ * Não é thread-safe: quem a possui deve protegê-la com o próprio mutex.
+ */
+class TabelaOrdens {
+public:
+    static constexpr int64_t SEM_DATA = DataHora::SEM_DATA;
+
+private:
+    std::vector<int32_t> ids;
+    std::vector<int32_t> itens;
+    std::vector<int32_t> fornecedores;
+    std::vector<int32_t> quantidades;
+    std::vector<int64_t> valoresUnitarios;  ///< Centavos
+    std::vector<uint8_t> status;
+    std::vector<int64_t> datasSolicitacao;  ///< Epoch da solicitação
+    std::vector<int64_t> datasChegada;      ///< Epoch da chegada prevista (SEM_DATA se não informada)
+
+public:
+    // Acrescenta uma ordem como nova linha da tabela
+    void adicionar(const OrdemCompra& o) {
+        ids.push_back(o.getIdTransacao());
+        itens.push_back(o.getIdItem());
+        fornecedores.push_back(o.getIdFornecedor());
+        quantidades.push_back(o.getQuantidade());
+        valoresUnitarios.push_back(o.getValorUnitario().emCentavos());
+        status.push_back(static_cast<uint8_t>(o.getStatus()));
+        datasSolicitacao.push_back(o.getDataSolicitacaoEpoch());
+        datasChegada.push_back(o.getDataChegadaPrevistaEpoch());
+    }
+
+    void atualizarStatus(size_t linha, StatusOrdem novoStatus) {
+        status.at(linha) = static_cast<uint8_t>(novoStatus);
+    }
+
+    void limpar() {
+        ids.clear(); itens.clear(); fornecedores.clear(); quantidades.clear();
+        valoresUnitarios.clear(); status.clear(); datasSolicitacao.clear(); datasChegada.clear();
+    }
+
+    // Reconstrói a tabela inteira a partir de uma lista de ordens
+    void reconstruir(const ListaGenerica<OrdemCompra>& lista) {
+        limpar();
+        reservar(lista.obterTamanho());
+        for (size_t i = 0; i < lista.obterTamanho(); i++) adicionar(lista.obter(i));
+    }
+
+    void reservar(size_t n) {
+        ids.reserve(n); itens.reserve(n); fornecedores.reserve(n); quantidades.reserve(n);
+        valoresUnitarios.reserve(n); status.reserve(n); datasSolicitacao.reserve(n); datasChegada.reserve(n);
+    }
+
+    size_t tamanho() const { return ids.size(); }
+
+    // Soma as oito colunas; elementos = linhas
+    void medirMemoria(UsoMemoria& uso) const {
+        size_t elementosAntes = uso.elementos;
+        MemoriaEstimada::vetor(uso, ids); MemoriaEstimada::vetor(uso, itens);
+        MemoriaEstimada::vetor(uso, fornecedores); MemoriaEstimada::vetor(uso, quantidades);
+        MemoriaEstimada::vetor(uso, valoresUnitarios); MemoriaEstimada::vetor(uso, status);
+        MemoriaEstimada::vetor(uso, datasSolicitacao); MemoriaEstimada::vetor(uso, datasChegada);
+        uso.elementos = elementosAntes + ids.size();
+    }
+
+    // Acesso direto às colunas (somente leitura)
+    const std::vector<int32_t>& colunaIds() const { return ids; }
+    const std::vector<int32_t>& colunaItens() const { return itens; }
+    const std::vector<int32_t>& colunaFornecedores() const { return fornecedores; }
+    const std::vector<int32_t>& colunaQuantidades() const { return quantidades; }
+    const std::vector<int64_t>& colunaValoresUnitarios() const { return valoresUnitarios; }
+    const std::vector<uint8_t>& colunaStatus() const { return status; }
+    const std::vector<int64_t>& colunaDatasSolicitacao() const { return datasSolicitacao; }
+    const std::vector<int64_t>& colunaDatasChegada() const { return datasChegada; }
+
+    // Materializa a linha como uma OrdemCompra (visão).
+    // A chegada prevista volta formatada; textos livres não são guardados na tabela.
+    OrdemCompra obterOrdem(size_t linha) const {
+        std::string chegada = (datasChegada.at(linha) != SEM_DATA) ? DataHora::formatar(datasChegada[linha]) : "";
+        OrdemCompra o(ids[linha], itens[linha], quantidades[linha], Dinheiro::deCentavos(valoresUnitarios[linha]),
+                      fornecedores[linha], chegada, datasSolicitacao[linha]);
+        o.setStatus(static_cast<StatusOrdem>(status[linha]));
+        return o;
+    }
+
+    // Varre as linhas [inicio, fim) acumulando contagens e valores.
+    // Só toca as colunas de status, quantidade e valor unitário; as somas são
+    // inteiras (centavos), exatas e vetorizáveis. Um int64 de centavos comporta
+    // ~9e16 reais, então a soma de produtos int32 x int64 não é verificada aqui.
+    ResumoOrdens resumir(size_t inicio, size_t fim) const {
+        ResumoOrdens r;
+        if (fim > tamanho()) fim = tamanho();
+        const uint8_t* st = status.data();
+        const int32_t* qtd = quantidades.data();
+        const int64_t* valor = valoresUnitarios.data();
+        const uint8_t aprovado = static_cast<uint8_t>(StatusOrdem::APROVADO);
+
+        long long quantidadeTotal = 0;
+        int64_t valorTotal = 0, valorAprovado = 0;
+        for (size_t i = inicio; i < fim; i++) {
+            uint8_t s = st[i];
+            if (s < ResumoOrdens::NUM_STATUS) r.contagemPorStatus[s]++;
+            int64_t v = valor[i] * qtd[i];
+            quantidadeTotal += qtd[i];
+            valorTotal += v;
+            valorAprovado += (s == aprovado) ? v : 0;
+        }
+        r.quantidadeTotal = quantidadeTotal;
+        r.valorTotal = Dinheiro::deCentavos(valorTotal);
+        r.valorTotalAprovado = Dinheiro::deCentavos(valorAprovado);
+        r.totalOrdens = (fim > inicio) ? fim - inicio : 0;
+        return r;
+    }
+
+    ResumoOrdens resumir() const { return resumir(0, tamanho()); }
+};
+
+#endif // TABELA_ORDENS_H
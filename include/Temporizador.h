@@ -0,0 +1,120 @@
+#ifndef TEMPORIZADOR_H
+#define TEMPORIZADOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * Agenda funções para rodar depois de um intervalo, numa única thread própria.
+ * Usado pelos prazos e esperas entre tentativas das chamadas remotas: em vez de
+ * uma thread dormir até o prazo, a ação fica agendada e ninguém é bloqueado.
+ * As funções agendadas devem ser curtas (normalmente só enfileiram trabalho num
+ * executor) e rodam sem o mutex do temporizador, podendo agendar ou cancelar outras.
+ * Ações ainda pendentes ao parar são descartadas.
+ */
+class Temporizador {
+public:
+    using Identificador = uint64_t;
+
+private:
+    using Relogio = std::chrono::steady_clock;
+    using Chave = std::pair<Relogio::time_point, Identificador>;
+
+    mutable std::mutex mutex;
+    std::condition_variable mudou;
+    std::map<Chave, std::function<void()>> agenda;               ///< Por vencimento (e ordem de agendamento)
+    std::unordered_map<Identificador, Relogio::time_point> vencimentoPorId;
+    Identificador proximoId = 1;
+    bool parando = false;
+    std::thread thread;
+
+    void laco() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!parando) {
+            if (agenda.empty()) {
+                mudou.wait(lock);
+                continue;
+            }
+            auto it = agenda.begin();
+            if (Relogio::now() < it->first.first) {
+                mudou.wait_until(lock, it->first.first);
+                continue;
+            }
+            std::function<void()> acao = std::move(it->second);
+            vencimentoPorId.erase(it->first.second);
+            agenda.erase(it);
+            lock.unlock();
+            try {
+                acao();
+            } catch (...) {
+                // Uma ação que lança não derruba a thread das demais
+            }
+            lock.lock();
+        }
+    }
+
+public:
+    Temporizador() : thread(&Temporizador::laco, this) {}
+
+    ~Temporizador() { parar(); }
+
+    Temporizador(const Temporizador&) = delete;
+    Temporizador& operator=(const Temporizador&) = delete;
+
+    // Descarta as ações pendentes e encerra a thread (não chamar de dentro de uma ação)
+    void parar() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (parando) return;
+            parando = true;
+            agenda.clear();
+            vencimentoPorId.clear();
+        }
+        mudou.notify_all();
+        thread.join();
+    }
+
+    // Roda 'acao' daqui a 'duracao'; o identificador serve para cancelar.
+    // Depois de parar(), a ação é descartada na hora.
+    template <typename Rep, typename Period>
+    Identificador agendar(std::chrono::duration<Rep, Period> duracao, std::function<void()> acao) {
+        Relogio::time_point vencimento = Relogio::now() + std::chrono::duration_cast<Relogio::duration>(duracao);
+        Identificador id;
+        bool primeiro;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = proximoId++;
+            if (parando) return id;
+            agenda.emplace(Chave(vencimento, id), std::move(acao));
+            vencimentoPorId[id] = vencimento;
+            primeiro = agenda.begin()->first.second == id;
+        }
+        // Só o novo primeiro da fila muda o próximo despertar da thread
+        if (primeiro) mudou.notify_all();
+        return id;
+    }
+
+    // Cancela uma ação ainda não iniciada; devolve false se ela já rodou (ou está rodando)
+    bool cancelar(Identificador id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = vencimentoPorId.find(id);
+        if (it == vencimentoPorId.end()) return false;
+        agenda.erase(Chave(it->second, id));
+        vencimentoPorId.erase(it);
+        return true;
+    }
+
+    size_t pendentes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return agenda.size();
+    }
+};
+
+#endif // TEMPORIZADOR_H
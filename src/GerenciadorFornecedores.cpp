@@ -1,5 +1,7 @@
 #include "GerenciadorFornecedores.h"
 #include <iostream>
+#include <sstream>
+#include "RegistroLog.h"
 
 // Construtor da classe GerenciadorFornecedores.
 // Inicializa o contador de IDs (proximoId) com 1.
@@ -15,7 +17,7 @@ int GerenciadorFornecedores::adicionar(const std::string& nome,
                                        const std::string& endereco,
                                        const std::string& cnpj,
                                        const std::string& produto,
-                                       double precoProduto) {
+                                       Dinheiro precoProduto) {
     // Validação dos dados de entrada: verifica se campos obrigatórios estão vazios.
     if (nome.empty() || cnpj.empty() || produto.empty()) {
         // Lança uma exceção personalizada se a validação falhar.
@@ -24,7 +26,7 @@ int GerenciadorFornecedores::adicionar(const std::string& nome,
 
     // Adquire o lock do mutex para garantir segurança em ambiente multithread.
     // Impede que dois fornecedores sejam adicionados simultaneamente, o que corromperia a lista.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
 
     // Cria o objeto Fornecedor com os dados fornecidos e o ID atual.
     Fornecedor novoFornecedor(nome, endereco, cnpj, proximoId, produto, precoProduto);
@@ -36,45 +38,50 @@ int GerenciadorFornecedores::adicionar(const std::string& nome,
     // Incrementa o contador para o próximo cadastro.
     proximoId++;
 
-    // Exibe confirmação no console.
-    std::cout << "Fornecedor #" << idAtribuido << " adicionado com sucesso!\n";
+    // Registra a confirmação no log.
+    LOG_INFO("FORNECEDORES", "Fornecedor adicionado idFornecedor=" << idAtribuido);
     // Retorna o ID gerado.
     return idAtribuido;
 }
 
 // Método para listar apenas fornecedores que vendem um determinado produto.
 void GerenciadorFornecedores::listarPorProduto(const std::string& produto) const {
-    // Protege a leitura da lista com mutex.
-    std::lock_guard<std::mutex> lock(mutex);
-    bool encontrou = false; // Flag para saber se achamos pelo menos um.
-
-    // Percorre toda a lista de fornecedores.
-    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
-        // Compara o produto do fornecedor atual com o produto buscado.
-        if (fornecedores.obter(i).getProduto() == produto) {
-            // Se bater, exibe os detalhes.
-            std::cout << fornecedores.obter(i).exibirDetalhes() << "\n";
-            encontrou = true;
+    // O texto é montado sob o mutex (leitura consistente) e escrito no terminal depois de liberá-lo.
+    std::ostringstream os;
+    {
+        GuardaMutex lock(mutex);
+        bool encontrou = false; // Flag para saber se achamos pelo menos um.
+
+        // Percorre toda a lista de fornecedores.
+        for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
+            // Compara o produto do fornecedor atual com o produto buscado.
+            if (fornecedores.obter(i).getProduto() == produto) {
+                // Se bater, exibe os detalhes.
+                os << fornecedores.obter(i).exibirDetalhes() << "\n";
+                encontrou = true;
+            }
+        }
+        // Se percorreu tudo e não achou nada, avisa o usuário.
+        if (!encontrou) {
+            os << "Nenhum fornecedor cadastrado para o produto: " << produto << "\n";
         }
     }
-    // Se percorreu tudo e não achou nada, avisa o usuário.
-    if (!encontrou) {
-        std::cout << "Nenhum fornecedor cadastrado para o produto: " << produto << "\n";
-    }
+    std::cout << os.str();
 }
 
 // Método para listar fornecedores ordenados do mais caro para o mais barato (decrescente).
 void GerenciadorFornecedores::listarOrdenadoPorPreco() const {
-    // Protege a operação com mutex.
-    std::lock_guard<std::mutex> lock(mutex);
-
     // Cria um vetor temporário (std::vector) para fazer a ordenação.
     // Isso é necessário porque a ListaGenerica pode não ter método de ordenação nativo exposto.
     std::vector<Fornecedor> copia;
 
-    // Copia todos os elementos da lista original para o vetor temporário.
-    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
-        copia.push_back(fornecedores.obter(i));
+    // Só a cópia precisa do mutex: a ordenação e a escrita trabalham sobre ela.
+    {
+        GuardaMutex lock(mutex);
+        copia.reserve(fornecedores.obterTamanho());
+        for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
+            copia.push_back(fornecedores.obter(i));
+        }
     }
 
     // Usa std::sort da biblioteca padrão para ordenar o vetor.
@@ -83,37 +90,42 @@ void GerenciadorFornecedores::listarOrdenadoPorPreco() const {
         return a.getPrecoProduto() > b.getPrecoProduto();
     });
 
-    // Exibe os fornecedores já na ordem correta.
+    // Exibe os fornecedores já na ordem correta, numa única escrita.
+    std::ostringstream os;
     for (const auto& f : copia) {
-        std::cout << f.exibirDetalhes() << "\n";
+        os << f.exibirDetalhes() << "\n";
     }
+    std::cout << os.str();
 }
 
 // Método padrão para listar todos os fornecedores na ordem de cadastro.
 void GerenciadorFornecedores::listar() const {
-    // Protege o acesso à lista.
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // Verifica se a lista está vazia para dar feedback rápido.
-    if (fornecedores.estaVazia()) {
-        std::cout << "Nenhum fornecedor cadastrado.\n";
-        return;
-    }
-
-    std::cout << "\nLISTA DE FORNECEDORES CADASTRADOS\n";
-    std::cout << "==================================\n";
-
-    // Itera e exibe cada fornecedor.
-    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
-        std::cout << "\n" << fornecedores.obter(i).exibirDetalhes() << "\n";
+    // Como em GerenciadorOrdens::listar: monta sob o mutex, escreve depois de liberá-lo.
+    std::ostringstream os;
+    {
+        GuardaMutex lock(mutex);
+
+        // Verifica se a lista está vazia para dar feedback rápido.
+        if (fornecedores.estaVazia()) {
+            os << "Nenhum fornecedor cadastrado.\n";
+        } else {
+            os << "\nLISTA DE FORNECEDORES CADASTRADOS\n";
+            os << "==================================\n";
+
+            // Itera e exibe cada fornecedor.
+            for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
+                os << "\n" << fornecedores.obter(i).exibirDetalhes() << "\n";
+            }
+            os << "\n";
+        }
     }
-    std::cout << "\n";
+    std::cout << os.str();
 }
 
 // Busca um fornecedor pelo ID e retorna um ponteiro para ele.
 Fornecedor* GerenciadorFornecedores::buscarPorId(int id) {
     // Protege o acesso à lista.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
 
     // Itera sobre a lista procurando o ID.
     for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
@@ -126,17 +138,38 @@ Fornecedor* GerenciadorFornecedores::buscarPorId(int id) {
     return nullptr;
 }
 
+// Verifica sob o mutex se há fornecedor com o ID (sem expor ponteiro para a lista).
+bool GerenciadorFornecedores::existe(int id) const {
+    GuardaMutex lock(mutex);
+    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
+        if (fornecedores.obter(i).getId() == id) return true;
+    }
+    return false;
+}
+
+// Copia o fornecedor sob o mutex (a lista pode crescer e realocar em outra thread).
+bool GerenciadorFornecedores::copiarPorId(int id, Fornecedor& destino) const {
+    GuardaMutex lock(mutex);
+    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
+        if (fornecedores.obter(i).getId() == id) {
+            destino = fornecedores.obter(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 // Remove um fornecedor da lista com base no ID.
 void GerenciadorFornecedores::remover(int id) {
     // Protege a operação de escrita na lista.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
 
     // Procura o fornecedor na lista.
     for (size_t i = 0; i < fornecedores.obterTamanho(); i++) {
         if (fornecedores.obter(i).getId() == id) {
             // Se encontrar, remove o item na posição 'i'.
             fornecedores.remover(i);
-            std::cout << "Fornecedor #" << id << " removido com sucesso!\n";
+            LOG_INFO("FORNECEDORES", "Fornecedor removido idFornecedor=" << id);
             return;
         }
     }
@@ -148,7 +181,7 @@ void GerenciadorFornecedores::remover(int id) {
 // Retorna a quantidade total de fornecedores cadastrados.
 size_t GerenciadorFornecedores::obterQuantidade() const {
     // Protege a leitura.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
     return fornecedores.obterTamanho();
 }
 
@@ -157,12 +190,21 @@ const ListaGenerica<Fornecedor>& GerenciadorFornecedores::obterLista() const {
     return fornecedores;
 }
 
+// Estima os bytes da lista de fornecedores, incluindo os textos que não cabem no SSO.
+void GerenciadorFornecedores::medirMemoria(std::vector<UsoMemoria>& destino) const {
+    GuardaMutex lock(mutex);
+    UsoMemoria uso("fornecedores");
+    MemoriaEstimada::vetor(uso, fornecedores.obterVetor());
+    for (size_t i = 0; i < fornecedores.obterTamanho(); i++) uso.bytesTexto += fornecedores.obter(i).bytesTexto();
+    destino.push_back(uso);
+}
+
 // Método usado para carregar dados do disco (Persistência).
 // Substitui a lista atual pela lista carregada e atualiza o contador de IDs.
 void GerenciadorFornecedores::carregarDeLista(const ListaGenerica<Fornecedor>& lista,
                                               int proximoIdArmazenado) {
     // Protege a escrita total da lista.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
 
     // Substituição direta da lista.
     fornecedores = lista;
@@ -1,258 +1,572 @@
 #include "GerenciadorOrdens.h"
-#include <iomanip>
+#include <chrono>
 #include <iostream>
+#include <sstream>
+#include "RastreamentoEtapas.h"
+#include "RegistroLog.h"
+
+namespace {
+
+// Resultado de uma chamada de integração já concluída, com a duração desde 'inicio'.
+// Exceções lançadas pelo módulo são convertidas em falha com a mensagem correspondente.
+ResultadoIntegracao avaliarIntegracao(const std::string& nome, const Futuro<bool>& resposta,
+                                      std::chrono::steady_clock::time_point inicio) {
+    ResultadoIntegracao r;
+    r.nome = nome;
+    try {
+        r.sucesso = resposta.obter();
+        if (!r.sucesso) r.erro = "modulo retornou falha";
+    } catch (const std::exception& e) {
+        r.sucesso = false;
+        r.erro = e.what();
+    } catch (...) {
+        r.sucesso = false;
+        r.erro = "excecao desconhecida";
+    }
+    r.duracaoMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    return r;
+}
+
+// IDs das ordens que já passaram da aprovação (aprovadas, enviadas ou entregues)
+std::vector<int> idsAprovadas(const ListaGenerica<OrdemCompra>& ordens) {
+    std::vector<int> ids;
+    for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+        StatusOrdem s = ordens.obter(i).getStatus();
+        if (s != StatusOrdem::PENDENTE && s != StatusOrdem::REJEITADO) ids.push_back(ordens.obter(i).getIdTransacao());
+    }
+    return ids;
+}
+
+} // namespace
 
 // Construtor da classe GerenciadorOrdens.
 // Inicializa o contador de IDs (proximoId) começando em 1.
-GerenciadorOrdens::GerenciadorOrdens() : proximoId(1) {
+GerenciadorOrdens::GerenciadorOrdens(const ConfiguracaoCompras& config) : proximoId(1) {
     // Inicializa o módulo financeiro simulado (Mock) usando ponteiro inteligente (unique_ptr).
     modulo_financeiro = std::make_unique<FinanceiroMock>();
     // Inicializa o módulo de produção simulado (Mock).
     modulo_producao = std::make_unique<ProducaoMock>();
     // Inicializa o módulo de estoque simulado (Mock).
     modulo_estoque = std::make_unique<EstoqueMock>();
+    // Latência simulada dos três módulos (padrão: as faixas originais de cada operação).
+    modulo_financeiro->configurarLatencia(config.latenciaModulos);
+    modulo_producao->configurarLatencia(config.latenciaModulos);
+    modulo_estoque->configurarLatencia(config.latenciaModulos);
+    // Camada de resiliência entre o fluxo de aprovação e os módulos.
+    PoliticaResiliencia politica;
+    politica.prazo = std::chrono::milliseconds(config.prazoIntegracaoMs);
+    politica.tentativas = static_cast<int>(config.tentativasIntegracao);
+    politica.falhasParaAbrir = static_cast<int>(config.disjuntorFalhas);
+    politica.tempoAberto = std::chrono::milliseconds(config.disjuntorAbertoMs);
+    temporizador = std::make_unique<Temporizador>();
+    chamadasRemotas = std::make_unique<ExecutorIntegracao>(config.obterThreadsIntegracao());
+    financeiro = std::make_unique<FinanceiroResiliente>(*modulo_financeiro, politica, *chamadasRemotas, *temporizador);
+    producao = std::make_unique<ProducaoResiliente>(*modulo_producao, politica, *chamadasRemotas, *temporizador);
+    estoque = std::make_unique<EstoqueResiliente>(*modulo_estoque, politica, *chamadasRemotas, *temporizador);
+    // Threads persistentes compartilhadas por todas as chamadas aos módulos acima.
+    executor = std::make_unique<ExecutorIntegracao>(config.obterThreadsIntegracao());
+    // Efeitos das ordens aprovadas: recupera o que ficou pendente no log e entrega em segundo plano.
+    caixaSaida = std::make_unique<CaixaSaida>(config.arquivoCaixaSaida,
+                                              [this](const EventoSaida& e) { return entregarEvento(e); });
+    // Estratégia de verificação de verba (ver ModoVerba).
+    if (config.modoVerba == ModoVerba::RAZAO) {
+        // Renova quando sobrar menos de um quarto da concessão.
+        razaoOrcamento = std::make_unique<RazaoOrcamento>(*financeiro, *executor,
+                                                          config.concessaoRazao, config.concessaoRazao / 4);
+    } else if (config.modoVerba == ModoVerba::LOTE && config.janelaLoteVerbaMs > 0) {
+        agrupadorVerba = std::make_unique<AgrupadorVerba>(*financeiro, *executor,
+                                                          std::chrono::milliseconds(config.janelaLoteVerbaMs),
+                                                          config.tamanhoMaximoLoteVerba);
+    }
 }
 
-// Destrutor: Não precisa fazer nada manual pois os unique_ptr limpam a memória automaticamente.
-GerenciadorOrdens::~GerenciadorOrdens() {}
+// Destrutor: os unique_ptr limpam a memória automaticamente, na ordem inversa da declaração.
+// Antes disso, espera o que ainda aguarda resposta remota (ninguém fica bloqueado nessas
+// respostas, então nada mais garante que tenham chegado): as ordens em curso, as entregas
+// da caixa de saída e a renovação da razão. Por fim para o temporizador, descartando
+// prazos de chamadas que ninguém mais espera.
+GerenciadorOrdens::~GerenciadorOrdens() {
+    {
+        std::unique_lock<std::mutex> lock(mutexEmCurso);
+        semOrdensEmCurso.wait(lock, [this] { return ordensEmCurso.empty(); });
+    }
+    if (caixaSaida) caixaSaida->parar();
+    if (razaoOrcamento) razaoOrcamento->aguardarRenovacao();
+    if (temporizador) temporizador->parar();
+}
+
+// Fim do fluxo de uma ordem (sob o mutex: o destrutor pode seguir assim que o conjunto esvaziar)
+void GerenciadorOrdens::encerrarOrdemEmCurso(int idOrdem) {
+    std::lock_guard<std::mutex> lock(mutexEmCurso);
+    ordensEmCurso.erase(idOrdem);
+    semOrdensEmCurso.notify_all();
+}
 
 // Método principal para criar uma nova ordem de compra.
 // Recebe os dados do item, quantidade, valor e fornecedor.
-int GerenciadorOrdens::criar(int idItem, int quantidade, double valorUnitario, int idFornecedor, const std::string& dataChegada) {
+// Versão síncrona: submete a ordem e espera a conclusão do fluxo de aprovação.
+// Retorna o ID se a ordem foi aprovada, ou -1 se foi rejeitada.
+int GerenciadorOrdens::criar(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor, const std::string& dataChegada) {
+    SubmissaoOrdem submissao = submeter(idItem, quantidade, valorUnitario, idFornecedor, dataChegada);
+    return (submissao.conclusao.obter() == StatusOrdem::APROVADO) ? submissao.idOrdem : -1;
+}
+
+// Aceita a ordem como PENDENTE e dispara o fluxo de aprovação no executor, sem esperar.
+// O fluxo tem duas fases curtas sob o mutex (registro como PENDENTE e efetivação do status);
+// as chamadas aos módulos externos acontecem fora do lock, encadeadas como continuações,
+// de modo que nenhuma thread fica parada esperando o financeiro (nem pelo prazo ou pela
+// espera entre tentativas, que são agendados no temporizador).
+SubmissaoOrdem GerenciadorOrdens::submeter(int idItem, int quantidade, Dinheiro valorUnitario, int idFornecedor,
+                                           const std::string& dataChegada) {
     // Validação básica: não permite criar pedidos com quantidade zero ou valor negativo.
-    if (quantidade <= 0 || valorUnitario < 0) {
+    if (quantidade <= 0 || valorUnitario < Dinheiro()) {
         // Lança exceção se os dados forem inválidos.
         throw ComprasException("Quantidade e valor devem ser positivos!");
     }
 
-    // Log para indicar o início da seção crítica.
-    std::cout << "Adquirindo lock para criar ordem...\n";
-
-    // Mecanismo de proteção de Thread (Mutex).
-    // O std::lock_guard tranca o 'mutex' aqui e o destranca automaticamente quando a função terminar.
-    // Isso impede que duas ordens sejam criadas exatamente ao mesmo tempo e corrompam a lista ou o ID.
-    std::lock_guard<std::mutex> lock(mutex);
-    std::cout << "Lock adquirido com sucesso.\n";
-
-    // Calcula o valor total do pedido.
-    double valorTotal = valorUnitario * quantidade;
-
-    // Cria o objeto OrdemCompra na memória temporária com status inicial PENDENTE.
-    OrdemCompra novaOrdem(proximoId, idItem, quantidade, valorUnitario, idFornecedor, dataChegada);
-    // Guarda o ID atual para uso posterior.
-    int idOrdemAtribuido = proximoId;
-
-    // Exibe detalhes da tentativa de criação no console.
-    std::cout << "\nCriando Ordem de Compra #" << idOrdemAtribuido << "\n";
-    std::cout << "   Item ID: " << idItem << " | Quantidade: " << quantidade
-              << " | Valor Total: R$ " << std::fixed << std::setprecision(2) << valorTotal << "\n\n";
-
-    // Variável para armazenar o resultado da verificação financeira.
-    bool verbaAprovada = false;
-
-    // Criação de uma THREAD secundária.
-    // A verificação de verba roda em paralelo para simular um processo externo demorado.
-    // Passa a função 'threadVerificarVerba', o ponteiro 'this' (para acessar métodos da classe),
-    // o valor a verificar e o endereço da variável onde o resultado será guardado.
-    std::thread threadFinanceiro(&GerenciadorOrdens::threadVerificarVerba, this,
-                                 valorTotal, &verbaAprovada);
-
-    // .join() força a thread principal a esperar a threadFinanceiro terminar antes de continuar.
-    // Isso sincroniza as threads.
-    threadFinanceiro.join();
-
-    std::cout << "\n";
-
-    // Verifica se a thread financeira retornou falso (verba negada).
-    if (!verbaAprovada) {
-        // Atualiza o status da ordem para REJEITADO.
-        novaOrdem.setStatus(StatusOrdem::REJEITADO);
-        // Salva na lista mesmo rejeitada, para histórico.
-        ordens.adicionar(novaOrdem);
-        // Incrementa o ID para a próxima ordem.
-        proximoId++;
-
-        // Log de rejeição.
-        std::cout << "Ordem #" << idOrdemAtribuido << " REJEITADA - Verba insuficiente.\n";
-        std::cout << "Lock liberado.\n\n";
-
-        // Retorna -1 indicando falha na criação.
-        return -1;
+    // Calcula o valor total do pedido (em centavos, sem erro de arredondamento).
+    Dinheiro valorTotal = valorUnitario * quantidade;
+
+    // Início da ordem: as etapas assíncronas abaixo medem a partir daqui.
+    auto inicio = RastreamentoEtapas::agora();
+
+    // ===== FASE 1: reserva do ID e registro como PENDENTE (lock curto) =====
+    int idOrdemAtribuido;
+    {
+        GuardaMutex lock(mutex);
+        MedidorEtapa medidor(Etapa::ORDEM_REGISTRO);
+        RastreamentoEtapas::instancia().registrarDesde(Etapa::ORDEM_ESPERA_LOCK, inicio);
+        idOrdemAtribuido = proximoId++;
+        // A ordem já fica visível (listagens, buscas) enquanto aguarda o financeiro.
+        registrarOrdem(OrdemCompra(idOrdemAtribuido, idItem, quantidade, valorUnitario, idFornecedor, dataChegada));
+        std::lock_guard<std::mutex> emCurso(mutexEmCurso);
+        ordensEmCurso.insert(idOrdemAtribuido);
     }
 
-    // Se passou pela verba, chama o módulo financeiro para autorizar o pagamento efetivo.
-    std::cout << "\n------ FINANCEIRO ------\n";
-    bool pagamentoAutorizado = modulo_financeiro->autorizarPagamento(idOrdemAtribuido);
-    std::cout << "------------------------\n\n";
+    LOG_INFO("COMPRAS", "Ordem criada (PENDENTE) idOrdem=" << idOrdemAtribuido << " idItem=" << idItem
+                        << " quantidade=" << quantidade << " valorTotal=" << valorTotal);
+    return SubmissaoOrdem{idOrdemAtribuido,
+                          aprovar(idOrdemAtribuido, idItem, quantidade, valorTotal, idFornecedor, inicio)};
+}
 
-    // Se o pagamento não foi autorizado (ex: cartão recusado, erro no banco).
-    if (!pagamentoAutorizado) {
-        // Marca como REJEITADO.
-        novaOrdem.setStatus(StatusOrdem::REJEITADO);
-        // Salva histórico.
-        ordens.adicionar(novaOrdem);
-        proximoId++;
+// Fases 2 e 3 de submeter(); também retoma as ordens PENDENTE órfãs encontradas em carregarDeLista().
+Futuro<StatusOrdem> GerenciadorOrdens::aprovar(int idOrdemAtribuido, int idItem, int quantidade, Dinheiro valorTotal,
+                                               int idFornecedor, std::chrono::steady_clock::time_point inicio) {
+    // ===== FASE 2: chamadas externas no executor, sem segurar o mutex do gerenciador =====
+    // A verba é reservada na razão local (normalmente sem chamada remota), ou vai para
+    // o lote aberto no agrupador, ou é verificada direto no financeiro. A autorização do
+    // pagamento é encadeada como continuação e só roda se houver verba. As respostas
+    // remotas voltam ao executor do fluxo. Falhas inesperadas dos módulos viram uma
+    // decisão de rejeição, para a ordem não ficar PENDENTE para sempre.
+    Futuro<bool> verba = razaoOrcamento ? razaoOrcamento->reservar(valorTotal)
+                       : agrupadorVerba ? agrupadorVerba->verificar(idOrdemAtribuido, valorTotal)
+                       : financeiro->verificarDisponibilidadeAssincrona(valorTotal).transferirPara(*executor);
+
+    return verba.quandoPronto([inicio](const Futuro<bool>& resposta) {
+            RastreamentoEtapas::instancia().registrarDesde(Etapa::ORDEM_VERIFICACAO_VERBA, inicio);
+            try {
+                return resposta.obter() ? DecisaoFinanceiro::APROVADA : DecisaoFinanceiro::VERBA_INSUFICIENTE;
+            } catch (const std::exception& e) {
+                LOG_ERRO("COMPRAS", "Falha na verificacao de verba: " << e.what());
+                return DecisaoFinanceiro::FALHA_MODULO;
+            }
+        })
+        .encadear([this, idOrdemAtribuido, valorTotal](DecisaoFinanceiro verba) {
+            if (verba != DecisaoFinanceiro::APROVADA) return futuroPronto(*executor, verba);
+            auto inicioAutorizacao = RastreamentoEtapas::agora();
+            return financeiro->autorizarPagamentoAssincrono(idOrdemAtribuido)
+                .transferirPara(*executor)
+                .quandoPronto([this, idOrdemAtribuido, valorTotal, inicioAutorizacao](const Futuro<bool>& resposta) {
+                    RastreamentoEtapas::instancia().registrarDesde(Etapa::ORDEM_AUTORIZACAO, inicioAutorizacao);
+                    DecisaoFinanceiro decisao;
+                    try {
+                        decisao = resposta.obter() ? DecisaoFinanceiro::APROVADA : DecisaoFinanceiro::PAGAMENTO_RECUSADO;
+                    } catch (const std::exception& e) {
+                        LOG_ERRO("COMPRAS", "Falha na autorizacao idOrdem=" << idOrdemAtribuido << ": " << e.what());
+                        decisao = DecisaoFinanceiro::FALHA_MODULO;
+                    }
+                    // Verba reservada na razão e não usada volta para o saldo local.
+                    if (decisao != DecisaoFinanceiro::APROVADA && razaoOrcamento) razaoOrcamento->devolver(valorTotal);
+                    return decisao;
+                });
+        })
+        // ===== FASE 3: notificações e efetivação do status =====
+        .entao([this, inicio, idOrdemAtribuido, idItem, quantidade, valorTotal, idFornecedor](DecisaoFinanceiro decisao) {
+            StatusOrdem status;
+            {
+                MedidorEtapa medidor(Etapa::ORDEM_FINALIZACAO);
+                status = finalizarOrdem(idOrdemAtribuido, decisao, idItem, quantidade, valorTotal, idFornecedor);
+            }
+            RastreamentoEtapas::instancia().registrarDesde(Etapa::ORDEM_TOTAL, inicio);
+            return status;
+        })
+        // Também em caso de erro: a ordem deixa de contar como em curso e o erro segue adiante
+        .quandoPronto([this, idOrdemAtribuido](const Futuro<StatusOrdem>& resultado) {
+            encerrarOrdemEmCurso(idOrdemAtribuido);
+            return resultado.obter();
+        });
+}
 
-        std::cout << "Ordem #" << idOrdemAtribuido << " REJEITADA - Falha na autorizacao.\n";
-        std::cout << "Lock liberado.\n\n";
+// Última etapa do fluxo (roda no executor): rejeita, ou aprova gravando os eventos na caixa de saída.
+StatusOrdem GerenciadorOrdens::finalizarOrdem(int idOrdem, DecisaoFinanceiro decisao, int idItem, int quantidade,
+                                              Dinheiro valorTotal, int idFornecedor) {
+    if (decisao != DecisaoFinanceiro::APROVADA) {
+        // Efetiva a rejeição (a ordem fica na lista para histórico).
+        concluirOrdem(idOrdem, StatusOrdem::REJEITADO);
+        const char* motivo = (decisao == DecisaoFinanceiro::VERBA_INSUFICIENTE) ? "Verba insuficiente"
+                           : (decisao == DecisaoFinanceiro::PAGAMENTO_RECUSADO) ? "Falha na autorizacao"
+                           : "Modulo financeiro indisponivel";
+        LOG_INFO("COMPRAS", "Ordem REJEITADA idOrdem=" << idOrdem << " motivo=\"" << motivo << "\"");
+        return StatusOrdem::REJEITADO;
+    }
 
-        return -1;
+    // Se tudo deu certo no financeiro, os avisos aos demais módulos vão para a caixa de
+    // saída junto com a aprovação e são entregues depois, em segundo plano: a conclusão
+    // da ordem não espera produção nem estoque, e uma falha deles não se perde.
+    std::vector<EventoSaida> eventos;
+    for (DestinoEvento destino : {DestinoEvento::CONTA_PAGAR, DestinoEvento::MATERIAL_COMPRADO,
+                                  DestinoEvento::PREVISAO_ENTREGA, DestinoEvento::ENTRADA_ESTOQUE}) {
+        EventoSaida e;
+        e.destino = destino;
+        e.idOrdem = idOrdem;
+        e.idItem = idItem;
+        e.quantidade = quantidade;
+        e.valorTotal = valorTotal;
+        e.idFornecedor = idFornecedor;
+        eventos.push_back(e);
+    }
+    // Aprovação e eventos vão para o disco (fsync) antes de o status mudar e fora do mutex
+    // do gerenciador, que fica só com a troca de status. Se a ordem sumir entre as duas
+    // etapas, a aprovação gravada não recupera nada ao recarregar (item e quantidade
+    // precisam conferir) e é descartada.
+    try {
+        caixaSaida->registrar(idOrdem, idItem, quantidade, eventos);
+    } catch (const std::exception& e) {
+        // Sem o registro durável dos efeitos a ordem não é aprovada.
+        LOG_ERRO("COMPRAS", "Ordem REJEITADA idOrdem=" << idOrdem << ": " << e.what());
+        if (razaoOrcamento) razaoOrcamento->devolver(valorTotal);
+        concluirOrdem(idOrdem, StatusOrdem::REJEITADO);
+        return StatusOrdem::REJEITADO;
+    }
+    if (!concluirOrdem(idOrdem, StatusOrdem::APROVADO)) {
+        // A ordem sumiu (dados recarregados no meio do fluxo): a verba volta e quem espera
+        // o resultado não registra efeitos dela. Os eventos já gravados seguem sendo
+        // entregues; os destinos são chaveados pelo ID da ordem.
+        if (razaoOrcamento) razaoOrcamento->devolver(valorTotal);
+        LOG_AVISO("COMPRAS", "Aprovacao descartada, ordem inexistente idOrdem=" << idOrdem << " valorTotal=" << valorTotal);
+        return StatusOrdem::REJEITADO;
     }
 
-    // Se tudo deu certo no financeiro, registra no financeiro como conta a pagar
-    std::cout << "\n------ FINANCEIRO - Registro de Conta ------\n";
-    // Data de vencimento simulada: 30 dias após a compra
-    modulo_financeiro->registrarContaPagar(idOrdemAtribuido, valorTotal, 
-                                          "Fornecedor #" + std::to_string(idFornecedor), 
-                                          "30 dias");
-    std::cout << "--------------------------------------------\n\n";
-
-    // Notifica a produção que o material foi comprado
-    std::cout << "------ PRODUCAO - Notificacao --------\n";
-    modulo_producao->notificarMaterialComprado(idItem);
-    std::cout << "--------------------------------------\n\n";
-
-    // Atualiza a previsão de entrega para a produção
-    std::cout << "------ PRODUCAO - Previsao Entrega --------\n";
-    modulo_producao->atualizarPrevisaoEntrega(idOrdemAtribuido, "7-10 dias úteis");
-    std::cout << "-------------------------------------------\n\n";
-
-    // Registra a entrada do material no estoque quando a compra é aprovada
-    std::cout << "------ ESTOQUE - Entrada de Compra --------\n";
-    modulo_estoque->registrarEntradaCompra(idItem, quantidade, idOrdemAtribuido);
-    std::cout << "-------------------------------------------\n\n";
-
-    // Finalmente, marca a ordem como APROVADA.
-    novaOrdem.setStatus(StatusOrdem::APROVADO);
-    // Adiciona à lista oficial.
-    ordens.adicionar(novaOrdem);
-    // Prepara o ID para a próxima chamada.
-    proximoId++;
-
-    // Exibe sucesso.
-    std::cout << "Ordem #" << idOrdemAtribuido << " APROVADA COM SUCESSO!\n";
-    std::cout << "   Status: APROVADO\n";
-    std::cout << "   Valor Total: R$ " << std::fixed << std::setprecision(2) << valorTotal << "\n";
-    std::cout << "Lock liberado.\n\n";
-
-    // Retorna o ID da ordem criada com sucesso.
-    return idOrdemAtribuido;
+    LOG_INFO("COMPRAS", "Ordem APROVADA idOrdem=" << idOrdem << " valorTotal=" << valorTotal);
+    return StatusOrdem::APROVADO;
 }
 
-// Função executada pela thread secundária para verificar verba.
-void GerenciadorOrdens::threadVerificarVerba(double valor, bool* resultado) {
-    std::cout << "\n------ FINANCEIRO ------\n";
-    // Exibe o ID da thread atual para demonstrar que é diferente da thread principal.
-    std::cout << "Thread de Financeiro iniciada (ID: " << std::this_thread::get_id() << ")\n";
+// Inicia a entrega de um evento da caixa de saída ao módulo de destino. Todas as operações
+// de destino são idempotentes por ordem, então um evento entregue duas vezes (queda entre
+// a entrega e a marca no log) não duplica o efeito. false = a caixa tenta de novo depois.
+Futuro<bool> GerenciadorOrdens::entregarEvento(const EventoSaida& e) {
+    auto inicio = RastreamentoEtapas::agora();
+    std::string nome;
+    Futuro<bool> chamada;
+    switch (e.destino) {
+        case DestinoEvento::CONTA_PAGAR:
+            // Vencimento simulado: 30 dias
+            nome = "financeiro.registrarContaPagar";
+            chamada = financeiro->registrarContaPagarAssincrono(e.idOrdem, e.valorTotal,
+                                                                "Fornecedor #" + std::to_string(e.idFornecedor),
+                                                                "30 dias");
+            break;
+        case DestinoEvento::MATERIAL_COMPRADO:
+            nome = "producao.notificarMaterialComprado";
+            chamada = producao->notificarMaterialCompradoAssincrono(e.idItem, e.idOrdem);
+            break;
+        case DestinoEvento::PREVISAO_ENTREGA:
+            nome = "producao.atualizarPrevisaoEntrega";
+            chamada = producao->atualizarPrevisaoEntregaAssincrona(e.idOrdem, "7-10 dias úteis");
+            break;
+        case DestinoEvento::ENTRADA_ESTOQUE:
+            nome = "estoque.registrarEntradaCompra";
+            chamada = estoque->registrarEntradaCompraAssincrona(e.idItem, e.quantidade, e.idOrdem);
+            break;
+    }
+    if (!chamada.valido()) throw ComprasException("Destino de evento desconhecido na caixa de saida!");
+    return chamada.quandoPronto([e, nome, inicio](const Futuro<bool>& resposta) {
+        RastreamentoEtapas::instancia().registrarDesde(Etapa::CAIXA_SAIDA_ENTREGA, inicio);
+        ResultadoIntegracao r = avaliarIntegracao(nome, resposta, inicio);
+        if (!r.sucesso) {
+            LOG_AVISO("CAIXA_SAIDA", "Entrega falhou, nova tentativa mais tarde idOrdem=" << e.idOrdem << " chamada="
+                                     << r.nome << " duracaoMs=" << static_cast<long long>(r.duracaoMs)
+                                     << " erro=\"" << r.erro << "\"");
+        }
+        return r.sucesso;
+    });
+}
 
-    // Chama a lógica do mock financeiro e salva o retorno no ponteiro 'resultado'.
-    *resultado = modulo_financeiro->verificarDisponibilidade(valor);
+// Efetiva o status final de uma ordem registrada como PENDENTE na fase 1.
+// Atualiza a lista, a tabela colunar e a projeção de estoque sob o mutex.
+// Retorna false se a ordem não existir mais (ex: dados recarregados no meio do fluxo).
+bool GerenciadorOrdens::concluirOrdem(int idOrdem, StatusOrdem novoStatus) {
+    GuardaMutex lock(mutex);
+    auto it = linhaPorId.find(idOrdem);
+    if (it == linhaPorId.end()) {
+        LOG_AVISO("COMPRAS", "Ordem nao encontrada ao concluir (dados recarregados?) idOrdem=" << idOrdem);
+        return false;
+    }
+    OrdemCompra& ordem = ordens.obterMutavel(it->second);
+    StatusOrdem antigo = ordem.getStatus();
+    ordem.setStatus(novoStatus);
+    tabela.atualizarStatus(it->second, novoStatus);
+    projecaoEstoque.alterarStatus(ordem.getIdItem(), ordem.getQuantidade(), antigo, novoStatus);
+    return true;
+}
 
-    std::cout << "Thread de Financeiro finalizada\n";
-    std::cout << "------------------------\n";
+// Adiciona a ordem à lista, à tabela colunar e atualiza a projeção de estoque.
+// Deve ser chamada com o mutex já adquirido.
+void GerenciadorOrdens::registrarOrdem(const OrdemCompra& ordem) {
+    size_t linha = ordens.obterTamanho();
+    ordens.adicionar(ordem);
+    linhaPorId[ordem.getIdTransacao()] = linha;
+    indiceSolicitacao.adicionar(ordem.getDataSolicitacaoEpoch(), ordem.getIdTransacao(), linha);
+    if (ordem.getDataChegadaPrevistaEpoch() != DataHora::SEM_DATA) {
+        indiceChegada.adicionar(ordem.getDataChegadaPrevistaEpoch(), ordem.getIdTransacao(), linha);
+    }
+    tabela.adicionar(ordem);
+    projecaoEstoque.registrarOrdem(ordem.getIdItem(), ordem.getQuantidade(), ordem.getStatus());
 }
 
 // Método para listar todas as ordens cadastradas.
 void GerenciadorOrdens::listar() const {
-    // Protege a leitura da lista com mutex para evitar leitura enquanto outra thread escreve.
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // Verifica se a lista está vazia.
-    if (ordens.estaVazia()) {
-        std::cout << "Nenhuma ordem de compra cadastrada.\n";
-        return;
-    }
-
-    std::cout << "\nLISTA DE ORDENS DE COMPRA\n";
-    std::cout << "========================\n";
-
-    // Itera sobre a lista e exibe os detalhes de cada ordem.
-    for (size_t i = 0; i < ordens.obterTamanho(); i++) {
-        std::cout << "\n" << ordens.obter(i).exibirDetalhes() << "\n";
+    // O texto é montado sob o mutex (leitura consistente) e escrito no terminal depois de liberá-lo.
+    std::ostringstream os;
+    {
+        GuardaMutex lock(mutex);
+
+        // Verifica se a lista está vazia.
+        if (ordens.estaVazia()) {
+            os << "Nenhuma ordem de compra cadastrada.\n";
+        } else {
+            os << "\nLISTA DE ORDENS DE COMPRA\n";
+            os << "========================\n";
+
+            // Itera sobre a lista e exibe os detalhes de cada ordem.
+            for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+                os << "\n" << ordens.obter(i).exibirDetalhes() << "\n";
+            }
+            os << "\n";
+        }
     }
-    std::cout << "\n";
+    std::cout << os.str();
 }
 
 // Busca uma ordem específica pelo ID.
 OrdemCompra* GerenciadorOrdens::buscarPorId(int id) {
     // Protege o acesso à lista.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
 
-    // Percorre a lista linearmente.
-    for (size_t i = 0; i < ordens.obterTamanho(); i++) {
-        // Se encontrar o ID correspondente...
-        if (ordens.obter(i).getIdTransacao() == id) {
-            // Retorna o endereço do objeto na lista (permitindo modificação se necessário).
-            return &ordens.obterMutavel(i);
-        }
+    // Consulta o mapa ID -> linha em vez de percorrer a lista.
+    auto it = linhaPorId.find(id);
+    if (it == linhaPorId.end()) {
+        // Retorna nulo se não encontrar.
+        return nullptr;
     }
-    // Retorna nulo se não encontrar.
-    return nullptr;
+    // Retorna o endereço do objeto na lista (permitindo modificação se necessário).
+    return &ordens.obterMutavel(it->second);
 }
 
 // Retorna o total de ordens cadastradas.
 size_t GerenciadorOrdens::obterQuantidade() const {
     // Protege a leitura do tamanho.
-    std::lock_guard<std::mutex> lock(mutex);
+    GuardaMutex lock(mutex);
     return ordens.obterTamanho();
 }
 
 // Calcula e exibe estatísticas gerais das compras.
 void GerenciadorOrdens::exibirEstatisticas() const {
-    // Protege o acesso para garantir consistência dos dados durante o cálculo.
-    std::lock_guard<std::mutex> lock(mutex);
+    // Varre apenas as colunas de status/quantidade/valor da tabela colunar (sob o mutex).
+    ResumoOrdens resumo = obterResumo();
 
     std::cout << "\nESTATISTICAS DO MODULO DE COMPRAS\n";
     std::cout << "==================================\n\n";
 
-    // Variáveis acumuladoras.
-    int aprovadas = 0, rejeitadas = 0, pendentes = 0;
-    double valorTotalAprovado = 0.0;
-
-    // Itera sobre todas as ordens para contabilizar.
-    for (size_t i = 0; i < ordens.obterTamanho(); i++) {
-        const auto& ordem = ordens.obter(i);
-        // Verifica o status de cada ordem.
-        switch (ordem.getStatus()) {
-            case StatusOrdem::APROVADO:
-                aprovadas++;
-                // Soma o valor apenas das aprovadas.
-                valorTotalAprovado += ordem.getValorTotal();
-                break;
-            case StatusOrdem::REJEITADO:
-                rejeitadas++;
-                break;
-            case StatusOrdem::PENDENTE:
-                pendentes++;
-                break;
-            default:
-                break;
-        }
-    }
+    long long aprovadas = resumo.contagem(StatusOrdem::APROVADO);
+    long long rejeitadas = resumo.contagem(StatusOrdem::REJEITADO);
+    long long pendentes = resumo.contagem(StatusOrdem::PENDENTE);
+    Dinheiro valorTotalAprovado = resumo.valorTotalAprovado;
 
     // Exibe os resultados calculados.
     std::cout << "Detalhes das Ordens:\n";
     std::cout << "  Aprovadas: " << aprovadas << "\n";
     std::cout << "  Rejeitadas: " << rejeitadas << "\n";
     std::cout << "  Pendentes: " << pendentes << "\n";
-    std::cout << "  Valor Total Aprovado: R$ " << std::fixed
-              << std::setprecision(2) << valorTotalAprovado << "\n\n";
+    std::cout << "  Valor Total Aprovado: R$ " << valorTotalAprovado << "\n\n";
+}
+
+// Retorna o resumo agregado das ordens (contagens por status e somas de valores).
+ResumoOrdens GerenciadorOrdens::obterResumo() const {
+    GuardaMutex lock(mutex);
+    return tabela.resumir();
+}
+
+// Consulta ordens por intervalo de datas usando busca binária no índice escolhido.
+// A página traz no máximo 'limite' ordens; 'apos' continua de uma página anterior.
+PaginaOrdens GerenciadorOrdens::consultarPorPeriodo(CampoData campo, int64_t de, int64_t ate,
+                                                    const CursorTemporal* apos, size_t limite) const {
+    GuardaMutex lock(mutex);
+    const IndiceTemporal& indice = (campo == CampoData::CHEGADA_PREVISTA) ? indiceChegada : indiceSolicitacao;
+
+    PaginaOrdens pagina;
+    auto entradas = indice.consultar(de, ate, apos, limite, pagina.temMais);
+    pagina.ordens.reserve(entradas.size());
+    for (const auto& e : entradas) {
+        pagina.ordens.push_back(ordens.obter(e.linha));
+    }
+    if (!entradas.empty()) {
+        pagina.proximo.epoch = entradas.back().epoch;
+        pagina.proximo.idOrdem = entradas.back().idOrdem;
+    }
+    return pagina;
 }
 
 // Retorna a lista completa (somente leitura).
 // Nota: Retorna uma referência constante, mas cuidado deve ser tomado se a lista for alterada externamente.
+// Retorna a lista sem adquirir o mutex: só é seguro enquanto nenhuma ordem estiver
+// em processamento. Leituras concorrentes com o fluxo de aprovação usam comLista().
 const ListaGenerica<OrdemCompra>& GerenciadorOrdens::obterLista() const {
     return ordens;
 }
 
+// Copia a ordem sob o mutex (o status pode mudar a qualquer momento no executor).
+bool GerenciadorOrdens::copiarPorId(int id, OrdemCompra& destino) const {
+    GuardaMutex lock(mutex);
+    auto it = linhaPorId.find(id);
+    if (it == linhaPorId.end()) return false;
+    destino = ordens[it->second];
+    return true;
+}
+
 // Método usado para recarregar dados vindos do arquivo (Persistência).
 void GerenciadorOrdens::carregarDeLista(const ListaGenerica<OrdemCompra>& lista,
-                                        int proximoIdArmazenado) {
-    // Bloqueia o acesso durante a substituição completa dos dados.
-    std::lock_guard<std::mutex> lock(mutex);
-
-    // Substitui a lista atual pela lista carregada do arquivo.
-    ordens = lista;
-    // Restaura o contador de IDs para continuar de onde parou.
-    proximoId = proximoIdArmazenado;
+                                        int proximoIdArmazenado, const std::map<int, int>& ajustesEstoque) {
+    std::vector<OrdemCompra> orfas;
+    {
+        // Bloqueia o acesso durante a substituição completa dos dados.
+        GuardaMutex lock(mutex);
+
+        // Substitui a lista atual pela lista carregada do arquivo.
+        ordens = lista;
+        // Restaura o contador de IDs para continuar de onde parou.
+        proximoId = proximoIdArmazenado;
+        // Reconstrói a tabela colunar e os índices temporais com as ordens carregadas.
+        tabela.reconstruir(ordens);
+        indiceSolicitacao.limpar();
+        indiceChegada.limpar();
+        linhaPorId.clear();
+        indiceSolicitacao.reservar(ordens.obterTamanho());
+        for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+            const auto& o = ordens.obter(i);
+            linhaPorId[o.getIdTransacao()] = i;
+            indiceSolicitacao.acrescentarSemOrdenar(o.getDataSolicitacaoEpoch(), o.getIdTransacao(), i);
+            if (o.getDataChegadaPrevistaEpoch() != DataHora::SEM_DATA) {
+                indiceChegada.acrescentarSemOrdenar(o.getDataChegadaPrevistaEpoch(), o.getIdTransacao(), i);
+            }
+        }
+        indiceSolicitacao.ordenar();
+        indiceChegada.ordenar();
+        // Ordens salvas como PENDENTE cuja aprovação já estava na caixa de saída (queda entre
+        // a aprovação e a gravação do arquivo de ordens) voltam como APROVADO, desde que o
+        // item e a quantidade da aprovação sejam os da ordem. Só as aprovações usadas aqui
+        // continuam guardadas na caixa (até o próximo salvamento).
+        std::vector<int> recuperadas;
+        for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+            const auto& o = ordens.obter(i);
+            if (o.getStatus() == StatusOrdem::PENDENTE &&
+                caixaSaida->ordemAprovada(o.getIdTransacao(), o.getIdItem(), o.getQuantidade())) {
+                recuperadas.push_back(o.getIdTransacao());
+                ordens.obterMutavel(i).setStatus(StatusOrdem::APROVADO);
+                tabela.atualizarStatus(i, StatusOrdem::APROVADO);
+            }
+        }
+        caixaSaida->reconciliarComArquivo(recuperadas);
+        // A projeção de estoque passa a refletir as ordens e os ajustes carregados.
+        projecaoEstoque.reiniciar(ordens, ajustesEstoque);
+        // As demais PENDENTE sem fluxo em curso ficaram órfãs (queda antes da decisão do
+        // financeiro): são marcadas como em curso aqui, para uma recarga concorrente não
+        // as pegar de novo, e voltam ao fluxo de aprovação depois de soltar o mutex.
+        std::lock_guard<std::mutex> emCurso(mutexEmCurso);
+        for (size_t i = 0; i < ordens.obterTamanho(); i++) {
+            const auto& o = ordens.obter(i);
+            if (o.getStatus() == StatusOrdem::PENDENTE && ordensEmCurso.insert(o.getIdTransacao()).second) {
+                orfas.push_back(o);
+            }
+        }
+    }
+
+    // A autorização é idempotente por ordem, então reenviar uma ordem que já tinha
+    // sido autorizada antes da queda não gera um segundo pagamento.
+    for (const OrdemCompra& o : orfas) {
+        LOG_AVISO("COMPRAS", "Ordem PENDENTE sem decisao registrada, reenviada para aprovacao idOrdem="
+                             << o.getIdTransacao());
+        aprovar(o.getIdTransacao(), o.getIdItem(), o.getQuantidade(), o.getValorUnitario() * o.getQuantidade(),
+                o.getIdFornecedor(), RastreamentoEtapas::agora());
+    }
+}
+
+// Avisa a caixa de saída que 'salvas' (a lista que acabou de ir para o arquivo de
+// ordens) já registra estas aprovações, que não precisam mais ser guardadas no log.
+void GerenciadorOrdens::confirmarPersistencia(const ListaGenerica<OrdemCompra>& salvas) {
+    caixaSaida->confirmarPersistidas(idsAprovadas(salvas));
+}
+
+// Retorna a projeção de estoque atual (somente leitura).
+// Assim como obterLista(), o chamador deve serializar o acesso com as escritas.
+const ProjecaoEstoque& GerenciadorOrdens::obterProjecaoEstoque() const {
+    return projecaoEstoque;
+}
+
+// Aplica um ajuste manual na projeção (entrada de material ou reserva).
+void GerenciadorOrdens::ajustarProjecaoEstoque(int idItem, int delta) {
+    GuardaMutex lock(mutex);
+    projecaoEstoque.ajustar(idItem, delta);
+}
+
+// Estima a memória da lista de ordens e de cada estrutura derivada dela, sob o mutex.
+// Percorre as ordens para somar os textos: O(n), pensado para diagnóstico.
+void GerenciadorOrdens::medirMemoria(std::vector<UsoMemoria>& destino) const {
+    GuardaMutex lock(mutex);
+    UsoMemoria lista("ordens");
+    MemoriaEstimada::vetor(lista, ordens.obterVetor());
+    for (size_t i = 0; i < ordens.obterTamanho(); i++) lista.bytesTexto += ordens.obter(i).bytesTexto();
+    destino.push_back(lista);
+
+    UsoMemoria colunar("ordens.tabelaColunar", true);
+    tabela.medirMemoria(colunar);
+    destino.push_back(colunar);
+
+    UsoMemoria porSolicitacao("ordens.indiceSolicitacao", true);
+    indiceSolicitacao.medirMemoria(porSolicitacao);
+    destino.push_back(porSolicitacao);
+
+    UsoMemoria porChegada("ordens.indiceChegada", true);
+    indiceChegada.medirMemoria(porChegada);
+    destino.push_back(porChegada);
+
+    UsoMemoria porId("ordens.linhaPorId", true);
+    MemoriaEstimada::hash(porId, linhaPorId);
+    destino.push_back(porId);
+
+    UsoMemoria projecao("ordens.projecaoEstoque", true);
+    projecaoEstoque.medirMemoria(projecao);
+    destino.push_back(projecao);
+}
+
+// Compara a projeção incremental com uma reconstrução completa a partir das ordens.
+// Se 'reconstruirSeDivergente' for true e houver diferença, a projeção é refeita.
+bool GerenciadorOrdens::verificarProjecaoEstoque(std::vector<std::string>& divergencias,
+                                                 bool reconstruirSeDivergente) {
+    GuardaMutex lock(mutex);
+    bool consistente = projecaoEstoque.verificarConsistencia(ordens, divergencias);
+    if (!consistente && reconstruirSeDivergente) {
+        projecaoEstoque.reconstruir(ordens);
+    }
+    return consistente;
 }
\ No newline at end of file
@@ -1,28 +1,33 @@
 #include "ModuloCompras.h"
 #include <iostream>
+#include "RegistroLog.h"
 
 // Construtor da classe ModuloCompras.
 // É chamado automaticamente quando um objeto desta classe é criado.
-ModuloCompras::ModuloCompras() {
+ModuloCompras::ModuloCompras(const ConfiguracaoCompras& config) {
+    // Nível e formato do log valem para o processo todo (o log é único).
+    RegistroLog::instancia().configurar(config.nivelLog, config.formatoLog);
+
     // Inicializa o ponteiro único (unique_ptr) para o GerenciadorFornecedores.
     // std::make_unique cria uma nova instância da classe na memória heap de forma segura.
     gerenciadorFornecedores = std::make_unique<GerenciadorFornecedores>();
 
     // Inicializa o ponteiro único para o GerenciadorOrdens da mesma forma.
-    gerenciadorOrdens = std::make_unique<GerenciadorOrdens>();
+    // Recebe a configuração para dimensionar o executor de integrações.
+    gerenciadorOrdens = std::make_unique<GerenciadorOrdens>(config);
 
     // Inicializa o ponteiro único para a classe de Persistência (responsável por salvar/carregar arquivos).
     persistencia = std::make_unique<PersistenciaCompras>();
 
-    // Exibe uma mensagem no console confirmando que o módulo iniciou corretamente.
-    std::cout << "Modulo de Compras inicializado com sucesso!\n";
+    // Registra no log que o módulo iniciou corretamente.
+    LOG_INFO("COMPRAS", "Modulo de Compras inicializado com sucesso");
 }
 
 // Destrutor da classe ModuloCompras.
 // É chamado automaticamente quando o objeto é destruído (ex: ao fechar o programa).
 ModuloCompras::~ModuloCompras() {
     // Avisa o usuário que o processo de salvamento automático iniciou.
-    std::cout << "Salvando dados antes de encerrar...\n";
+    LOG_INFO("COMPRAS", "Salvando dados antes de encerrar");
 
     // Chama o método (provavelmente definido no .h ou em outra parte não mostrada aqui)
     // para salvar todos os dados atuais nos arquivos antes de limpar a memória.
@@ -31,6 +36,9 @@ ModuloCompras::~ModuloCompras() {
 
 // Método responsável por orquestrar o carregamento de dados dos arquivos para a memória do sistema.
 void ModuloCompras::carregarTodosDados() {
+    // Impede que um salvamento concorrente reescreva os arquivos durante a leitura.
+    GuardaMutex lock(mutexPersistencia);
+
     // Cria uma lista temporária para armazenar os fornecedores que virão do arquivo.
     ListaGenerica<Fornecedor> listaFornecedores;
     // Inicializa o contador de IDs de fornecedores (começa em 1 se o arquivo estiver vazio).
@@ -49,13 +57,17 @@ void ModuloCompras::carregarTodosDados() {
     // Atualiza 'proximoIdOrdem'.
     persistencia->carregarOrdens(listaOrdens, proximoIdOrdem);
 
+    // Entradas e reservas manuais do estoque, que as ordens sozinhas não reproduzem.
+    std::map<int, int> ajustesEstoque;
+    persistencia->carregarAjustesEstoque(ajustesEstoque);
+
     // Transfere os dados carregados na lista temporária para o gerenciador oficial de fornecedores.
     // O gerenciador passará a deter esses dados na memória durante a execução.
     gerenciadorFornecedores->carregarDeLista(listaFornecedores, proximoIdFornecedor);
 
     // Transfere os dados carregados para o gerenciador oficial de ordens.
-    gerenciadorOrdens->carregarDeLista(listaOrdens, proximoIdOrdem);
+    gerenciadorOrdens->carregarDeLista(listaOrdens, proximoIdOrdem, ajustesEstoque);
 
     // Informa ao usuário que todo o processo de carga foi concluído.
-    std::cout << "Dados carregados com sucesso!\n";
+    LOG_INFO("COMPRAS", "Dados carregados com sucesso");
 }
\ No newline at end of file
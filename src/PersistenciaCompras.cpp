@@ -1,10 +1,12 @@
 #include "PersistenciaCompras.h"
+#include "RegistroLog.h"
 
 // Construtor da classe: responsável por inicializar a instância com os caminhos dos arquivos.
 PersistenciaCompras::PersistenciaCompras(const std::string& caminhoForn,
-                                       const std::string& caminhoOrd)
+                                       const std::string& caminhoOrd,
+                                       const std::string& caminhoAjust)
     // Lista de inicialização: atribui os argumentos recebidos diretamente aos atributos da classe.
-    : caminhoFornecedores(caminhoForn), caminhoOrdens(caminhoOrd) {}
+    : caminhoFornecedores(caminhoForn), caminhoOrdens(caminhoOrd), caminhoAjustes(caminhoAjust) {}
 
 // Método para salvar a lista de fornecedores no arquivo físico.
 void PersistenciaCompras::salvarFornecedores(const ListaGenerica<Fornecedor>& lista) {
@@ -46,8 +48,8 @@ void PersistenciaCompras::salvarFornecedores(const ListaGenerica<Fornecedor>& li
                 << forn.getEndereco() << "|"
                 << forn.getCNPJ() << "|"
                 << forn.getProduto() << "|"
-                // Formata o preço com 2 casas decimais (ex: 10.50) e fixa a notação de ponto flutuante.
-                << std::fixed << std::setprecision(2) << forn.getPrecoProduto() << "\n";
+                // Preço em ponto fixo, sempre com 2 casas decimais (ex: 10.50).
+                << forn.getPrecoProduto() << "\n";
     }
 
     // Fecha o arquivo após terminar a escrita.
@@ -75,7 +77,7 @@ void PersistenciaCompras::carregarFornecedores(ListaGenerica<Fornecedor>& lista,
     // Se não conseguir abrir (arquivo não existe), avisa o usuário e encerra a função.
     // Não é um erro crítico, pois pode ser a primeira vez que o programa roda.
     if (!arquivo.is_open()) {
-        std::cout << "Arquivo de fornecedores nao existe (sera criado na proxima gravacao).\n";
+        LOG_AVISO("PERSISTENCIA", "Arquivo de fornecedores nao existe (sera criado na proxima gravacao)");
         return;
     }
 
@@ -99,16 +101,16 @@ void PersistenciaCompras::carregarFornecedores(ListaGenerica<Fornecedor>& lista,
         if (std::getline(iss, id_str, '|') &&
             std::getline(iss, nome, '|') &&
             std::getline(iss, endereco, '|') &&
-            std::getline(iss, cnpj)) {
+            std::getline(iss, cnpj, '|')) {
 
             // Converte o ID de string para inteiro.
             int id = std::stoi(id_str);
 
             // Lógica de compatibilidade: Tenta ler os campos novos (produto e preço).
-            if (std::getline(iss, produto, '|') && std::getline(iss, preco_str)) {
-                double preco = 0.0;
-                // Tenta converter o preço para double, com tratamento de erro básico.
-                try { preco = std::stod(preco_str); } catch (...) { preco = 0.0; }
+            if (std::getline(iss, produto, '|') && std::getline(iss, preco_str, '|')) {
+                // Converte o preço para centavos; valores inválidos viram zero.
+                Dinheiro preco;
+                if (!Dinheiro::parsear(preco_str, preco)) preco = Dinheiro();
 
                 // Cria o objeto Fornecedor usando o construtor completo (novo formato).
                 Fornecedor forn(nome, endereco, cnpj, id, produto, preco);
@@ -160,7 +162,7 @@ void PersistenciaCompras::salvarOrdens(const ListaGenerica<OrdemCompra>& lista)
         arquivo << ordem.getIdTransacao() << "|"
                 << ordem.getIdItem() << "|"
                 << ordem.getQuantidade() << "|"
-                << std::fixed << std::setprecision(2) << ordem.getValorUnitario() << "|"
+                << ordem.getValorUnitario() << "|"
                 << ordem.getIdFornecedor() << "|"
                 << static_cast<int>(ordem.getStatus()) << "|"
                 << ordem.getDataSolicitacao() << "|"
@@ -168,6 +170,10 @@ void PersistenciaCompras::salvarOrdens(const ListaGenerica<OrdemCompra>& lista)
     }
 
     arquivo.close();
+    // Quem salva conta com o arquivo completo (ex: a caixa de saída descarta aprovações)
+    if (arquivo.fail()) {
+        throw ComprasException("Erro ao gravar arquivo de ordens em " + abertoEm);
+    }
 }
 
 // Método para carregar as Ordens de Compra.
@@ -188,7 +194,7 @@ void PersistenciaCompras::carregarOrdens(ListaGenerica<OrdemCompra>& lista, int&
     }
     // Se não existir, avisa e retorna.
     if (!arquivo.is_open()) {
-        std::cout << "Arquivo de ordens nao existe (sera criado na proxima gravacao).\n";
+        LOG_AVISO("PERSISTENCIA", "Arquivo de ordens nao existe (sera criado na proxima gravacao)");
         return;
     }
 
@@ -223,20 +229,20 @@ void PersistenciaCompras::carregarOrdens(ListaGenerica<OrdemCompra>& lista, int&
             int id = std::stoi(id_str);
             int idItem = std::stoi(idItem_str);
             int quantidade = std::stoi(quantidade_str);
-            double valor = std::stod(valor_str);
+            Dinheiro valor = Dinheiro::deTexto(valor_str);
             int idForn = std::stoi(idForn_str);
             int status = std::stoi(status_str);
 
-            // Cria o objeto OrdemCompra com os dados lidos.
-            OrdemCompra ordem(id, idItem, quantidade, valor, idForn);
+            // Interpreta a data de solicitação original; se ausente/inválida, usa o instante atual.
+            int64_t solicitacao;
+            if (!DataHora::parsear(dataSolicitacao, solicitacao)) solicitacao = DataHora::agora();
+
+            // Cria o objeto OrdemCompra com os dados lidos (sem consultar o relógio/formatar datas).
+            OrdemCompra ordem(id, idItem, quantidade, valor, idForn, dataChegada, solicitacao);
 
             // Restaura o Status convertendo de int de volta para o Enum StatusOrdem.
             ordem.setStatus(static_cast<StatusOrdem>(status));
 
-            // Define a data de solicitação original (lida do arquivo) para não sobrescrever com a data atual.
-            if (!dataSolicitacao.empty()) ordem.setDataSolicitacao(dataSolicitacao);
-            if (!dataChegada.empty()) ordem.setDataChegadaPrevista(dataChegada);
-
             // Adiciona na lista em memória.
             lista.adicionar(ordem);
 
@@ -248,4 +254,72 @@ void PersistenciaCompras::carregarOrdens(ListaGenerica<OrdemCompra>& lista, int&
     }
 
     arquivo.close();
-}
\ No newline at end of file
+}
+
+// Método para salvar os ajustes manuais da projeção de estoque (mesmo esquema das ordens).
+void PersistenciaCompras::salvarAjustesEstoque(const std::map<int, int>& ajustes) {
+    std::vector<std::string> candidatos = {
+        caminhoAjustes,
+        std::string("../") + caminhoAjustes,
+        std::string("../../") + caminhoAjustes
+    };
+
+    std::ofstream arquivo;
+    std::string abertoEm;
+    for (const auto& c : candidatos) {
+        arquivo.open(c);
+        if (arquivo.is_open()) { abertoEm = c; break; }
+    }
+    if (!arquivo.is_open()) {
+        throw ComprasException("Erro ao abrir arquivo de ajustes de estoque em caminhos candidatos!");
+    }
+
+    arquivo << "IdItem|Ajuste\n";
+    for (const auto& kv : ajustes) {
+        // Ajustes que se anularam não precisam ir para o arquivo.
+        if (kv.second != 0) arquivo << kv.first << "|" << kv.second << "\n";
+    }
+
+    arquivo.close();
+    if (arquivo.fail()) {
+        throw ComprasException("Erro ao gravar arquivo de ajustes de estoque em " + abertoEm);
+    }
+}
+
+// Método para carregar os ajustes manuais da projeção de estoque.
+void PersistenciaCompras::carregarAjustesEstoque(std::map<int, int>& ajustes) {
+    std::vector<std::string> candidatos = {
+        caminhoAjustes,
+        std::string("../") + caminhoAjustes,
+        std::string("../../") + caminhoAjustes
+    };
+
+    std::ifstream arquivo;
+    for (const auto& c : candidatos) {
+        arquivo.open(c);
+        if (arquivo.is_open()) break;
+    }
+    // Sem arquivo (primeira execução ou dados anteriores a ele): nenhum ajuste.
+    if (!arquivo.is_open()) {
+        LOG_AVISO("PERSISTENCIA", "Arquivo de ajustes de estoque nao existe (sera criado na proxima gravacao)");
+        return;
+    }
+
+    std::string linha;
+    bool primeiraLinha = true;
+    while (std::getline(arquivo, linha)) {
+        // Pula cabeçalho.
+        if (primeiraLinha) {
+            primeiraLinha = false;
+            continue;
+        }
+
+        std::istringstream iss(linha);
+        std::string idItem_str, ajuste_str;
+        if (std::getline(iss, idItem_str, '|') && std::getline(iss, ajuste_str)) {
+            ajustes[std::stoi(idItem_str)] += std::stoi(ajuste_str);
+        }
+    }
+
+    arquivo.close();
+}
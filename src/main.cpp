@@ -2,6 +2,7 @@
 #include <string>
 #include <limits>
 #include <iomanip>
+#include <sstream>
 #include "ModuloCompras.h"
 
 // Funções auxiliares para a interface do console
@@ -43,7 +44,9 @@ void exibirMenu() {
     std::cout << "\n--- SISTEMA ---\n";
     std::cout << "14. Salvar Dados em Arquivo\n";
     std::cout << "15. Carregar Dados do Arquivo\n";
-    std::cout << "16. Sair\n";
+    std::cout << "16. Perfil de Contencao dos Locks\n";
+    std::cout << "17. Uso de Memoria por Colecao\n";
+    std::cout << "18. Sair\n";
     std::cout << "\n";
 }
 
@@ -63,16 +66,15 @@ int obterInteiro() {
     return valor;
 }
 
-// Função auxiliar robusta para ler números decimais (double).
-double obterDouble() {
-    double valor;
-    // Mesma lógica do obterInteiro: tenta ler, se falhar, limpa o erro e pede de novo.
-    while (!(std::cin >> valor)) {
+// Função auxiliar para ler valores monetários (ex: 10.50 ou 10,50) sem passar por double.
+Dinheiro obterDinheiro() {
+    std::string texto;
+    Dinheiro valor;
+    // Repete enquanto o texto digitado não for um valor válido.
+    while (!std::getline(std::cin, texto) || !Dinheiro::parsear(texto, valor)) {
         std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        std::cout << "Entrada invalida! Digite um numero: ";
+        std::cout << "Entrada invalida! Digite um valor (ex: 10.50): ";
     }
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     return valor;
 }
 
@@ -104,7 +106,7 @@ void menuCadastrarFornecedor(ModuloCompras& modulo) {
     std::string produto = obterString();
 
     std::cout << "Preço do produto (R$): ";
-    double precoProduto = obterDouble();
+    Dinheiro precoProduto = obterDinheiro();
 
     // Tenta realizar o cadastro no módulo de lógica.
     try {
@@ -136,7 +138,7 @@ void menuCriarOrdenCompra(ModuloCompras& modulo) {
     int idFornecedor = obterInteiro();
 
     // Verifica se o fornecedor existe antes de prosseguir.
-    if (modulo.buscarFornecedorPorId(idFornecedor) == nullptr) {
+    if (!modulo.fornecedorExiste(idFornecedor)) {
         std::cout << "Fornecedor nao encontrado!\n";
         std::cout << "Pressione ENTER para continuar...";
         std::cin.get();
@@ -150,7 +152,7 @@ void menuCriarOrdenCompra(ModuloCompras& modulo) {
     int quantidade = obterInteiro();
 
     std::cout << "Valor Unitario (R$): ";
-    double valorUnitario = obterDouble();
+    Dinheiro valorUnitario = obterDinheiro();
 
     try {
         std::cout << "\n";
@@ -192,9 +194,9 @@ void menuInvestigarFornecedor(ModuloCompras& modulo) {
     std::cout << "ID do Fornecedor: ";
     int idFornecedor = obterInteiro();
 
-    // Busca o ponteiro do fornecedor para pegar o nome e CNPJ.
-    Fornecedor* forn = modulo.buscarFornecedorPorId(idFornecedor);
-    if (forn == nullptr) {
+    // Copia o fornecedor para pegar o nome e CNPJ.
+    Fornecedor fornecedor;
+    if (!modulo.copiarFornecedorPorId(idFornecedor, fornecedor)) {
         std::cout << "Fornecedor nao encontrado!\n";
         std::cout << "Pressione ENTER para continuar...";
         std::cin.get();
@@ -203,11 +205,11 @@ void menuInvestigarFornecedor(ModuloCompras& modulo) {
 
     // STUB: Código provisório que simula o comportamento real.
     std::cout << "\nAbrindo investigacao na web...\n";
-    std::cout << "   Procurando por: \"" << forn->getNome() << " " << forn->getCNPJ() << "\"\n\n";
+    std::cout << "   Procurando por: \"" << fornecedor.getNome() << " " << fornecedor.getCNPJ() << "\"\n\n";
 
     // Cria uma URL de busca no Google concatenando os dados do fornecedor.
-    std::string url = "https://www.google.com/search?q=" + forn->getNome() +
-                      "+CNPJ+" + forn->getCNPJ();
+    std::string url = "https://www.google.com/search?q=" + fornecedor.getNome() +
+                      "+CNPJ+" + fornecedor.getCNPJ();
 
     std::cout << "URL gerada:\n   " << url << "\n\n";
     std::cout << "(STUB) Em um sistema real, isso abriria o navegador.\n";
@@ -240,6 +242,50 @@ void menuCarregarDados(ModuloCompras& modulo) {
     std::cin.get();
 }
 
+// Função para exibir a contenção medida em cada mutex instrumentado (tempos em microssegundos).
+void menuPerfilLocks() {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    os << "\nPERFIL DE CONTENCAO DOS LOCKS (us)\n";
+    os << "==================================\n";
+    for (const MutexInstrumentado::Resumo& m : MutexInstrumentado::resumirTodos()) {
+        os << "\n" << m.nome << "\n";
+        os << "  Aquisicoes: " << m.aquisicoes << " (contendidas: " << m.contendidas << ")\n";
+        os << "  Espera  media " << m.espera.mediaUs << "  p50 " << m.espera.p50Us << "  p99 " << m.espera.p99Us
+           << "  max " << m.espera.maximoUs << "\n";
+        os << "  Posse   media " << m.posse.mediaUs << "  p50 " << m.posse.p50Us << "  p99 " << m.posse.p99Us
+           << "  max " << m.posse.maximoUs << "\n";
+        if (!m.localMaiorPosse.empty()) os << "  Maior posse: " << m.maiorPosseUs << " em " << m.localMaiorPosse << "\n";
+    }
+    std::cout << os.str();
+    std::cout << "\nPressione ENTER para continuar...";
+    std::cin.get();
+}
+
+// Exibe a memória estimada de cada coleção e índice do módulo (ver MemoriaEstimada).
+void menuUsoMemoria(const ModuloCompras& modulo) {
+    std::vector<UsoMemoria> usos = modulo.medirMemoria();
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    os << "\nUSO DE MEMORIA ESTIMADO (KiB)\n";
+    os << "=============================\n";
+    os << std::left << std::setw(28) << "colecao" << std::right << std::setw(10) << "qtd" << std::setw(10)
+       << "B/elem" << std::setw(11) << "elementos" << std::setw(9) << "folga" << std::setw(9) << "texto"
+       << std::setw(11) << "estrutura" << std::setw(11) << "total" << "\n";
+    size_t total = 0;
+    for (const UsoMemoria& u : usos) {
+        total += u.total();
+        os << std::left << std::setw(28) << (u.indice ? "  " + u.colecao : u.colecao) << std::right << std::setw(10)
+           << u.elementos << std::setw(10) << u.bytesPorElemento() << std::setw(11) << u.bytesElementos / 1024.0
+           << std::setw(9) << u.bytesFolga / 1024.0 << std::setw(9) << u.bytesTexto / 1024.0 << std::setw(11)
+           << u.bytesEstrutura / 1024.0 << std::setw(11) << u.total() / 1024.0 << "\n";
+    }
+    os << "\nTotal: " << total / 1024.0 << " KiB (indices recuados)\n";
+    std::cout << os.str();
+    std::cout << "\nPressione ENTER para continuar...";
+    std::cin.get();
+}
+
 // Função para consultar item específico do estoque.
 void menuConsultarEstoque(ModuloCompras& modulo) {
     std::cout << "\nCONSULTAR ITEM DO ESTOQUE\n";
@@ -329,18 +375,19 @@ void menuListarContasPagar(ModuloCompras& modulo) {
 
 // Função para consultar saldo financeiro.
 void menuConsultarSaldoFinanceiro(ModuloCompras& modulo) {
-    double saldo = modulo.consultarSaldoFinanceiro();
-    std::cout << "\nSALDO DISPONIVEL: R$ " << std::fixed << std::setprecision(2) << saldo << "\n";
+    Dinheiro saldo = modulo.consultarSaldoFinanceiro();
+    std::cout << "\nSALDO DISPONIVEL: R$ " << saldo << "\n";
     std::cout << "\nPressione ENTER para continuar...";
     std::cin.get();
 }
 
 // ========== FUNÇÃO PRINCIPAL (Ponto de entrada) ==========
 
-int main() {
+// Uso: console [--threads-integracao=N]
+int main(int argc, char** argv) {
     try {
-        // Inicializa o módulo principal (backend) do sistema.
-        ModuloCompras modulo;
+        // Inicializa o módulo principal (backend) do sistema com as opções da linha de comando.
+        ModuloCompras modulo(ConfiguracaoCompras::deArgumentos(argc, argv));
 
         limparTela();
         exibirCabecalho();
@@ -444,6 +491,16 @@ int main() {
                     break;
 
                 case 16:
+                    menuPerfilLocks();
+                    limparTela();
+                    break;
+
+                case 17:
+                    menuUsoMemoria(modulo);
+                    limparTela();
+                    break;
+
+                case 18:
                     // Opção de sair. Salva os dados automaticamente antes de fechar.
                     std::cout << "Salvando dados antes de encerrar...\n";
                     modulo.salvarTodosDados();
@@ -452,8 +509,8 @@ int main() {
                     break;
 
                 default:
-                    // Tratamento para números fora do intervalo 1-16.
-                    std::cout << "Opcao invalida! Digite um numero entre 1 e 16.\n";
+                    // Tratamento para números fora do intervalo 1-18.
+                    std::cout << "Opcao invalida! Digite um numero entre 1 e 18.\n";
                     std::cout << "Pressione ENTER para continuar...";
                     std::cin.get();
                     limparTela();
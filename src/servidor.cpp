@@ -1,5 +1,12 @@
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <chrono>
+#include <condition_variable>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -11,12 +18,20 @@
 #include <vector>
 
 #include "ModuloCompras.h"
+#include "CacheIdempotencia.h"
+#include "CapturaRequisicoes.h"
+#include "RastreamentoEtapas.h"
+#include "MetricasServidor.h"
+#include "MutexInstrumentado.h"
+#include "MemoriaEstimada.h"
+#include "SerializacaoHttp.h"
 
 #ifdef _WIN32
     #include <winsock2.h>
     #pragma comment(lib, "ws2_32")
 #else
     #include <netinet/in.h>
+    #include <netinet/tcp.h>
     #include <sys/socket.h>
     #include <unistd.h>
     #include <cstring>
@@ -65,27 +80,30 @@ const std::string ARQ_FORNECEDORES = "data/fornecedores.txt";
 const std::string ARQ_ORDENS = "data/ordens.txt";
 const std::string ARQ_PRODUCAO = "data/producao.txt";
 const std::string ARQ_ESTOQUE_PREV = "data/estoque_previsto.txt";
+const std::string ARQ_AJUSTES_ESTOQUE = "data/ajustes_estoque.txt"; ///< Gravado pela PersistenciaCompras
 
-ModuloCompras g_modulo;
+std::unique_ptr<ModuloCompras> g_modulo; ///< Criado em serve() com a configuração da linha de comando
+std::unique_ptr<CacheIdempotencia> g_idempotencia; ///< Respostas dos POSTs com Idempotency-Key
+std::unique_ptr<CapturaRequisicoes> g_captura;     ///< Criada com --captura (nulo = desligada)
 std::vector<ProducaoRegistro> g_producao;
 std::vector<EstoquePrevisto> g_previsto;
 int g_producaoNextId = 1;
-std::mutex g_mutex;
-
-std::string jsonEscape(const std::string& in) {
-    std::string out;
-    out.reserve(in.size());
-    for (char c : in) {
-        switch (c) {
-            case '"': out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default: out += c; break;
-        }
-    }
-    return out;
+MutexInstrumentado g_mutex{"g_mutex"};
+MetricasServidor g_metricas;                ///< Contadores exportados em /metrics
+std::atomic<size_t> g_tamanhoProducao{0};   ///< Cópias de g_producao.size()/g_previsto.size() para
+std::atomic<size_t> g_tamanhoPrevisto{0};   ///< a coleta de métricas, que não adquire g_mutex
+socket_t g_socketServidor;
+
+// Adquire g_mutex registrando a espera (etapa http.esperaLock e histograma do /metrics).
+// O ponto de chamada registrado no perfil de contenção é o de quem chama esta função.
+std::unique_lock<MutexInstrumentado> travarGlobal(const char* arquivo = __builtin_FILE(),
+                                                  const char* funcao = __builtin_FUNCTION(),
+                                                  int linha = __builtin_LINE()) {
+    auto inicio = RastreamentoEtapas::agora();
+    g_mutex.lock(arquivo, funcao, linha);
+    RastreamentoEtapas::instancia().registrarDesde(Etapa::HTTP_ESPERA_LOCK, inicio);
+    g_metricas.esperaMutex.observarDesde(inicio);
+    return std::unique_lock<MutexInstrumentado>(g_mutex, std::adopt_lock);
 }
 
 std::vector<std::string> split(const std::string& s, char delim) {
@@ -96,28 +114,8 @@ std::vector<std::string> split(const std::string& s, char delim) {
     return out;
 }
 
-std::map<std::string, std::string> parseQuery(const std::string& query) {
-    std::map<std::string, std::string> params;
-    std::stringstream ss(query);
-    std::string kv;
-    while (std::getline(ss, kv, '&')) {
-        auto pos = kv.find('=');
-        if (pos != std::string::npos) {
-            std::string k = kv.substr(0, pos);
-            std::string v = kv.substr(pos + 1);
-            std::replace(v.begin(), v.end(), '+', ' ');
-            params[k] = v;
-        }
-    }
-    return params;
-}
-
 std::string nowString() {
-    auto now = std::chrono::system_clock::now();
-    auto t = std::chrono::system_clock::to_time_t(now);
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&t), "%d/%m/%Y %H:%M:%S");
-    return oss.str();
+    return DataHora::formatar(DataHora::agora());
 }
 
 void carregarProducao() {
@@ -143,15 +141,20 @@ void carregarProducao() {
         g_producao.push_back(r);
         g_producaoNextId = std::max(g_producaoNextId, r.id + 1);
     }
+    g_tamanhoProducao = g_producao.size();
 }
 
 void salvarProducao() {
+    auto inicio = HistogramaPrometheus::Relogio::now();
+    g_tamanhoProducao = g_producao.size();
     std::ofstream f(ARQ_PRODUCAO);
     f << "ID|IdMaterial|Quantidade|Prioridade|Status|IdOrdemCompra|DataCriacao|DataPrevistaEntrega\n";
     for (const auto& r : g_producao) {
         f << r.id << "|" << r.idMaterial << "|" << r.quantidade << "|" << r.prioridade << "|"
           << r.status << "|" << r.idOrdemCompra << "|" << r.dataCriacao << "|" << r.dataPrevistaEntrega << "\n";
     }
+    f.close();
+    g_metricas.persistenciaProducao.observarDesde(inicio);
 }
 
 void carregarPrevisto() {
@@ -171,75 +174,111 @@ void carregarPrevisto() {
         e.dataPrevista = p[3];
         g_previsto.push_back(e);
     }
+    g_tamanhoPrevisto = g_previsto.size();
 }
 
 void salvarPrevisto() {
+    auto inicio = HistogramaPrometheus::Relogio::now();
+    g_tamanhoPrevisto = g_previsto.size();
     std::ofstream f(ARQ_ESTOQUE_PREV);
     f << "IdMaterial|Quantidade|IdOrdemCompra|DataPrevista\n";
     for (const auto& e : g_previsto) {
         f << e.idMaterial << "|" << e.quantidade << "|" << e.idOrdemCompra << "|" << e.dataPrevista << "\n";
     }
+    f.close();
+    g_metricas.persistenciaPrevisto.observarDesde(inicio);
 }
 
-std::string jsonFornecedores(const ListaGenerica<Fornecedor>& lista) {
-    std::ostringstream os;
-    os << "[";
-    for (size_t i = 0; i < lista.obterTamanho(); ++i) {
-        const auto& f = lista.obter(i);
-        os << "{";
-        os << "\"id\":" << f.getId() << ",";
-        os << "\"nome\":\"" << jsonEscape(f.getNome()) << "\",";
-        os << "\"produto\":\"" << jsonEscape(f.getProduto()) << "\",";
-        os << "\"preco\":" << f.getPrecoProduto() << ",";
-        os << "\"cnpj\":\"" << jsonEscape(f.getCNPJ()) << "\",";
-        os << "\"endereco\":\"" << jsonEscape(f.getEndereco()) << "\"";
-        os << "}";
-        if (i + 1 < lista.obterTamanho()) os << ",";
+// Grava fornecedores e ordens medindo a duração (chamar com g_mutex adquirido)
+void salvarModulo() {
+    auto inicio = HistogramaPrometheus::Relogio::now();
+    g_modulo->salvarTodosDados();
+    g_metricas.persistenciaModulo.observarDesde(inicio);
+}
+
+// Ajustes manuais da projeção são salvos com as ordens para sobreviver a um reinício.
+// Uma falha aqui não desfaz o ajuste: ele vai para o arquivo no próximo salvamento.
+void salvarAjuste() {
+    try {
+        salvarModulo();
+    } catch (const std::exception& e) {
+        LOG_ERRO("PERSISTENCIA", "Ajuste de estoque nao salvo: " << e.what());
     }
-    os << "]";
-    return os.str();
 }
 
-std::string jsonOrdens(const ListaGenerica<OrdemCompra>& lista) {
+// GET /api/ordens?de=&ate=&campo=solicitacao|chegada&limite=&cursor=
+// Responde com uma página de ordens do intervalo usando o índice temporal.
+std::string jsonOrdensPorPeriodo(const std::map<std::string, std::string>& params) {
+    int64_t de = std::numeric_limits<int64_t>::min() + 1;
+    int64_t ate = std::numeric_limits<int64_t>::max();
+    if (params.count("de") && !DataHora::parsear(urlDecode(params.at("de")), de))
+        throw ComprasException("Parametro 'de' invalido (use dd/mm/aaaa ou aaaa-mm-dd)");
+    if (params.count("ate")) {
+        std::string texto = urlDecode(params.at("ate"));
+        if (!DataHora::parsear(texto, ate))
+            throw ComprasException("Parametro 'ate' invalido (use dd/mm/aaaa ou aaaa-mm-dd)");
+        if (texto.size() == 10) ate += 24 * 3600 - 1; // só a data: inclui o dia inteiro
+    }
+
+    CampoData campo = CampoData::SOLICITACAO;
+    if (params.count("campo")) {
+        const std::string& c = params.at("campo");
+        if (c == "chegada" || c == "data_chegada") campo = CampoData::CHEGADA_PREVISTA;
+        else if (c != "solicitacao") throw ComprasException("Parametro 'campo' deve ser 'solicitacao' ou 'chegada'");
+    }
+
+    size_t limite = 100;
+    if (params.count("limite")) limite = static_cast<size_t>(std::max(1, std::min(1000, std::stoi(params.at("limite")))));
+
+    CursorTemporal cursor;
+    bool temCursor = false;
+    if (params.count("cursor") && !params.at("cursor").empty()) {
+        const std::string& c = params.at("cursor");
+        auto sep = c.find('_');
+        if (sep == std::string::npos) throw ComprasException("Cursor invalido");
+        cursor.epoch = std::stoll(c.substr(0, sep));
+        cursor.idOrdem = std::stoi(c.substr(sep + 1));
+        temCursor = true;
+    }
+
+    PaginaOrdens pagina = g_modulo->consultarOrdensPorPeriodo(campo, de, ate, temCursor ? &cursor : nullptr, limite);
     std::ostringstream os;
-    os << "[";
-    for (size_t i = 0; i < lista.obterTamanho(); ++i) {
-        const auto& o = lista.obter(i);
-        os << "{";
-        os << "\"id\":" << o.getIdTransacao() << ",";
-        os << "\"idItem\":" << o.getIdItem() << ",";
-        os << "\"quantidade\":" << o.getQuantidade() << ",";
-        os << "\"valor\":" << o.getValorUnitario() << ",";
-        os << "\"status\":" << static_cast<int>(o.getStatus()) << ",";
-        os << "\"descricao\":\"" << jsonEscape(o.getDataSolicitacao()) << "\",";
-        os << "\"data_chegada\":\"" << jsonEscape(o.getDataChegadaPrevista()) << "\"";
-        os << "}";
-        if (i + 1 < lista.obterTamanho()) os << ",";
+    os << "{\"ordens\":[";
+    for (size_t i = 0; i < pagina.ordens.size(); ++i) {
+        jsonOrdem(os, pagina.ordens[i]);
+        if (i + 1 < pagina.ordens.size()) os << ",";
     }
-    os << "]";
+    os << "],\"proximoCursor\":";
+    if (pagina.temMais) os << "\"" << pagina.proximo.epoch << "_" << pagina.proximo.idOrdem << "\"";
+    else os << "null";
+    os << "}";
     return os.str();
 }
 
-std::string jsonEstoqueAtual(const ListaGenerica<OrdemCompra>& lista) {
-    std::map<int, int> soma;
-    for (size_t i = 0; i < lista.obterTamanho(); ++i) {
-        const auto& o = lista.obter(i);
-        if (o.getStatus() != StatusOrdem::REJEITADO) {
-            soma[o.getIdItem()] += o.getQuantidade();
-        }
-    }
+// Serializa a projeção de estoque mantida pelo módulo. O JSON só é refeito
+// quando a versão da projeção muda; consultas repetidas (polling) reaproveitam o cache.
+std::string jsonEstoqueAtual(const ProjecaoEstoque& projecao) {
+    static std::string cache;
+    static unsigned long versaoCache = 0;
+    static bool cacheValido = false;
+    if (cacheValido && versaoCache == projecao.obterVersao()) return cache;
+
+    const auto& totais = projecao.obterTotais();
     std::ostringstream os;
     os << "[";
     size_t idx = 0;
-    for (const auto& kv : soma) {
+    for (const auto& kv : totais) {
         os << "{";
         os << "\"id\":" << kv.first << ",";
         os << "\"nome\":\"Item " << kv.first << "\",";
         os << "\"quantidade\":" << kv.second << "}";
-        if (++idx < soma.size()) os << ",";
+        if (++idx < totais.size()) os << ",";
     }
     os << "]";
-    return os.str();
+    cache = os.str();
+    versaoCache = projecao.obterVersao();
+    cacheValido = true;
+    return cache;
 }
 
 std::string jsonPrevisto() {
@@ -280,47 +319,206 @@ std::string jsonProducao() {
     return os.str();
 }
 
+const char* motivoHttp(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 422: return "Unprocessable Entity";
+        case 503: return "Service Unavailable";
+        default: return "OK";
+    }
+}
+
 std::string httpResponse(const std::string& body, int code = 200, const std::string& contentType = "application/json") {
     std::ostringstream os;
-    os << "HTTP/1.1 " << code << " OK\r\n";
+    os << "HTTP/1.1 " << code << " " << motivoHttp(code) << "\r\n";
     os << "Content-Type: " << contentType << "; charset=utf-8\r\n";
     os << "Access-Control-Allow-Origin: *\r\n";
     os << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
-    os << "Access-Control-Allow-Headers: Content-Type\r\n";
+    os << "Access-Control-Allow-Headers: Content-Type, Idempotency-Key\r\n";
     os << "Content-Length: " << body.size() << "\r\n\r\n";
     os << body;
     return os.str();
 }
 
+// Compara a projeção de estoque com uma reconstrução a partir das ordens e dos ajustes;
+// com 'reconstruir', uma projeção divergente é refeita
+std::string jsonVerificacaoEstoque(bool reconstruir) {
+    std::vector<std::string> divergencias;
+    bool consistente = g_modulo->verificarProjecaoEstoque(divergencias, reconstruir);
+    std::ostringstream os;
+    os << "{\"consistente\":" << (consistente ? "true" : "false") << ",\"divergencias\":[";
+    for (size_t i = 0; i < divergencias.size(); ++i) {
+        os << "\"" << jsonEscape(divergencias[i]) << "\"";
+        if (i + 1 < divergencias.size()) os << ",";
+    }
+    os << "],\"reconstruido\":" << ((!consistente && reconstruir) ? "true" : "false") << "}";
+    return os.str();
+}
+
 std::string notFound() { return httpResponse("{\"error\":\"not found\"}", 404); }
 
 std::string statusOk() { return httpResponse("{\"status\":\"online\",\"message\":\"Backend C++ ativo\"}"); }
 
+// Com um único laço de accept, o que cresce sob carga é a fila do kernel: a cada
+// accept, soma quantas conexões ainda esperam e conta as vezes em que a fila
+// estava no limite do backlog (novas conexões seriam descartadas)
+void amostrarFilaAccept(socket_t servidor) {
+#ifdef __linux__
+    tcp_info info{};
+    socklen_t tamanho = sizeof(info);
+    if (getsockopt(servidor, IPPROTO_TCP, TCP_INFO, &info, &tamanho) != 0) return;
+    g_metricas.filaAcceptSoma += info.tcpi_unacked;
+    if (info.tcpi_unacked + 1 >= info.tcpi_sacked) g_metricas.filaAcceptCheia++;
+#else
+    (void)servidor;
+#endif
+}
+
+// Texto do /metrics: contadores do servidor, tamanho das coleções e fila de conexões
+std::string metricasPrometheus() {
+    std::ostringstream os;
+    os << g_metricas.exportar();
+    os << "# HELP compras_colecao_itens Registros em memoria por colecao.\n"
+       << "# TYPE compras_colecao_itens gauge\n"
+       << "compras_colecao_itens{colecao=\"fornecedores\"} " << g_modulo->obterQuantidadeFornecedores() << "\n"
+       << "compras_colecao_itens{colecao=\"ordens\"} " << g_modulo->obterQuantidadeOrdens() << "\n"
+       << "compras_colecao_itens{colecao=\"producao\"} " << g_tamanhoProducao.load() << "\n"
+       << "compras_colecao_itens{colecao=\"estoque_previsto\"} " << g_tamanhoPrevisto.load() << "\n";
+#ifdef __linux__
+    // Fila de conexões completas aguardando accept (no socket de escuta o kernel
+    // informa o tamanho atual em tcpi_unacked e o limite do backlog em tcpi_sacked)
+    tcp_info info{};
+    socklen_t tamanho = sizeof(info);
+    if (getsockopt(g_socketServidor, IPPROTO_TCP, TCP_INFO, &info, &tamanho) == 0) {
+        os << "# HELP compras_http_fila_accept Conexoes aguardando accept.\n"
+           << "# TYPE compras_http_fila_accept gauge\n"
+           << "compras_http_fila_accept " << info.tcpi_unacked << "\n"
+           << "# HELP compras_http_fila_accept_limite Tamanho maximo da fila de accept (backlog).\n"
+           << "# TYPE compras_http_fila_accept_limite gauge\n"
+           << "compras_http_fila_accept_limite " << info.tcpi_sacked << "\n";
+    }
+    // Descartes por fila de accept cheia: o kernel só conta por máquina (TcpExt ListenDrops)
+    std::ifstream netstat("/proc/net/netstat");
+    std::string cabecalho, valores;
+    while (std::getline(netstat, cabecalho) && std::getline(netstat, valores)) {
+        if (cabecalho.compare(0, 7, "TcpExt:") != 0) continue;
+        std::istringstream nomes(cabecalho), numeros(valores);
+        std::string nome, numero;
+        while (nomes >> nome && numeros >> numero) {
+            if (nome == "ListenDrops") {
+                os << "# HELP compras_tcp_listen_drops_total Conexoes descartadas com a fila de accept cheia (toda a maquina).\n"
+                   << "# TYPE compras_tcp_listen_drops_total counter\n"
+                   << "compras_tcp_listen_drops_total " << numero << "\n";
+            }
+        }
+    }
+#endif
+    return httpResponse(os.str(), 200, "text/plain; version=0.0.4");
+}
+
+// Perfil de contenção dos mutexes instrumentados (tempos em microssegundos).
+// Também fora de g_mutex: o próprio g_mutex está entre os medidos.
+std::string perfilLocks() {
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << "[";
+    auto lista = MutexInstrumentado::resumirTodos();
+    for (size_t i = 0; i < lista.size(); ++i) {
+        const MutexInstrumentado::Resumo& m = lista[i];
+        os << "{\"mutex\":\"" << jsonEscape(m.nome) << "\",\"aquisicoes\":" << m.aquisicoes
+           << ",\"contendidas\":" << m.contendidas
+           << ",\"espera\":{\"mediaUs\":" << m.espera.mediaUs << ",\"p50Us\":" << m.espera.p50Us
+           << ",\"p99Us\":" << m.espera.p99Us << ",\"maximoUs\":" << m.espera.maximoUs << "}"
+           << ",\"posse\":{\"mediaUs\":" << m.posse.mediaUs << ",\"p50Us\":" << m.posse.p50Us
+           << ",\"p99Us\":" << m.posse.p99Us << ",\"maximoUs\":" << m.posse.maximoUs
+           << ",\"totalMs\":" << m.posse.mediaUs * m.posse.contagem / 1e3 << "}"
+           << ",\"maiorPosse\":{\"local\":\"" << jsonEscape(m.localMaiorPosse) << "\",\"us\":" << m.maiorPosseUs << "}}";
+        if (i + 1 < lista.size()) os << ",";
+    }
+    os << "]";
+    return httpResponse(os.str());
+}
+
+// Memória estimada por coleção e índice (ver MemoriaEstimada). Chamada com g_mutex
+// adquirido: g_producao e g_previsto são protegidos por ele.
+std::string relatorioMemoria() {
+    std::vector<UsoMemoria> usos = g_modulo->medirMemoria();
+
+    UsoMemoria producao("producao");
+    MemoriaEstimada::vetor(producao, g_producao);
+    for (const auto& p : g_producao) {
+        producao.bytesTexto += MemoriaEstimada::texto(p.status) + MemoriaEstimada::texto(p.dataCriacao) +
+                               MemoriaEstimada::texto(p.dataPrevistaEntrega);
+    }
+    usos.push_back(producao);
+
+    UsoMemoria previsto("estoquePrevisto");
+    MemoriaEstimada::vetor(previsto, g_previsto);
+    for (const auto& e : g_previsto) previsto.bytesTexto += MemoriaEstimada::texto(e.dataPrevista);
+    usos.push_back(previsto);
+
+    UsoMemoria respostas("idempotencia"), porChave("idempotencia.porChave", true);
+    g_idempotencia->medirMemoria(respostas, porChave);
+    usos.push_back(respostas);
+    usos.push_back(porChave);
+
+    size_t totalColecoes = 0, totalIndices = 0;
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1) << "{\"colecoes\":[";
+    for (size_t i = 0; i < usos.size(); ++i) {
+        const UsoMemoria& u = usos[i];
+        (u.indice ? totalIndices : totalColecoes) += u.total();
+        os << "{\"colecao\":\"" << jsonEscape(u.colecao) << "\",\"indice\":" << (u.indice ? "true" : "false")
+           << ",\"elementos\":" << u.elementos << ",\"bytesPorElemento\":" << u.bytesPorElemento()
+           << ",\"bytesElementos\":" << u.bytesElementos << ",\"bytesFolga\":" << u.bytesFolga
+           << ",\"bytesTexto\":" << u.bytesTexto << ",\"bytesEstrutura\":" << u.bytesEstrutura
+           << ",\"total\":" << u.total() << "}";
+        if (i + 1 < usos.size()) os << ",";
+    }
+    os << "],\"totalColecoes\":" << totalColecoes << ",\"totalIndices\":" << totalIndices
+       << ",\"total\":" << totalColecoes + totalIndices << "}";
+    return httpResponse(os.str());
+}
+
 std::string handleGet(const std::string& path, const std::map<std::string, std::string>& params) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    // Fora de g_mutex: a coleta não espera (nem atrasa) o processamento das requisições
+    if (path == "/metrics") return metricasPrometheus();
+    if (path == "/api/debug/locks") return perfilLocks();
+    auto lock = travarGlobal();
     if (path == "/api/status") return statusOk();
-    if (path == "/api/fornecedores") return httpResponse(jsonFornecedores(g_modulo.obterListaFornecedores()));
+    if (path == "/api/debug/memoria") return relatorioMemoria();
+    if (path == "/api/fornecedores") {
+        std::string json;
+        g_modulo->comListaFornecedores([&json](const ListaGenerica<Fornecedor>& lista) { json = jsonFornecedores(lista); });
+        return httpResponse(json);
+    }
     if (path == "/api/fornecedores/produto") {
-        const auto& lista = g_modulo.obterListaFornecedores();
         std::ostringstream os; os << "["; bool first = true;
         std::string prod = params.count("produto") ? params.at("produto") : "";
-        for (size_t i = 0; i < lista.obterTamanho(); ++i) {
-            const auto& f = lista.obter(i);
-            if (!prod.empty() && f.getProduto() != prod) continue;
-            if (!first) os << ","; else first = false;
-            os << "{";
-            os << "\"id\":" << f.getId() << ",";
-            os << "\"nome\":\"" << jsonEscape(f.getNome()) << "\",";
-            os << "\"produto\":\"" << jsonEscape(f.getProduto()) << "\",";
-            os << "\"preco\":" << f.getPrecoProduto() << "}";
-        }
+        g_modulo->comListaFornecedores([&](const ListaGenerica<Fornecedor>& lista) {
+            for (size_t i = 0; i < lista.obterTamanho(); ++i) {
+                const auto& f = lista.obter(i);
+                if (!prod.empty() && f.getProduto() != prod) continue;
+                if (!first) os << ","; else first = false;
+                os << "{";
+                os << "\"id\":" << f.getId() << ",";
+                os << "\"nome\":\"" << jsonEscape(f.getNome()) << "\",";
+                os << "\"produto\":\"" << jsonEscape(f.getProduto()) << "\",";
+                os << "\"preco\":" << f.getPrecoProduto() << "}";
+            }
+        });
         os << "]";
         return httpResponse(os.str());
     }
     if (path == "/api/fornecedores/ordenado_preco") {
-        const auto& lista = g_modulo.obterListaFornecedores();
         std::vector<Fornecedor> tmp;
-        for (size_t i = 0; i < lista.obterTamanho(); ++i) tmp.push_back(lista.obter(i));
+        g_modulo->comListaFornecedores([&tmp](const ListaGenerica<Fornecedor>& lista) {
+            for (size_t i = 0; i < lista.obterTamanho(); ++i) tmp.push_back(lista.obter(i));
+        });
         std::sort(tmp.begin(), tmp.end(), [](const Fornecedor& a, const Fornecedor& b){return a.getPrecoProduto() > b.getPrecoProduto();});
         std::ostringstream os; os << "[";
         for (size_t i = 0; i < tmp.size(); ++i) {
@@ -331,11 +529,24 @@ std::string handleGet(const std::string& path, const std::map<std::string, std::
         os << "]";
         return httpResponse(os.str());
     }
-    if (path == "/api/ordens") return httpResponse(jsonOrdens(g_modulo.obterListaOrdens()));
+    if (path == "/api/ordens") {
+        if (params.count("de") || params.count("ate") || params.count("campo") || params.count("cursor")) {
+            try {
+                return httpResponse(jsonOrdensPorPeriodo(params));
+            } catch (const std::exception& e) {
+                return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}", 400);
+            }
+        }
+        std::string json;
+        g_modulo->comListaOrdens([&json](const ListaGenerica<OrdemCompra>& ordens) { json = jsonOrdens(ordens); });
+        return httpResponse(json);
+    }
     if (path == "/api/ordens/buscar") {
         int id = params.count("id") ? std::stoi(params.at("id")) : -1;
-        OrdemCompra* o = g_modulo.buscarOrdenPorId(id);
-        if (!o) return httpResponse("{\"encontrado\":false}");
+        // Cópia: a ordem pode estar sendo aprovada no executor neste momento
+        OrdemCompra copia;
+        if (!g_modulo->copiarOrdemPorId(id, copia)) return httpResponse("{\"encontrado\":false}");
+        const OrdemCompra* o = &copia;
         std::ostringstream os;
         os << "{\"encontrado\":true,\"id\":" << o->getIdTransacao()
            << ",\"idItem\":" << o->getIdItem() << ",\"quantidade\":" << o->getQuantidade()
@@ -344,31 +555,35 @@ std::string handleGet(const std::string& path, const std::map<std::string, std::
         return httpResponse(os.str());
     }
     if (path == "/api/estatisticas") {
-        const auto& lista = g_modulo.obterListaOrdens();
-        int aprov = 0, reje = 0, pend = 0; double total = 0;
-        for (size_t i = 0; i < lista.obterTamanho(); ++i) {
-            const auto& o = lista.obter(i);
-            switch (o.getStatus()) {
-                case StatusOrdem::APROVADO: aprov++; total += o.getValorTotal(); break;
-                case StatusOrdem::REJEITADO: reje++; break;
-                default: pend++; break;
-            }
-        }
+        ResumoOrdens r = g_modulo->obterResumoOrdens();
+        long long pend = static_cast<long long>(r.totalOrdens) - r.contagem(StatusOrdem::APROVADO) - r.contagem(StatusOrdem::REJEITADO);
         std::ostringstream os;
-        os << "{\"aprovadas\":" << aprov << ",\"rejeitadas\":" << reje << ",\"pendentes\":" << pend << ",\"valorTotalAprovado\":" << total << "}";
+        os << "{\"aprovadas\":" << r.contagem(StatusOrdem::APROVADO) << ",\"rejeitadas\":" << r.contagem(StatusOrdem::REJEITADO)
+           << ",\"pendentes\":" << pend << ",\"valorTotalAprovado\":" << r.valorTotalAprovado << "}";
         return httpResponse(os.str());
     }
     if (path == "/api/investigar") {
         int id = params.count("idFornecedor") ? std::stoi(params.at("idFornecedor")) : -1;
-        Fornecedor* f = g_modulo.buscarFornecedorPorId(id);
-        if (!f) return httpResponse("{\"sucesso\":false,\"msg\":\"Fornecedor não encontrado\"}");
-        std::string url = "https://www.google.com/search?q=" + f->getNome() + "+CNPJ+" + f->getCNPJ();
+        Fornecedor f;
+        if (!g_modulo->copiarFornecedorPorId(id, f)) return httpResponse("{\"sucesso\":false,\"msg\":\"Fornecedor não encontrado\"}");
+        std::string url = "https://www.google.com/search?q=" + f.getNome() + "+CNPJ+" + f.getCNPJ();
         return httpResponse("{\"sucesso\":true,\"url\":\"" + jsonEscape(url) + "\"}");
     }
-    if (path == "/api/estoque") return httpResponse(jsonEstoqueAtual(g_modulo.obterListaOrdens()));
+    if (path == "/api/estoque") {
+        std::string json;
+        g_modulo->comProjecaoEstoque([&json](const ProjecaoEstoque& p) { json = jsonEstoqueAtual(p); });
+        return httpResponse(json);
+    }
+    if (path == "/api/estoque/verificar") {
+        // Só leitura: a correção é POST /api/estoque/reconstruir
+        if (params.count("reconstruir")) {
+            return httpResponse("{\"sucesso\":false,\"msg\":\"use POST /api/estoque/reconstruir\"}", 405);
+        }
+        return httpResponse(jsonVerificacaoEstoque(false));
+    }
     if (path == "/api/estoque/consultar") {
         int idMat = params.count("idMaterial") ? std::stoi(params.at("idMaterial")) : -1;
-        int qtd = g_modulo.consultarEstoque(idMat);
+        int qtd = g_modulo->consultarEstoque(idMat);
         std::ostringstream os;
         os << "{\"idMaterial\":" << idMat << ",\"quantidade\":" << qtd << "}";
         return httpResponse(os.str());
@@ -388,16 +603,15 @@ std::string handleGet(const std::string& path, const std::map<std::string, std::
         return httpResponse(os.str());
     }
     if (path == "/api/financeiro") {
-        const auto& ordens = g_modulo.obterListaOrdens();
-        double total = 0;
-        for (size_t i = 0; i < ordens.obterTamanho(); ++i) total += ordens.obter(i).getValorTotal();
-        double contas = total * 0.4;
+        ResumoOrdens r = g_modulo->obterResumoOrdens();
+        Dinheiro total = r.valorTotal;
+        Dinheiro contas = total * 4 / 10;
         std::ostringstream os;
-        os << "{\"saldo\":" << total << ",\"saldo_disponivel\":" << total << ",\"contas_pagar\":" << contas << ",\"pendencias\":" << ordens.obterTamanho() << "}";
+        os << "{\"saldo\":" << total << ",\"saldo_disponivel\":" << total << ",\"contas_pagar\":" << contas << ",\"pendencias\":" << r.totalOrdens << "}";
         return httpResponse(os.str());
     }
     if (path == "/api/financeiro/contas_pagar") {
-        auto lista = g_modulo.getModuloFinanceiro()->listarContasPagar();
+        auto lista = g_modulo->getModuloFinanceiro()->listarContasPagar();
         std::ostringstream os; os << "[";
         for (size_t i = 0; i < lista.size(); ++i) {
             os << "{\"descricao\":\"" << jsonEscape(lista[i]) << "\"}";
@@ -406,19 +620,79 @@ std::string handleGet(const std::string& path, const std::map<std::string, std::
         os << "]";
         return httpResponse(os.str());
     }
+    if (path == "/api/executor") {
+        ExecutorIntegracao::Metricas m = g_modulo->obterMetricasExecutor();
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(3);
+        os << "{\"threads\":" << m.threads << ",\"profundidadeFila\":" << m.profundidadeFila
+           << ",\"profundidadeMaxima\":" << m.profundidadeMaxima << ",\"tarefasConcluidas\":" << m.tarefasConcluidas
+           << ",\"tarefasRoubadas\":" << m.tarefasRoubadas << ",\"esperaMediaMs\":" << m.esperaMediaMs
+           << ",\"execucaoMediaMs\":" << m.execucaoMediaMs << ",\"latenciaMaximaMs\":" << m.latenciaMaximaMs;
+        AgrupadorVerba::Metricas lv = g_modulo->obterMetricasLoteVerba();
+        os << ",\"loteVerba\":{\"lotes\":" << lv.lotes << ",\"pedidos\":" << lv.pedidos
+           << ",\"maiorLote\":" << lv.maiorLote << "}}";
+        return httpResponse(os.str());
+    }
+    if (path == "/api/metricas") {
+        // Latência por etapa do fluxo das ordens (microssegundos; percentis dos histogramas)
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(1) << "[";
+        auto resumo = RastreamentoEtapas::instancia().obterResumo();
+        for (size_t i = 0; i < resumo.size(); ++i) {
+            const RastreamentoEtapas::ResumoEtapa& r = resumo[i];
+            os << "{\"etapa\":\"" << r.nome << "\",\"contagem\":" << r.contagem << ",\"mediaUs\":" << r.mediaUs
+               << ",\"p50Us\":" << r.p50Us << ",\"p90Us\":" << r.p90Us << ",\"p99Us\":" << r.p99Us
+               << ",\"p999Us\":" << r.p999Us << ",\"maximoUs\":" << r.maximoUs << "}";
+            if (i + 1 < resumo.size()) os << ",";
+        }
+        os << "]";
+        return httpResponse(os.str());
+    }
+    if (path == "/api/financeiro/razao") {
+        RazaoOrcamento::Metricas m;
+        if (!g_modulo->obterMetricasRazao(m)) return httpResponse("{\"ativo\":false}");
+        std::ostringstream os;
+        os << "{\"ativo\":true,\"disponivel\":" << m.disponivel << ",\"concedidoTotal\":" << m.concedidoTotal
+           << ",\"reservasLocais\":" << m.reservasLocais << ",\"reservasRemotas\":" << m.reservasRemotas
+           << ",\"recusas\":" << m.recusas << ",\"renovacoes\":" << m.renovacoes << "}";
+        return httpResponse(os.str());
+    }
+    if (path == "/api/caixa-saida") {
+        CaixaSaida::Metricas m = g_modulo->obterMetricasCaixaSaida();
+        std::ostringstream os;
+        os << "{\"pendentes\":" << m.pendentes << ",\"aprovacoesGuardadas\":" << m.aprovacoesGuardadas
+           << ",\"registrados\":" << m.registrados
+           << ",\"entregues\":" << m.entregues << ",\"novasTentativas\":" << m.novasTentativas
+           << ",\"maiorTentativa\":" << m.maiorTentativa << "}";
+        return httpResponse(os.str());
+    }
+    if (path == "/api/resiliencia") {
+        auto lista = g_modulo->obterMetricasResiliencia();
+        std::ostringstream os; os << "[";
+        for (size_t i = 0; i < lista.size(); ++i) {
+            const GuardaIntegracao::Metricas& m = lista[i];
+            os << "{\"modulo\":\"" << m.modulo << "\",\"circuito\":\"" << DisjuntorCircuito::nomeEstado(m.estado)
+               << "\",\"chamadas\":" << m.chamadas << ",\"falhas\":" << m.falhas
+               << ",\"prazosExcedidos\":" << m.prazosExcedidos << ",\"novasTentativas\":" << m.novasTentativas
+               << ",\"recusadasCircuitoAberto\":" << m.recusadasCircuitoAberto << "}";
+            if (i + 1 < lista.size()) os << ",";
+        }
+        os << "]";
+        return httpResponse(os.str());
+    }
     if (path == "/api/financeiro/saldo") {
-        double saldo = g_modulo.consultarSaldoFinanceiro();
+        Dinheiro saldo = g_modulo->consultarSaldoFinanceiro();
         std::ostringstream os; os << "{\"saldo\":" << saldo << "}";
         return httpResponse(os.str());
     }
     if (path == "/api/salvar") {
-        g_modulo.salvarTodosDados();
+        salvarModulo();
         salvarProducao();
         salvarPrevisto();
         return httpResponse("{\"sucesso\":true}");
     }
     if (path == "/api/carregar") {
-        g_modulo.carregarTodosDados();
+        g_modulo->carregarTodosDados();
         carregarProducao();
         carregarPrevisto();
         return httpResponse("{\"sucesso\":true}");
@@ -426,12 +700,17 @@ std::string handleGet(const std::string& path, const std::map<std::string, std::
     return notFound();
 }
 
-void registrarPrevisto(int idMaterial, int quantidade, int idOrdem, const std::string& dataPrevista) {
+void adicionarPrevisto(int idMaterial, int quantidade, int idOrdem, const std::string& dataPrevista) {
     EstoquePrevisto e{ idMaterial, quantidade, idOrdem, dataPrevista };
     g_previsto.push_back(e);
+}
+
+void registrarPrevisto(int idMaterial, int quantidade, int idOrdem, const std::string& dataPrevista) {
+    adicionarPrevisto(idMaterial, quantidade, idOrdem, dataPrevista);
     salvarPrevisto();
 }
 
+// Só em memória: quem chama grava a produção depois
 void registrarProducaoAutomatica(int idMaterial, int quantidade, int idOrdem, const std::string& dataPrevista) {
     ProducaoRegistro r;
     r.id = g_producaoNextId++;
@@ -443,58 +722,217 @@ void registrarProducaoAutomatica(int idMaterial, int quantidade, int idOrdem, co
     r.dataCriacao = nowString();
     r.dataPrevistaEntrega = dataPrevista.empty() ? "A definir" : dataPrevista;
     g_producao.push_back(r);
-    salvarProducao();
+}
+
+// Ordem criada pela API cujo fluxo de aprovação terminou, aguardando gravação
+struct ConclusaoHttp {
+    int id;
+    StatusOrdem status;
+    int idItem;
+    int quantidade;
+    std::string dataChegada;
+};
+
+/*
+ * Grava numa thread própria o desfecho das ordens criadas pela API. O fluxo de
+ * aprovação termina no executor de integrações, que só enfileira aqui e segue
+ * livre; a thread junta o que chegou enquanto gravava a leva anterior e faz uma
+ * única gravação dos arquivos por leva, sob g_mutex. Ao destruir, grava o que
+ * ainda estiver na fila.
+ */
+class GravadorConclusoes {
+private:
+    std::mutex mutex;
+    std::condition_variable mudou;
+    std::vector<ConclusaoHttp> fila;
+    bool parando = false;
+    std::thread thread;
+
+    // Ordem de locks: g_mutex antes do mutex do gerenciador (o mesmo dos handlers)
+    static void gravar(const std::vector<ConclusaoHttp>& leva) {
+        auto lock = travarGlobal();
+        bool aprovadas = false;
+        for (const auto& c : leva) {
+            if (c.status != StatusOrdem::APROVADO) continue;
+            adicionarPrevisto(c.idItem, c.quantidade, c.id, c.dataChegada.empty() ? "Nao informada" : c.dataChegada);
+            registrarProducaoAutomatica(c.idItem, c.quantidade, c.id, c.dataChegada);
+            aprovadas = true;
+        }
+        try {
+            salvarModulo();
+            if (aprovadas) {
+                salvarPrevisto();
+                salvarProducao();
+            }
+        } catch (const std::exception& e) {
+            // Os registros ficam em memória e vão para o arquivo no próximo salvamento
+            LOG_ERRO("PERSISTENCIA", "Conclusao de " << leva.size() << " ordem(ns) nao salva: " << e.what());
+        }
+    }
+
+    void laco() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            mudou.wait(lock, [this] { return parando || !fila.empty(); });
+            if (fila.empty()) return;
+            std::vector<ConclusaoHttp> leva;
+            leva.swap(fila);
+            lock.unlock();
+            gravar(leva);
+            lock.lock();
+        }
+    }
+
+public:
+    GravadorConclusoes() : thread(&GravadorConclusoes::laco, this) {}
+
+    ~GravadorConclusoes() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            parando = true;
+        }
+        mudou.notify_all();
+        thread.join();
+    }
+
+    GravadorConclusoes(const GravadorConclusoes&) = delete;
+    GravadorConclusoes& operator=(const GravadorConclusoes&) = delete;
+
+    void enfileirar(ConclusaoHttp conclusao) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fila.push_back(std::move(conclusao));
+        }
+        mudou.notify_one();
+    }
+};
+
+std::unique_ptr<GravadorConclusoes> g_gravadorConclusoes; ///< Criado em serve(), depois de g_modulo
+
+// Respostas de erro dos POSTs que criam registros. A distinção importa para a
+// idempotência: uma requisição inválida falha igual se repetida (a resposta pode ser
+// guardada); uma falha transitória deve ser executada de novo na repetição.
+std::string falhaValidacao(const std::exception& e) {
+    return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}", 400);
+}
+
+std::string falhaTransitoria(const std::exception& e) {
+    return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}", 503);
+}
+
+// O registro já foi criado em memória: uma falha ao salvar não vira erro para o cliente
+// (que repetiria e criaria outro); o arquivo é atualizado no próximo salvamento.
+void salvarAposCriar(const char* tipo, int id) {
+    try {
+        salvarModulo();
+    } catch (const std::exception& e) {
+        LOG_ERRO("PERSISTENCIA", tipo << " " << id << " criado, mas nao salvo: " << e.what());
+    }
 }
 
 std::string handlePost(const std::string& path, const std::map<std::string, std::string>& params) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    MedidorEtapa medidor(Etapa::HTTP_POST);
+    auto lock = travarGlobal();
 
     if (path == "/api/fornecedores") {
         if (params.count("nome") == 0 || params.count("cnpj") == 0 || params.count("endereco") == 0 || params.count("produto") == 0 || params.count("preco") == 0)
-            return httpResponse("{\"sucesso\":false,\"msg\":\"Parâmetros incompletos\"}");
+            return httpResponse("{\"sucesso\":false,\"msg\":\"Parâmetros incompletos\"}", 400);
+        int id;
         try {
-            int id = g_modulo.adicionarFornecedor(params.at("nome"), params.at("endereco"), params.at("cnpj"), params.at("produto"), std::stod(params.at("preco")));
-            g_modulo.salvarTodosDados();
-            return httpResponse("{\"sucesso\":true,\"id\":" + std::to_string(id) + "}");
+            id = g_modulo->adicionarFornecedor(params.at("nome"), params.at("endereco"), params.at("cnpj"), params.at("produto"), Dinheiro::deTexto(params.at("preco")));
+        } catch (const ComprasException& e) {
+            return falhaValidacao(e);
         } catch (const std::exception& e) {
-            return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}");
+            return falhaTransitoria(e);
         }
+        salvarAposCriar("Fornecedor", id);
+        return httpResponse("{\"sucesso\":true,\"id\":" + std::to_string(id) + "}");
     }
 
     if (path == "/api/ordens") {
         if (params.count("idFornecedor") == 0 || params.count("idItem") == 0 || params.count("quantidade") == 0 || params.count("valor") == 0)
-            return httpResponse("{\"sucesso\":false,\"msg\":\"Parâmetros incompletos\"}");
+            return httpResponse("{\"sucesso\":false,\"msg\":\"Parâmetros incompletos\"}", 400);
+        int idItem, quantidade, idFornecedor;
+        std::string dataChegada = params.count("data_chegada") ? params.at("data_chegada") : "";
+        SubmissaoOrdem submissao;
         try {
-            int idItem = std::stoi(params.at("idItem"));
-            int quantidade = std::stoi(params.at("quantidade"));
-            double valor = std::stod(params.at("valor"));
-            int idFornecedor = std::stoi(params.at("idFornecedor"));
-            std::string dataChegada = params.count("data_chegada") ? params.at("data_chegada") : "";
-            int id = g_modulo.criarOrdemCompra(idItem, quantidade, valor, idFornecedor, dataChegada);
-            g_modulo.salvarTodosDados();
-            registrarPrevisto(idItem, quantidade, id, dataChegada.empty() ? "Nao informada" : dataChegada);
-            registrarProducaoAutomatica(idItem, quantidade, id, dataChegada);
-            return httpResponse("{\"sucesso\":true,\"id\":" + std::to_string(id) + "}");
+            idItem = std::stoi(params.at("idItem"));
+            quantidade = std::stoi(params.at("quantidade"));
+            Dinheiro valor = Dinheiro::deTexto(params.at("valor"));
+            idFornecedor = std::stoi(params.at("idFornecedor"));
+            // A ordem é aceita como PENDENTE e aprovada em segundo plano; o cliente
+            // acompanha a transição por /api/ordens/buscar?id=.
+            submissao = g_modulo->submeterOrdemCompra(idItem, quantidade, valor, idFornecedor, dataChegada);
+        } catch (const ComprasException& e) {
+            return falhaValidacao(e);
+        } catch (const std::logic_error& e) {
+            // std::stoi: número inválido ou fora da faixa
+            return falhaValidacao(e);
         } catch (const std::exception& e) {
-            return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}");
+            return falhaTransitoria(e);
+        }
+        {
+            MedidorEtapa persistencia(Etapa::HTTP_PERSISTENCIA);
+            salvarAposCriar("Ordem", submissao.idOrdem);
         }
+        int id = submissao.idOrdem;
+        submissao.conclusao.entao([=](StatusOrdem status) {
+            g_gravadorConclusoes->enfileirar(ConclusaoHttp{id, status, idItem, quantidade, dataChegada});
+            return true;
+        });
+        return httpResponse("{\"sucesso\":true,\"id\":" + std::to_string(id) + ",\"status\":\"PENDENTE\"}", 202);
+    }
+
+    // Injeção de falhas nos módulos simulados (testes da camada de resiliência)
+    if (path == "/api/simulacao/falhas") {
+        std::string modulo = params.count("modulo") ? params.at("modulo") : "";
+        SimuladorFalhas* simulador = nullptr;
+        if (modulo == "financeiro") simulador = &g_modulo->getModuloFinanceiro()->getSimuladorFalhas();
+        else if (modulo == "producao") simulador = &g_modulo->getModuloProducao()->getSimuladorFalhas();
+        else if (modulo == "estoque") simulador = &g_modulo->getModuloEstoque()->getSimuladorFalhas();
+        if (!simulador) return httpResponse("{\"sucesso\":false,\"msg\":\"modulo deve ser financeiro, producao ou estoque\"}", 400);
+        try {
+            int atraso = params.count("atrasoMs") ? std::stoi(params.at("atrasoMs")) : 0;
+            bool falhar = params.count("falhar") && params.at("falhar") == "1";
+            simulador->configurar(atraso, falhar);
+        } catch (const std::exception& e) {
+            return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}", 400);
+        }
+        return httpResponse("{\"sucesso\":true}");
     }
 
     if (path == "/api/estoque/reservar") {
         int idMat = params.count("idMaterial") ? std::stoi(params.at("idMaterial")) : -1;
         int qtd = params.count("quantidade") ? std::stoi(params.at("quantidade")) : 0;
-        bool ok = g_modulo.reservarMaterial(idMat, qtd);
+        bool ok = g_modulo->reservarMaterial(idMat, qtd);
+        if (ok) {
+            g_modulo->ajustarProjecaoEstoque(idMat, -qtd);
+            salvarAjuste();
+        }
         return httpResponse(ok ? "{\"sucesso\":true}" : "{\"sucesso\":false}");
     }
 
+    if (path == "/api/estoque/reconstruir") return httpResponse(jsonVerificacaoEstoque(true));
+
     if (path == "/api/estoque/entrada") {
         int idMat = params.count("idMaterial") ? std::stoi(params.at("idMaterial")) : -1;
         int qtd = params.count("quantidade") ? std::stoi(params.at("quantidade")) : 0;
         int idOrdem = params.count("idOrdemCompra") ? std::stoi(params.at("idOrdemCompra")) : 0;
         std::string dataPrev = params.count("data_prevista") ? params.at("data_prevista") : nowString();
-        g_modulo.getModuloEstoque()->registrarEntradaCompra(idMat, qtd, idOrdem);
-        registrarPrevisto(idMat, qtd, idOrdem, dataPrev);
-        return httpResponse("{\"sucesso\":true}");
+        bool aplicada = false;
+        try {
+            g_modulo->getModuloEstoque()->registrarEntradaCompra(idMat, qtd, idOrdem, aplicada);
+        } catch (const std::exception& e) {
+            return httpResponse("{\"sucesso\":false,\"msg\":\"" + jsonEscape(e.what()) + "\"}");
+        }
+        // Como na reserva: a projeção só acompanha o que o estoque efetivamente aplicou
+        // (uma entrada repetida da mesma ordem é aceita, mas não soma de novo)
+        if (aplicada) {
+            g_modulo->ajustarProjecaoEstoque(idMat, qtd);
+            salvarAjuste();
+            registrarPrevisto(idMat, qtd, idOrdem, dataPrev);
+        }
+        return httpResponse(std::string("{\"sucesso\":true,\"aplicada\":") + (aplicada ? "true" : "false") + "}");
     }
 
     if (path == "/api/producao" || path == "/api/producao/pedido") {
@@ -520,6 +958,55 @@ std::string handlePost(const std::string& path, const std::map<std::string, std:
     return notFound();
 }
 
+// Status lido da linha "HTTP/1.1 NNN ..." da própria resposta
+int statusDaResposta(const std::string& resposta) {
+    return resposta.size() > 12 ? std::atoi(resposta.c_str() + 9) : 0;
+}
+
+// POSTs que criam registros aceitam uma chave de idempotência (cabeçalho Idempotency-Key
+// ou parâmetro idempotencyKey). A repetição com a mesma chave devolve a resposta original,
+// marcada com "Idempotent-Replayed: true", sem passar de novo pelo fluxo de aprovação.
+// Só são guardados os sucessos e as recusas da própria requisição (4xx); depois de uma
+// falha transitória (5xx) a repetição executa de novo.
+std::string handlePostIdempotente(const std::string& path, const std::map<std::string, std::string>& params,
+                                  const std::string& chave) {
+    if (chave.empty() || (path != "/api/ordens" && path != "/api/fornecedores")) return handlePost(path, params);
+
+    std::string assinatura = path;
+    for (const auto& p : params) {
+        if (p.first != "idempotencyKey") assinatura += "&" + p.first + "=" + p.second;
+    }
+    std::string guardada;
+    switch (g_idempotencia->consultar(path + " " + chave, assinatura, guardada)) {
+        case CacheIdempotencia::Consulta::REPETIDA: {
+            auto fimStatus = guardada.find("\r\n");
+            return guardada.insert(fimStatus + 2, "Idempotent-Replayed: true\r\n");
+        }
+        case CacheIdempotencia::Consulta::CONFLITANTE:
+            return httpResponse("{\"sucesso\":false,\"msg\":\"Idempotency-Key ja usada com outros parametros\"}", 422);
+        case CacheIdempotencia::Consulta::AUSENTE:
+            break;
+    }
+    std::string resposta = handlePost(path, params);
+    if (statusDaResposta(resposta) < 500) g_idempotencia->guardar(path + " " + chave, assinatura, resposta);
+    return resposta;
+}
+
+// Valor de um cabeçalho HTTP ('nome' em minúsculas; a busca ignora maiúsculas); vazio se ausente
+std::string lerCabecalho(const std::string& req, const std::string& nome) {
+    std::string cabecalhos = req.substr(0, req.find("\r\n\r\n"));
+    std::transform(cabecalhos.begin(), cabecalhos.end(), cabecalhos.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto pos = cabecalhos.find("\r\n" + nome + ":");
+    if (pos == std::string::npos) return "";
+    auto inicio = pos + nome.size() + 3;
+    auto fim = cabecalhos.find("\r\n", inicio);
+    std::string valor = req.substr(inicio, fim == std::string::npos ? cabecalhos.size() - inicio : fim - inicio);
+    valor.erase(0, valor.find_first_not_of(" \t"));
+    valor.erase(valor.find_last_not_of(" \t") + 1);
+    return valor;
+}
+
 std::pair<std::string, std::map<std::string, std::string>> parsePathAndParams(const std::string& pathWithQuery, const std::string& body) {
     auto pos = pathWithQuery.find('?');
     std::string path = (pos == std::string::npos) ? pathWithQuery : pathWithQuery.substr(0, pos);
@@ -532,7 +1019,33 @@ std::pair<std::string, std::map<std::string, std::string>> parsePathAndParams(co
     return {path, params};
 }
 
-void serve(int port) {
+// Abre a captura de requisições e copia os arquivos de dados, já carregados, para
+// "<arquivo>.dados/": o estado de partida para reproduzir a captura (tools/reprodutor_captura)
+void iniciarCaptura(const std::string& arquivo) {
+    namespace fs = std::filesystem;
+    fs::path pasta = arquivo + ".dados";
+    std::error_code erro;
+    fs::create_directories(pasta, erro);
+    for (const std::string& origem : {ARQ_FORNECEDORES, ARQ_ORDENS, ARQ_PRODUCAO, ARQ_ESTOQUE_PREV, ARQ_AJUSTES_ESTOQUE}) {
+        if (!fs::exists(origem)) continue;
+        fs::copy_file(origem, pasta / fs::path(origem).filename(), fs::copy_options::overwrite_existing, erro);
+        if (erro) LOG_AVISO("CAPTURA", "Nao foi possivel copiar " << origem << ": " << erro.message());
+    }
+    try {
+        g_captura = std::make_unique<CapturaRequisicoes>(arquivo);
+    } catch (const ComprasException& e) {
+        LOG_ERRO("CAPTURA", e.what() << " (servidor segue sem captura)");
+        return;
+    }
+    LOG_INFO("CAPTURA", "Gravando requisicoes em " << arquivo << " (dados iniciais em " << pasta.string() << ")");
+}
+
+void serve(int port, const ConfiguracaoCompras& config) {
+    g_modulo = std::make_unique<ModuloCompras>(config);
+    g_idempotencia = std::make_unique<CacheIdempotencia>(config.capacidadeIdempotencia,
+                                                         std::chrono::seconds(config.ttlIdempotenciaS));
+    g_gravadorConclusoes = std::make_unique<GravadorConclusoes>();
+
     if (!initSockets()) {
         std::cerr << "Erro ao inicializar sockets\n";
         return;
@@ -558,28 +1071,41 @@ void serve(int port) {
         return;
     }
 
-    if (listen(server_fd, 10) < 0) {
+    g_socketServidor = server_fd;
+    if (listen(server_fd, static_cast<int>(config.backlogConexoes)) < 0) {
         std::cerr << "Erro ao escutar\n";
         closeSocket(server_fd);
         return;
     }
 
     std::cout << "Servidor HTTP C++ na porta " << port << "\n";
-    std::cout << "Endpoints expostos: /api/status, /api/fornecedores, /api/ordens, /api/estoque, /api/estoque/previsto, /api/producao, /api/financeiro" << "\n";
+    std::cout << "Endpoints expostos: /api/status, /api/fornecedores, /api/ordens, /api/estoque, /api/estoque/previsto, /api/producao, /api/financeiro, /api/executor, /api/resiliencia" << "\n";
 
-    g_modulo.carregarTodosDados();
+    g_modulo->carregarTodosDados();
     carregarProducao();
     carregarPrevisto();
+    if (!config.arquivoCaptura.empty()) iniciarCaptura(config.arquivoCaptura);
 
     while (true) {
         sockaddr_in client{};
         socklen_arg len = static_cast<socklen_arg>(sizeof(client));
         socket_t client_fd = accept(server_fd, (sockaddr*)&client, &len);
-        if (client_fd < 0) continue;
+        if (client_fd < 0) {
+            g_metricas.conexoesDescartadas++;
+            continue;
+        }
+        auto inicio = HistogramaPrometheus::Relogio::now();
+        g_metricas.conexoesAceitas++;
+        amostrarFilaAccept(server_fd);
 
         char buffer[16384];
         int n = recv(client_fd, buffer, sizeof(buffer) - 1, 0);
-        if (n <= 0) { closeSocket(client_fd); continue; }
+        if (n <= 0) {
+            g_metricas.conexoesDescartadas++;
+            closeSocket(client_fd);
+            continue;
+        }
+        g_metricas.bytesRecebidos += static_cast<uint64_t>(n);
         buffer[n] = '\0';
         std::string req(buffer);
 
@@ -596,25 +1122,43 @@ void serve(int port) {
         const auto params = parsed.second;
 
         std::string response;
+        std::string chave;
         if (method == "OPTIONS") {
             response = httpResponse("", 204);
         } else if (method == "GET") {
             response = handleGet(cleanPath, params);
         } else if (method == "POST") {
-            response = handlePost(cleanPath, params);
+            chave = lerCabecalho(req, "idempotency-key");
+            if (chave.empty() && params.count("idempotencyKey")) chave = params.at("idempotencyKey");
+            response = handlePostIdempotente(cleanPath, params, chave);
         } else {
             response = notFound();
         }
 
-        send(client_fd, response.c_str(), response.size(), 0);
+        auto enviados = send(client_fd, response.c_str(), response.size(), 0);
+        if (enviados > 0) g_metricas.bytesEnviados += static_cast<uint64_t>(enviados);
+        if (enviados != static_cast<decltype(enviados)>(response.size())) g_metricas.conexoesDescartadas++;
         closeSocket(client_fd);
+        int status = statusDaResposta(response);
+        g_metricas.registrarRequisicao(method, cleanPath, status,
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           HistogramaPrometheus::Relogio::now() - inicio));
+        if (g_captura) g_captura->registrar(inicio, method, path, body, chave, response.size(), status);
     }
 }
 } // namespace
 
 #if SERVIDOR_STANDALONE
-int main() {
-    serve(8080);
+// Uso: servidor [--threads-integracao=N]
+int main(int argc, char** argv) {
+    ConfiguracaoCompras config;
+    try {
+        config = ConfiguracaoCompras::deArgumentos(argc, argv);
+    } catch (const ComprasException& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    serve(8080, config);
     return 0;
 }
 #endif // SERVIDOR_STANDALONE
@@ -0,0 +1,88 @@
+#ifndef CLIENTE_HTTP_H
+#define CLIENTE_HTTP_H
+
+// Cliente HTTP mínimo das ferramentas de carga (gerador_carga, reprodutor_captura):
+// uma requisição por conexão, que é como src/servidor.cpp atende.
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32")
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+#endif
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+inline bool initSockets() { WSADATA wsa; return WSAStartup(MAKEWORD(2, 2), &wsa) == 0; }
+inline void closeSocket(socket_t s) { closesocket(s); }
+inline bool socketValido(socket_t s) { return s != INVALID_SOCKET; }
+#else
+using socket_t = int;
+inline bool initSockets() { return true; }
+inline void closeSocket(socket_t s) { close(s); }
+inline bool socketValido(socket_t s) { return s >= 0; }
+#endif
+
+inline sockaddr_in enderecoServidor(const std::string& host, int porta) {
+    sockaddr_in destino{};
+    destino.sin_family = AF_INET;
+    destino.sin_port = htons(static_cast<uint16_t>(porta));
+    if (inet_pton(AF_INET, host.c_str(), &destino.sin_addr) != 1)
+        throw std::invalid_argument("--host deve ser um endereco IPv4: " + host);
+    return destino;
+}
+
+// Envia a requisição e lê a resposta até o servidor fechar a conexão.
+// Retorna o status HTTP, ou -1 se a conexão falhou.
+inline int executarRequisicao(const sockaddr_in& destino, const std::string& requisicao, std::string& resposta) {
+    socket_t s = socket(AF_INET, SOCK_STREAM, 0);
+    if (!socketValido(s)) return -1;
+#ifdef _WIN32
+    DWORD prazo = 10000;
+#else
+    timeval prazo{10, 0};
+#endif
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&prazo), sizeof(prazo));
+    int semAtraso = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&semAtraso), sizeof(semAtraso));
+    if (connect(s, reinterpret_cast<const sockaddr*>(&destino), sizeof(destino)) != 0) {
+        closeSocket(s);
+        return -1;
+    }
+    size_t enviado = 0;
+    while (enviado < requisicao.size()) {
+        auto n = send(s, requisicao.data() + enviado, static_cast<int>(requisicao.size() - enviado), 0);
+        if (n <= 0) {
+            closeSocket(s);
+            return -1;
+        }
+        enviado += static_cast<size_t>(n);
+    }
+    resposta.clear();
+    char buffer[65536];
+    while (true) {
+        auto n = recv(s, buffer, sizeof(buffer), 0);
+        if (n < 0) {
+            closeSocket(s);
+            return -1;
+        }
+        if (n == 0) break;
+        resposta.append(buffer, static_cast<size_t>(n));
+    }
+    closeSocket(s);
+    if (resposta.size() < 12 || resposta.compare(0, 5, "HTTP/") != 0) return -1;
+    return std::atoi(resposta.c_str() + 9);
+}
+
+#endif // CLIENTE_HTTP_H
@@ -0,0 +1,42 @@
+#!/bin/bash
+# Teste de vazão ponta a ponta: compila servidor e gerador de carga, sobe o
+# servidor com os módulos simulados sem latência (--latencia=zero) numa cópia
+# dos dados, roda a carga e encerra o servidor.
+# Uso: ./tools/carga_e2e.sh [--ordens-geradas=N] [opções do gerador_carga...]
+#   --ordens-geradas=N  usa dados sintéticos (gerador_dados) em vez de data/
+set -e
+cd "$(dirname "$0")/.."
+RAIZ="$(pwd)"
+
+ORDENS_GERADAS=""
+ARGS=()
+for arg in "$@"; do
+    case "$arg" in
+        --ordens-geradas=*) ORDENS_GERADAS="${arg#*=}" ;;
+        *) ARGS+=("$arg") ;;
+    esac
+done
+
+./tools/compilar_ferramentas.sh
+FONTES="src/ModuloCompras.cpp src/GerenciadorFornecedores.cpp src/GerenciadorOrdens.cpp src/PersistenciaCompras.cpp"
+echo "🔨 Compilando servidor..."
+g++ -std=c++17 -O2 -pthread -Iinclude src/servidor.cpp $FONTES -o build/http_server_carga
+
+TRABALHO="$(mktemp -d)"
+trap 'kill $PID_SERVIDOR 2>/dev/null || true; wait $PID_SERVIDOR 2>/dev/null || true; rm -rf "$TRABALHO"' EXIT
+mkdir -p "$TRABALHO/data"
+if [ -n "$ORDENS_GERADAS" ]; then
+    ./build/gerador_dados --saida="$TRABALHO/data" --ordens="$ORDENS_GERADAS" --fornecedores=4
+else
+    cp data/fornecedores.txt data/ordens.txt "$TRABALHO/data/"
+fi
+
+echo "🚀 Iniciando servidor (--latencia=zero, log em $TRABALHO/servidor.log)..."
+(cd "$TRABALHO" && exec "$RAIZ/build/http_server_carga" --latencia=zero --log-nivel=aviso > servidor.log 2>&1) &
+PID_SERVIDOR=$!
+for _ in $(seq 1 100); do
+    if (exec 3<>/dev/tcp/127.0.0.1/8080) 2>/dev/null; then break; fi
+    sleep 0.1
+done
+
+./build/gerador_carga "${ARGS[@]}"
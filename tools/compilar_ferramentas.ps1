@@ -0,0 +1,25 @@
+# PowerShell script to compile the scale-testing tools on Windows (output in build/)
+$ErrorActionPreference = 'Stop'
+
+# Go to repo root (parent of the script directory)
+Set-Location -Path (Join-Path $PSScriptRoot "..")
+
+New-Item -ItemType Directory -Force -Path "build" | Out-Null
+
+Write-Host "🔨 Compilando gerador_dados..."
+& g++ -std=c++17 -O2 -Iinclude tools/gerador_dados.cpp -o build/gerador_dados.exe
+
+Write-Host "🔨 Compilando gerador_carga..."
+& g++ -std=c++17 -O2 -Iinclude tools/gerador_carga.cpp -lws2_32 -o build/gerador_carga.exe
+
+Write-Host "🔨 Compilando reprodutor_captura..."
+& g++ -std=c++17 -O2 -Iinclude tools/reprodutor_captura.cpp -lws2_32 -o build/reprodutor_captura.exe
+
+Write-Host "🔨 Compilando estresse_concorrencia..."
+$src = Get-ChildItem -Path "src" -Filter "*.cpp" | Where-Object { $_.Name -ne "main.cpp" -and $_.Name -ne "servidor.cpp" } | ForEach-Object { $_.FullName }
+& g++ -std=c++17 -O2 -Iinclude tools/estresse_concorrencia.cpp $src -o build/estresse_concorrencia.exe
+
+Write-Host "🔨 Compilando teste_resiliencia..."
+& g++ -std=c++17 -O2 -Iinclude tools/teste_resiliencia.cpp -o build/teste_resiliencia.exe
+
+Write-Host "✅ Ferramentas em build/"
@@ -0,0 +1,24 @@
+#!/bin/bash
+# Compila as ferramentas de teste de escala em build/
+# Uso: ./tools/compilar_ferramentas.sh && ./build/gerador_dados --ordens=1000000
+set -e
+cd "$(dirname "$0")/.."
+
+mkdir -p build
+echo "🔨 Compilando gerador_dados..."
+g++ -std=c++17 -O2 -Iinclude tools/gerador_dados.cpp -o build/gerador_dados
+
+echo "🔨 Compilando gerador_carga..."
+g++ -std=c++17 -O2 -pthread -Iinclude tools/gerador_carga.cpp -o build/gerador_carga
+
+echo "🔨 Compilando reprodutor_captura..."
+g++ -std=c++17 -O2 -pthread -Iinclude tools/reprodutor_captura.cpp -o build/reprodutor_captura
+
+echo "🔨 Compilando estresse_concorrencia..."
+SRC=$(ls src/*.cpp | grep -v -e main.cpp -e servidor.cpp)
+g++ -std=c++17 -O2 -pthread -Iinclude tools/estresse_concorrencia.cpp $SRC -o build/estresse_concorrencia
+
+echo "🔨 Compilando teste_resiliencia..."
+g++ -std=c++17 -O2 -pthread -Iinclude tools/teste_resiliencia.cpp -o build/teste_resiliencia
+
+echo "✅ Ferramentas em build/"
@@ -0,0 +1,404 @@
+// Teste de estresse de concorrência do ModuloCompras, dentro do processo: várias
+// threads repetindo uma mistura de operações sobre o mesmo módulo, com os módulos
+// simulados sem latência (a medição é das estruturas e dos locks, não das esperas).
+// Roda uma rodada por quantidade de threads em --threads e mostra ops/s e p50/p99
+// por operação, para ver como cada uma escala; no fim de cada rodada confere os
+// invariantes (IDs únicos, contagens, ida e volta pelo disco).
+//
+// Operações (pesos em --mix=criar:30,fornecedor:5,buscar:30,listar:15,resumo:10,periodo:8,salvar:1,carregar:1):
+//   criar       submeterOrdemCompra (aprovação segue no executor, sem esperar)
+//   fornecedor  adicionarFornecedor
+//   buscar      copiarOrdemPorId e copiarFornecedorPorId
+//   listar      percorre as listas de ordens e fornecedores sob os mutexes
+//   resumo      obterResumoOrdens
+//   periodo     consultarOrdensPorPeriodo (última hora, 50 por página)
+//   salvar      salvarTodosDados
+//   carregar    carregarTodosDados (volta ao último salvamento: ordens somem da lista)
+//
+// Cada rodada usa um diretório próprio (data/ dentro de --dir) e um ModuloCompras novo.
+// Para rodar sob ThreadSanitizer: ./tools/estresse_tsan.sh
+//
+// Compilação (a partir da raiz): ./tools/compilar_ferramentas.sh  (ou .ps1 no Windows)
+// Uso: ./build/estresse_concorrencia [--threads=1,2,4,8] [--duracao-s=2] [--fornecedores=16]
+//        [--mix=...] [--semente=42] [--dir=estresse_tmp] [--saida=arquivo.json] [--rotulo=texto]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HistogramaLatencia.h"
+#include "ModuloCompras.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+enum Operacao { CRIAR = 0, FORNECEDOR, BUSCAR, LISTAR, RESUMO, PERIODO, SALVAR, CARREGAR, TOTAL_OPERACOES };
+
+const char* nomeOperacao(int op) {
+    static const char* nomes[] = {"criar", "fornecedor", "buscar", "listar", "resumo",
+                                  "periodo", "salvar", "carregar", "total"};
+    return nomes[op];
+}
+
+struct OpcoesEstresse {
+    std::vector<int> threads = {1, 2, 4, 8};
+    double duracaoS = 2.0;
+    int fornecedores = 16;        ///< Fornecedores criados antes da rodada (alvo das ordens)
+    double pesos[TOTAL_OPERACOES] = {30, 5, 30, 15, 10, 8, 1, 1};
+    uint64_t semente = 42;
+    std::string dir = "estresse_tmp";
+    std::string saida;
+    std::string rotulo;
+};
+
+// Contadores de uma thread (um escritor; somados no final, depois do join)
+struct ResultadoThread {
+    HistogramaLatencia latencia[TOTAL_OPERACOES];
+    uint64_t concluidas[TOTAL_OPERACOES] = {};
+    uint64_t falhas[TOTAL_OPERACOES] = {};       ///< ComprasException (ex: fornecedor sumiu num carregar)
+    uint64_t ordensCriadas = 0;
+};
+
+struct ResumoRodada {
+    int threads = 0;
+    HistogramaLatencia::Acumulado acumulados[TOTAL_OPERACOES + 1];
+    uint64_t concluidas[TOTAL_OPERACOES + 1] = {};
+    uint64_t falhas[TOTAL_OPERACOES + 1] = {};
+    std::vector<std::string> violacoes;
+};
+
+class RodadaEstresse {
+private:
+    const OpcoesEstresse& opcoes;
+    int numThreads;
+    ModuloCompras modulo;
+    Relogio::time_point inicio;
+    Relogio::time_point fim;
+    std::vector<ResultadoThread> resultados;
+    std::atomic<int> maiorIdOrdem{0};         ///< Maior ID devolvido por criar (alvo de buscar)
+
+    static ConfiguracaoCompras configuracao() {
+        ConfiguracaoCompras config;
+        config.latenciaModulos.tipo = TipoLatencia::ZERO;
+        config.nivelLog = NivelLog::ERRO;
+        return config;
+    }
+
+    void executarOperacao(int op, int indiceThread, uint64_t sequencia, std::mt19937_64& gerador,
+                          ResultadoThread& res) {
+        switch (op) {
+        case CRIAR: {
+            int idFornecedor = 1 + static_cast<int>(gerador() % static_cast<uint64_t>(opcoes.fornecedores));
+            SubmissaoOrdem s = modulo.submeterOrdemCompra(
+                1001 + static_cast<int>(gerador() % 200), 1 + static_cast<int>(gerador() % 100),
+                Dinheiro::deCentavos(100 + static_cast<int64_t>(gerador() % 5000)), idFornecedor);
+            res.ordensCriadas++;
+            int anterior = maiorIdOrdem.load(std::memory_order_relaxed);
+            while (anterior < s.idOrdem &&
+                   !maiorIdOrdem.compare_exchange_weak(anterior, s.idOrdem, std::memory_order_relaxed)) {}
+            break;
+        }
+        case FORNECEDOR: {
+            std::ostringstream cnpj;
+            cnpj << "88." << std::setw(3) << std::setfill('0') << indiceThread % 1000 << "."
+                 << std::setw(3) << sequencia / 10000 % 1000 << "/" << std::setw(4) << sequencia % 10000 << "-00";
+            modulo.adicionarFornecedor("Estresse " + std::to_string(indiceThread) + "-" + std::to_string(sequencia),
+                                       "Rua do Estresse", cnpj.str(), "Item " + std::to_string(gerador() % 50),
+                                       Dinheiro::deCentavos(100 + static_cast<int64_t>(gerador() % 50000)));
+            break;
+        }
+        case BUSCAR: {
+            int limite = std::max(1, maiorIdOrdem.load(std::memory_order_relaxed));
+            OrdemCompra ordem;
+            Fornecedor fornecedor;
+            naoDescartar(modulo.copiarOrdemPorId(1 + static_cast<int>(gerador() % static_cast<uint64_t>(limite)), ordem));
+            naoDescartar(modulo.copiarFornecedorPorId(
+                1 + static_cast<int>(gerador() % static_cast<uint64_t>(opcoes.fornecedores)), fornecedor));
+            break;
+        }
+        case LISTAR: {
+            long long quantidade = 0;
+            modulo.comListaOrdens([&quantidade](const ListaGenerica<OrdemCompra>& ordens) {
+                for (size_t i = 0; i < ordens.obterTamanho(); i++) quantidade += ordens.obter(i).getQuantidade();
+            });
+            modulo.comListaFornecedores([&quantidade](const ListaGenerica<Fornecedor>& fornecedores) {
+                for (size_t i = 0; i < fornecedores.obterTamanho(); i++) quantidade += fornecedores.obter(i).getId();
+            });
+            naoDescartar(quantidade != 0);
+            break;
+        }
+        case RESUMO:
+            naoDescartar(modulo.obterResumoOrdens().totalOrdens != 0);
+            break;
+        case PERIODO: {
+            int64_t agora = static_cast<int64_t>(std::time(nullptr));
+            PaginaOrdens pagina = modulo.consultarOrdensPorPeriodo(CampoData::SOLICITACAO, agora - 3600, agora + 60,
+                                                                   nullptr, 50);
+            naoDescartar(pagina.ordens.empty());
+            break;
+        }
+        case SALVAR:
+            modulo.salvarTodosDados();
+            break;
+        case CARREGAR:
+            modulo.carregarTodosDados();
+            break;
+        }
+    }
+
+    // Impede que o compilador elimine leituras cujo resultado não é usado
+    static void naoDescartar(bool valor) {
+        static std::atomic<int> sorvedouro{0};
+        if (valor) sorvedouro.fetch_add(0, std::memory_order_relaxed);
+    }
+
+    void trabalhar(int indiceThread) {
+        ResultadoThread& res = resultados[indiceThread];
+        std::mt19937_64 gerador(opcoes.semente + static_cast<uint64_t>(indiceThread) * 7919);
+        std::discrete_distribution<int> mix(opcoes.pesos, opcoes.pesos + TOTAL_OPERACOES);
+        for (uint64_t sequencia = 0;; sequencia++) {
+            auto antes = Relogio::now();
+            if (antes >= fim) break;
+            int op = mix(gerador);
+            try {
+                executarOperacao(op, indiceThread, sequencia, gerador, res);
+            } catch (const ComprasException&) {
+                res.falhas[op]++;
+            }
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - antes).count();
+            res.concluidas[op]++;
+            res.latencia[op].registrar(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+        }
+    }
+
+    // Depois do join: IDs únicos e, sem carregar no mix, nenhuma ordem perdida;
+    // por fim salva e relê para conferir a ida e volta pelo disco.
+    void verificarInvariantes(ResumoRodada& resumo) {
+        // O executor ainda pode estar aprovando as últimas ordens: espera a fila esvaziar
+        // e as conclusões pararem (ordens PENDENTES vindas de um carregar não têm tarefa)
+        auto prazo = Relogio::now() + std::chrono::seconds(30);
+        uint64_t concluidasAntes = modulo.obterMetricasExecutor().tarefasConcluidas;
+        while (Relogio::now() < prazo) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            ExecutorIntegracao::Metricas m = modulo.obterMetricasExecutor();
+            if (m.profundidadeFila == 0 && m.tarefasConcluidas == concluidasAntes) break;
+            concluidasAntes = m.tarefasConcluidas;
+        }
+
+        std::set<int> ids;
+        size_t ordens = 0;
+        modulo.comListaOrdens([&](const ListaGenerica<OrdemCompra>& lista) {
+            ordens = lista.obterTamanho();
+            for (size_t i = 0; i < lista.obterTamanho(); i++) {
+                if (!ids.insert(lista.obter(i).getIdTransacao()).second)
+                    resumo.violacoes.push_back("ID de ordem repetido: " + std::to_string(lista.obter(i).getIdTransacao()));
+            }
+        });
+        std::set<int> idsFornecedores;
+        modulo.comListaFornecedores([&](const ListaGenerica<Fornecedor>& lista) {
+            for (size_t i = 0; i < lista.obterTamanho(); i++) {
+                if (!idsFornecedores.insert(lista.obter(i).getId()).second)
+                    resumo.violacoes.push_back("ID de fornecedor repetido: " + std::to_string(lista.obter(i).getId()));
+            }
+        });
+
+        uint64_t criadas = 0;
+        for (const ResultadoThread& r : resultados) criadas += r.ordensCriadas;
+        if (opcoes.pesos[CARREGAR] == 0 && ordens != criadas) {
+            resumo.violacoes.push_back("Ordens na lista (" + std::to_string(ordens) + ") diferem das criadas (" +
+                                       std::to_string(criadas) + ")");
+        }
+
+        size_t fornecedores = modulo.obterQuantidadeFornecedores();
+        modulo.salvarTodosDados();
+        modulo.carregarTodosDados();
+        if (modulo.obterQuantidadeOrdens() != ordens || modulo.obterQuantidadeFornecedores() != fornecedores) {
+            resumo.violacoes.push_back("Salvar e carregar mudou as contagens (ordens " + std::to_string(ordens) + " -> " +
+                                       std::to_string(modulo.obterQuantidadeOrdens()) + ", fornecedores " +
+                                       std::to_string(fornecedores) + " -> " +
+                                       std::to_string(modulo.obterQuantidadeFornecedores()) + ")");
+        }
+    }
+
+public:
+    RodadaEstresse(const OpcoesEstresse& opcoes, int numThreads)
+        : opcoes(opcoes), numThreads(numThreads), modulo(configuracao()), resultados(numThreads) {
+        for (int i = 1; i <= opcoes.fornecedores; i++) {
+            std::ostringstream cnpj;
+            cnpj << "77.000.000/" << std::setw(4) << std::setfill('0') << i << "-00";
+            modulo.adicionarFornecedor("Base " + std::to_string(i), "Rua Base", cnpj.str(), "Item " + std::to_string(i),
+                                       Dinheiro::deCentavos(1000 + i));
+        }
+        // Todo salvamento (e portanto todo carregar) contém os fornecedores base
+        modulo.salvarTodosDados();
+    }
+
+    ResumoRodada executar() {
+        inicio = Relogio::now() + std::chrono::milliseconds(50);   // Todas as threads partem juntas
+        fim = inicio + std::chrono::duration_cast<Relogio::duration>(std::chrono::duration<double>(opcoes.duracaoS));
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; i++) {
+            threads.emplace_back([this, i] {
+                std::this_thread::sleep_until(inicio);
+                trabalhar(i);
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        ResumoRodada resumo;
+        resumo.threads = numThreads;
+        for (const ResultadoThread& r : resultados) {
+            for (int op = 0; op < TOTAL_OPERACOES; op++) {
+                r.latencia[op].somarEm(resumo.acumulados[op]);
+                r.latencia[op].somarEm(resumo.acumulados[TOTAL_OPERACOES]);
+                resumo.concluidas[op] += r.concluidas[op];
+                resumo.falhas[op] += r.falhas[op];
+                resumo.concluidas[TOTAL_OPERACOES] += r.concluidas[op];
+                resumo.falhas[TOTAL_OPERACOES] += r.falhas[op];
+            }
+        }
+        verificarInvariantes(resumo);
+        return resumo;
+    }
+};
+
+// Tabela no terminal e JSON com todas as rodadas
+void relatar(const OpcoesEstresse& opcoes, const std::vector<ResumoRodada>& rodadas) {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3) << "{\n  \"rotulo\": \"" << opcoes.rotulo
+         << "\",\n  \"duracaoS\": " << opcoes.duracaoS << ",\n  \"rodadas\": [\n";
+    for (size_t k = 0; k < rodadas.size(); k++) {
+        const ResumoRodada& rodada = rodadas[k];
+        std::cout << "\n" << rodada.threads << " thread(s), " << opcoes.duracaoS << " s\n"
+                  << std::left << std::setw(12) << "operacao" << std::right << std::setw(10) << "ops"
+                  << std::setw(12) << "ops/s" << std::setw(8) << "falhas" << std::setw(11) << "p50 us"
+                  << std::setw(11) << "p99 us" << std::setw(11) << "max us" << "\n";
+        json << "    {\"threads\": " << rodada.threads << ", \"violacoes\": " << rodada.violacoes.size()
+             << ", \"operacoes\": [\n";
+        for (int op = 0; op <= TOTAL_OPERACOES; op++) {
+            HistogramaLatencia::Resumo r = rodada.acumulados[op].resumir();
+            double porSegundo = rodada.concluidas[op] / opcoes.duracaoS;
+            std::cout << std::left << std::setw(12) << nomeOperacao(op) << std::right << std::setw(10)
+                      << rodada.concluidas[op] << std::fixed << std::setprecision(0) << std::setw(12) << porSegundo
+                      << std::setw(8) << rodada.falhas[op] << std::setprecision(1) << std::setw(11) << r.p50Us
+                      << std::setw(11) << r.p99Us << std::setw(11) << r.maximoUs << "\n";
+            json << "      {\"operacao\": \"" << nomeOperacao(op) << "\", \"ops\": " << rodada.concluidas[op]
+                 << ", \"porSegundo\": " << porSegundo << ", \"falhas\": " << rodada.falhas[op]
+                 << ", \"p50Us\": " << r.p50Us << ", \"p99Us\": " << r.p99Us << ", \"maximoUs\": " << r.maximoUs
+                 << "}" << (op < TOTAL_OPERACOES ? "," : "") << "\n";
+        }
+        json << "    ]}" << (k + 1 < rodadas.size() ? "," : "") << "\n";
+        for (const std::string& v : rodada.violacoes) std::cout << "VIOLACAO: " << v << "\n";
+    }
+    json << "  ]\n}\n";
+
+    if (!opcoes.saida.empty()) {
+        std::ofstream f(opcoes.saida);
+        if (!f.is_open()) std::cerr << "Nao foi possivel gravar " << opcoes.saida << "\n";
+        f << json.str();
+    }
+}
+
+void lerMix(const std::string& texto, double pesos[TOTAL_OPERACOES]) {
+    std::fill(pesos, pesos + TOTAL_OPERACOES, 0.0);
+    std::stringstream ss(texto);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        auto pos = item.find(':');
+        if (pos == std::string::npos) throw std::invalid_argument("--mix espera nome:peso, recebeu '" + item + "'");
+        std::string nome = item.substr(0, pos);
+        double peso = std::stod(item.substr(pos + 1));
+        int op = 0;
+        while (op < TOTAL_OPERACOES && nome != nomeOperacao(op)) op++;
+        if (op == TOTAL_OPERACOES) throw std::invalid_argument("Operacao desconhecida em --mix: '" + nome + "'");
+        if (peso < 0) throw std::invalid_argument("Peso negativo em --mix");
+        pesos[op] = peso;
+    }
+    if (std::all_of(pesos, pesos + TOTAL_OPERACOES, [](double p) { return p <= 0; }))
+        throw std::invalid_argument("--mix precisa de ao menos um peso positivo");
+}
+
+std::vector<int> lerListaThreads(const std::string& texto) {
+    std::vector<int> lista;
+    std::stringstream ss(texto);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int n = std::stoi(item);
+        if (n < 1 || n > 1024) throw std::invalid_argument("--threads: cada valor deve estar entre 1 e 1024");
+        lista.push_back(n);
+    }
+    if (lista.empty()) throw std::invalid_argument("--threads vazio");
+    return lista;
+}
+
+OpcoesEstresse lerOpcoes(int argc, char** argv) {
+    OpcoesEstresse o;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto comeca = [&](const char* prefixo) { return arg.rfind(prefixo, 0) == 0; };
+        std::string valor = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (comeca("--threads=")) o.threads = lerListaThreads(valor);
+        else if (comeca("--duracao-s=")) o.duracaoS = std::stod(valor);
+        else if (comeca("--fornecedores=")) o.fornecedores = std::stoi(valor);
+        else if (comeca("--mix=")) lerMix(valor, o.pesos);
+        else if (comeca("--semente=")) o.semente = std::stoull(valor);
+        else if (comeca("--dir=")) o.dir = valor;
+        else if (comeca("--saida=")) o.saida = valor;
+        else if (comeca("--rotulo=")) o.rotulo = valor;
+        else throw std::invalid_argument("Opcao desconhecida: " + arg);
+    }
+    if (o.duracaoS <= 0) throw std::invalid_argument("--duracao-s deve ser positiva");
+    if (o.fornecedores < 1) throw std::invalid_argument("--fornecedores deve ser ao menos 1");
+    if (o.dir.empty()) throw std::invalid_argument("--dir vazio");
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    try {
+        OpcoesEstresse opcoes = lerOpcoes(argc, argv);
+        if (!opcoes.saida.empty()) opcoes.saida = fs::absolute(opcoes.saida).string();
+        const fs::path base = fs::absolute(opcoes.dir);
+        const fs::path original = fs::current_path();
+
+        std::vector<ResumoRodada> rodadas;
+        size_t violacoes = 0;
+        for (int n : opcoes.threads) {
+            // PersistenciaCompras e a caixa de saída usam caminhos relativos (data/...)
+            fs::path dirRodada = base / ("threads_" + std::to_string(n));
+            fs::remove_all(dirRodada);
+            fs::create_directories(dirRodada / "data");
+            fs::current_path(dirRodada);
+            {
+                RodadaEstresse rodada(opcoes, n);
+                rodadas.push_back(rodada.executar());
+            }
+            fs::current_path(original);
+            violacoes += rodadas.back().violacoes.size();
+        }
+        relatar(opcoes, rodadas);
+        if (violacoes > 0) {
+            std::cerr << violacoes << " violacao(oes) de invariantes\n";
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
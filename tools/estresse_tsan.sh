@@ -0,0 +1,19 @@
+#!/bin/bash
+# Compila o teste de estresse com ThreadSanitizer e roda uma rodada curta por
+# quantidade de threads; qualquer corrida de dados encerra com erro.
+# Uso: ./tools/estresse_tsan.sh [opções do estresse_concorrencia, ex: --threads=2,8 --duracao-s=3]
+set -e
+cd "$(dirname "$0")/.."
+
+mkdir -p build
+SRC=$(ls src/*.cpp | grep -v -e main.cpp -e servidor.cpp)
+echo "🔨 Compilando estresse_concorrencia com -fsanitize=thread..."
+g++ -std=c++17 -O1 -g -fsanitize=thread -pthread -Iinclude tools/estresse_concorrencia.cpp $SRC \
+    -o build/estresse_concorrencia_tsan
+
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+echo "🧵 Rodando sob ThreadSanitizer..."
+TSAN_OPTIONS="halt_on_error=1 exitcode=66 ${TSAN_OPTIONS}" \
+    ./build/estresse_concorrencia_tsan --threads=2,4,8 --duracao-s=1 --dir="$DIR" "$@"
+echo "✅ Nenhuma corrida de dados detectada"
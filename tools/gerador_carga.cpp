@@ -0,0 +1,301 @@
+// Gerador de carga HTTP para o servidor (src/servidor.cpp): várias conexões
+// simultâneas repetindo uma mistura de operações, com vazão e latências
+// (p50/p90/p99/p99.9) por operação no final.
+//
+// Operações (pesos em --mix=painel:90,fornecedor:2,ordem:8):
+//   painel      GET nos seis endpoints que a interface (index.html) consulta, em rodízio
+//   fornecedor  POST /api/fornecedores
+//   ordem       POST /api/ordens (com --fornecedores=N, IDs de fornecedor entre 1 e N)
+// Modos:
+//   --modo=fechado  cada conexão envia a próxima requisição assim que recebe a resposta
+//   --modo=aberto   requisições agendadas a --taxa=R por segundo, independente das respostas;
+//                   a latência conta a partir do horário agendado, então a fila que se forma
+//                   quando o servidor não acompanha aparece nos percentis
+// O servidor deve rodar com --latencia=zero para que a medição seja do próprio servidor e
+// não dos módulos simulados (tools/carga_e2e.sh já faz isso).
+//
+// Compilação (a partir da raiz): ./tools/compilar_ferramentas.sh  (ou .ps1 no Windows)
+// Uso: ./build/gerador_carga [--host=127.0.0.1] [--porta=8080] [--conexoes=16] [--duracao-s=10]
+//        [--aquecimento-s=2] [--modo=fechado|aberto] [--taxa=1000] [--mix=painel:90,fornecedor:2,ordem:8]
+//        [--fornecedores=4] [--semente=42] [--saida=arquivo.json] [--rotulo=texto]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ClienteHttp.h"
+#include "HistogramaLatencia.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+enum Operacao { PAINEL = 0, FORNECEDOR, ORDEM, TOTAL_OPERACOES };
+
+const char* nomeOperacao(int op) {
+    static const char* nomes[] = {"painel", "fornecedor", "ordem", "total"};
+    return nomes[op];
+}
+
+// Os seis endpoints que interface/index.html consulta a cada atualização
+const char* ENDPOINTS_PAINEL[] = {"/api/estoque",  "/api/estoque/previsto", "/api/fornecedores",
+                                  "/api/ordens",   "/api/producao",         "/api/financeiro"};
+
+struct OpcoesCarga {
+    std::string host = "127.0.0.1";
+    int porta = 8080;
+    int conexoes = 16;
+    double duracaoS = 10.0;
+    double aquecimentoS = 2.0;    ///< Início descartado (caches, executor, alocador)
+    bool abertoLoop = false;
+    double taxa = 1000.0;         ///< Requisições por segundo no modo aberto
+    double pesos[TOTAL_OPERACOES] = {90, 2, 8};
+    int fornecedores = 4;         ///< IDs de fornecedor usados nas ordens (1..N)
+    uint64_t semente = 42;
+    std::string saida;
+    std::string rotulo;
+};
+
+// Contadores de uma thread (um escritor; somados no final, depois do join)
+struct ResultadoThread {
+    HistogramaLatencia latencia[TOTAL_OPERACOES];
+    uint64_t concluidas[TOTAL_OPERACOES] = {};
+    uint64_t falhas[TOTAL_OPERACOES] = {};       ///< Status fora de 2xx ou "sucesso":false
+    uint64_t errosConexao[TOTAL_OPERACOES] = {};
+    uint64_t bytesRecebidos = 0;
+    uint64_t atrasadas = 0;                      ///< Modo aberto: começaram mais de 1 ms após o agendado
+};
+
+class GeradorCarga {
+private:
+    const OpcoesCarga& opcoes;
+    sockaddr_in destino;
+    Relogio::time_point inicio;
+    Relogio::time_point inicioMedicao;
+    Relogio::time_point fim;
+    std::atomic<uint64_t> proximaAgendada{0};   ///< Modo aberto: próxima requisição da agenda global
+    std::vector<ResultadoThread> resultados;
+
+    std::string montarRequisicao(int op, int indiceThread, uint64_t sequencia, std::mt19937_64& gerador,
+                                 size_t& rodizio) const {
+        std::ostringstream r;
+        if (op == PAINEL) {
+            r << "GET " << ENDPOINTS_PAINEL[rodizio++ % 6] << " HTTP/1.1\r\n";
+        } else if (op == FORNECEDOR) {
+            // CNPJ e nome únicos por thread/sequência para não colidir entre conexões
+            r << "POST /api/fornecedores?nome=Carga+" << indiceThread << "-" << sequencia
+              << "&cnpj=99." << std::setw(3) << std::setfill('0') << indiceThread % 1000 << "."
+              << std::setw(3) << sequencia / 1000 % 1000 << "/" << std::setw(4) << sequencia % 10000 << "-00"
+              << "&endereco=Rua+da+Carga%2C+" << sequencia << "&produto=Item+" << gerador() % 50
+              << "&preco=" << 1 + gerador() % 500 << "." << std::setw(2) << gerador() % 100 << " HTTP/1.1\r\n";
+        } else {
+            r << "POST /api/ordens?idFornecedor=" << 1 + gerador() % opcoes.fornecedores << "&idItem="
+              << 1001 + gerador() % 200 << "&quantidade=" << 1 + gerador() % 100 << "&valor=" << 1 + gerador() % 50
+              << "." << std::setw(2) << std::setfill('0') << gerador() % 100 << " HTTP/1.1\r\n";
+        }
+        r << "Host: " << opcoes.host << "\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+        return r.str();
+    }
+
+    void trabalhar(int indiceThread) {
+        ResultadoThread& res = resultados[indiceThread];
+        std::mt19937_64 gerador(opcoes.semente + static_cast<uint64_t>(indiceThread) * 7919);
+        std::discrete_distribution<int> mix(opcoes.pesos, opcoes.pesos + TOTAL_OPERACOES);
+        std::string resposta;
+        size_t rodizio = static_cast<size_t>(indiceThread);
+        const auto intervalo = std::chrono::duration<double>(1.0 / opcoes.taxa);
+
+        for (uint64_t sequencia = 0;; sequencia++) {
+            Relogio::time_point referencia;   // De onde a latência é contada
+            if (opcoes.abertoLoop) {
+                uint64_t k = proximaAgendada.fetch_add(1, std::memory_order_relaxed);
+                referencia = inicio + std::chrono::duration_cast<Relogio::duration>(intervalo * static_cast<double>(k));
+                if (referencia >= fim) break;
+                std::this_thread::sleep_until(referencia);
+                if (Relogio::now() - referencia > std::chrono::milliseconds(1) && referencia >= inicioMedicao)
+                    res.atrasadas++;
+            } else {
+                referencia = Relogio::now();
+                if (referencia >= fim) break;
+            }
+
+            int op = mix(gerador);
+            std::string requisicao = montarRequisicao(op, indiceThread, sequencia, gerador, rodizio);
+            int status = executarRequisicao(destino, requisicao, resposta);
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - referencia).count();
+            if (referencia < inicioMedicao) continue;
+
+            res.concluidas[op]++;
+            res.bytesRecebidos += resposta.size();
+            if (status < 0) {
+                res.errosConexao[op]++;
+                continue;
+            }
+            if (status < 200 || status >= 300 || resposta.find("\"sucesso\":false") != std::string::npos)
+                res.falhas[op]++;
+            res.latencia[op].registrar(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+        }
+    }
+
+public:
+    explicit GeradorCarga(const OpcoesCarga& opcoes)
+        : opcoes(opcoes), destino(enderecoServidor(opcoes.host, opcoes.porta)), resultados(opcoes.conexoes) {}
+
+    void executar() {
+        inicio = Relogio::now() + std::chrono::milliseconds(50);   // Todas as threads partem juntas
+        inicioMedicao = inicio + std::chrono::duration_cast<Relogio::duration>(
+                                     std::chrono::duration<double>(opcoes.aquecimentoS));
+        fim = inicioMedicao + std::chrono::duration_cast<Relogio::duration>(
+                                  std::chrono::duration<double>(opcoes.duracaoS));
+        std::vector<std::thread> threads;
+        for (int i = 0; i < opcoes.conexoes; i++) {
+            threads.emplace_back([this, i] {
+                std::this_thread::sleep_until(inicio);
+                trabalhar(i);
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    // Soma as threads e escreve a tabela no terminal (e o JSON, se pedido)
+    void relatar() const {
+        HistogramaLatencia::Acumulado acumulados[TOTAL_OPERACOES + 1];
+        uint64_t concluidas[TOTAL_OPERACOES + 1] = {}, falhas[TOTAL_OPERACOES + 1] = {},
+                 errosConexao[TOTAL_OPERACOES + 1] = {};
+        uint64_t bytes = 0, atrasadas = 0;
+        for (const ResultadoThread& r : resultados) {
+            for (int op = 0; op < TOTAL_OPERACOES; op++) {
+                r.latencia[op].somarEm(acumulados[op]);
+                r.latencia[op].somarEm(acumulados[TOTAL_OPERACOES]);
+                concluidas[op] += r.concluidas[op];
+                falhas[op] += r.falhas[op];
+                errosConexao[op] += r.errosConexao[op];
+                concluidas[TOTAL_OPERACOES] += r.concluidas[op];
+                falhas[TOTAL_OPERACOES] += r.falhas[op];
+                errosConexao[TOTAL_OPERACOES] += r.errosConexao[op];
+            }
+            bytes += r.bytesRecebidos;
+            atrasadas += r.atrasadas;
+        }
+
+        std::ostringstream os;
+        os << "Modo " << (opcoes.abertoLoop ? "aberto" : "fechado") << ", " << opcoes.conexoes << " conexoes, "
+           << opcoes.duracaoS << " s medidos";
+        if (opcoes.abertoLoop) os << ", taxa agendada " << opcoes.taxa << " req/s";
+        os << "\n\n" << std::left << std::setw(12) << "operacao" << std::right << std::setw(10) << "reqs"
+           << std::setw(11) << "req/s" << std::setw(8) << "falhas" << std::setw(8) << "erros" << std::setw(10)
+           << "p50 ms" << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "p999 ms"
+           << std::setw(10) << "max ms" << "\n";
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3) << "{\n  \"rotulo\": \"" << opcoes.rotulo << "\",\n  \"modo\": \""
+             << (opcoes.abertoLoop ? "aberto" : "fechado") << "\",\n  \"conexoes\": " << opcoes.conexoes
+             << ",\n  \"duracaoS\": " << opcoes.duracaoS << ",\n  \"taxaAgendada\": "
+             << (opcoes.abertoLoop ? opcoes.taxa : 0.0) << ",\n  \"atrasadas\": " << atrasadas
+             << ",\n  \"bytesRecebidos\": " << bytes << ",\n  \"operacoes\": [\n";
+        for (int op = 0; op <= TOTAL_OPERACOES; op++) {
+            HistogramaLatencia::Resumo r = acumulados[op].resumir();
+            double porSegundo = concluidas[op] / opcoes.duracaoS;
+            os << std::left << std::setw(12) << nomeOperacao(op) << std::right << std::setw(10) << concluidas[op]
+               << std::fixed << std::setprecision(1) << std::setw(11) << porSegundo << std::setw(8) << falhas[op]
+               << std::setw(8) << errosConexao[op] << std::setprecision(3) << std::setw(10) << r.p50Us / 1e3
+               << std::setw(10) << r.p90Us / 1e3 << std::setw(10) << r.p99Us / 1e3 << std::setw(10)
+               << r.p999Us / 1e3 << std::setw(10) << r.maximoUs / 1e3 << "\n";
+            json << "    {\"operacao\": \"" << nomeOperacao(op) << "\", \"requisicoes\": " << concluidas[op]
+                 << ", \"porSegundo\": " << porSegundo << ", \"falhas\": " << falhas[op]
+                 << ", \"errosConexao\": " << errosConexao[op] << ", \"p50Ms\": " << r.p50Us / 1e3
+                 << ", \"p90Ms\": " << r.p90Us / 1e3 << ", \"p99Ms\": " << r.p99Us / 1e3
+                 << ", \"p999Ms\": " << r.p999Us / 1e3 << ", \"maximoMs\": " << r.maximoUs / 1e3 << "}"
+                 << (op < TOTAL_OPERACOES ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+        os << "\nRecebidos: " << std::setprecision(1) << bytes / 1048576.0 << " MiB";
+        if (opcoes.abertoLoop) {
+            os << "; " << atrasadas << " requisicoes sairam mais de 1 ms apos o agendado"
+               << (atrasadas ? " (muitas indicam conexoes insuficientes para a taxa: aumente --conexoes)" : "");
+        }
+        std::cout << os.str() << "\n";
+
+        if (!opcoes.saida.empty()) {
+            std::ofstream f(opcoes.saida);
+            if (!f.is_open()) std::cerr << "Nao foi possivel gravar " << opcoes.saida << "\n";
+            f << json.str();
+        }
+    }
+};
+
+void lerMix(const std::string& texto, double pesos[TOTAL_OPERACOES]) {
+    std::fill(pesos, pesos + TOTAL_OPERACOES, 0.0);
+    std::stringstream ss(texto);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        auto pos = item.find(':');
+        if (pos == std::string::npos) throw std::invalid_argument("--mix espera nome:peso, recebeu '" + item + "'");
+        std::string nome = item.substr(0, pos);
+        double peso = std::stod(item.substr(pos + 1));
+        int op = 0;
+        while (op < TOTAL_OPERACOES && nome != nomeOperacao(op)) op++;
+        if (op == TOTAL_OPERACOES) throw std::invalid_argument("Operacao desconhecida em --mix: '" + nome + "'");
+        if (peso < 0) throw std::invalid_argument("Peso negativo em --mix");
+        pesos[op] = peso;
+    }
+    if (pesos[PAINEL] + pesos[FORNECEDOR] + pesos[ORDEM] <= 0)
+        throw std::invalid_argument("--mix precisa de ao menos um peso positivo");
+}
+
+OpcoesCarga lerOpcoes(int argc, char** argv) {
+    OpcoesCarga o;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto comeca = [&](const char* prefixo) { return arg.rfind(prefixo, 0) == 0; };
+        std::string valor = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (comeca("--host=")) o.host = valor;
+        else if (comeca("--porta=")) o.porta = std::stoi(valor);
+        else if (comeca("--conexoes=")) o.conexoes = std::stoi(valor);
+        else if (comeca("--duracao-s=")) o.duracaoS = std::stod(valor);
+        else if (comeca("--aquecimento-s=")) o.aquecimentoS = std::stod(valor);
+        else if (comeca("--taxa=")) o.taxa = std::stod(valor);
+        else if (comeca("--mix=")) lerMix(valor, o.pesos);
+        else if (comeca("--fornecedores=")) o.fornecedores = std::stoi(valor);
+        else if (comeca("--semente=")) o.semente = std::stoull(valor);
+        else if (comeca("--saida=")) o.saida = valor;
+        else if (comeca("--rotulo=")) o.rotulo = valor;
+        else if (comeca("--modo=")) {
+            if (valor == "aberto") o.abertoLoop = true;
+            else if (valor == "fechado") o.abertoLoop = false;
+            else throw std::invalid_argument("--modo deve ser aberto ou fechado");
+        } else {
+            throw std::invalid_argument("Opcao desconhecida: " + arg);
+        }
+    }
+    if (o.conexoes < 1 || o.conexoes > 4096) throw std::invalid_argument("--conexoes deve estar entre 1 e 4096");
+    if (o.duracaoS <= 0 || o.aquecimentoS < 0) throw std::invalid_argument("Duracoes invalidas");
+    if (o.taxa <= 0) throw std::invalid_argument("--taxa deve ser positiva");
+    if (o.fornecedores < 1) throw std::invalid_argument("--fornecedores deve ser ao menos 1");
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        OpcoesCarga opcoes = lerOpcoes(argc, argv);
+        if (!initSockets()) throw std::runtime_error("Erro ao inicializar sockets");
+        GeradorCarga carga(opcoes);
+        carga.executar();
+        carga.relatar();
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,361 @@
+// Gerador de dados sintéticos para testes de escala: escreve fornecedores.txt,
+// ordens.txt, producao.txt e estoque_previsto.txt nos mesmos formatos de texto
+// gravados pelo sistema, com milhões de linhas se preciso.
+// A saída depende só das opções e da semente: o gerador de números e as
+// distribuições são implementados aqui (os de <random> variam entre bibliotecas)
+// e as datas são formatadas sem fuso horário.
+//
+// Compilação (a partir da raiz): ./tools/compilar_ferramentas.sh  (ou .ps1 no Windows)
+// Uso: ./build/gerador_dados [--saida=data_gerado] [--semente=42]
+//        [--fornecedores=10000] [--ordens=1000000] [--producao=N] [--previsto=N]
+//        [--produtos=500] [--assimetria=1.0] [--status=5,70,10,10,5]
+//        [--data-inicio=2024-01-01] [--dias=365] [--texto-min=8] [--texto-max=40]
+// Para usar os dados: copie os arquivos para data/ (ou rode o servidor a partir de --saida/..).
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct OpcoesGerador {
+    std::string saida = "data_gerado";
+    uint64_t semente = 42;
+    size_t fornecedores = 10000;
+    size_t ordens = 1000000;
+    long long producao = -1;            ///< -1 = ordens / 4
+    long long previsto = -1;            ///< -1 = ordens / 4
+    size_t produtos = 500;              ///< Cardinalidade de produtos (itens distintos)
+    double assimetria = 1.0;            ///< Expoente Zipf da escolha do fornecedor (0 = uniforme)
+    double pesosStatus[5] = {5, 70, 10, 10, 5};   ///< PENDENTE, APROVADO, REJEITADO, ENVIADO, ENTREGUE
+    int anoInicio = 2024, mesInicio = 1, diaInicio = 1;
+    int dias = 365;                     ///< Espalhamento das datas de solicitação
+    size_t textoMin = 8;                ///< Comprimento de nomes e endereços
+    size_t textoMax = 40;
+};
+
+// splitmix64: pequeno, rápido e com a mesma sequência em qualquer plataforma
+class GeradorDeterministico {
+private:
+    uint64_t estado;
+
+public:
+    explicit GeradorDeterministico(uint64_t semente) : estado(semente) {}
+
+    uint64_t proximo() {
+        uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Real uniforme em [0, 1)
+    double real() { return static_cast<double>(proximo() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Inteiro uniforme em [minimo, maximo]
+    int64_t intervalo(int64_t minimo, int64_t maximo) {
+        uint64_t largura = static_cast<uint64_t>(maximo - minimo) + 1;
+        return minimo + static_cast<int64_t>(largura ? proximo() % largura : proximo());
+    }
+
+    // Índice sorteado segundo uma distribuição acumulada (último valor = total)
+    size_t sortear(const std::vector<double>& acumulada) {
+        double alvo = real() * acumulada.back();
+        return std::min<size_t>(std::upper_bound(acumulada.begin(), acumulada.end(), alvo) - acumulada.begin(),
+                                acumulada.size() - 1);
+    }
+};
+
+std::vector<double> acumuladaZipf(size_t n, double expoente) {
+    std::vector<double> acumulada(n);
+    double soma = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        soma += 1.0 / std::pow(static_cast<double>(i + 1), expoente);
+        acumulada[i] = soma;
+    }
+    return acumulada;
+}
+
+// Dias desde 1970-01-01 (calendário gregoriano, sem fuso) e o inverso
+int64_t diasDesdeEpoch(int ano, int mes, int dia) {
+    ano -= mes <= 2;
+    int64_t era = (ano >= 0 ? ano : ano - 399) / 400;
+    int64_t anoDaEra = ano - era * 400;
+    int64_t diaDoAno = (153 * (mes + (mes > 2 ? -3 : 9)) + 2) / 5 + dia - 1;
+    int64_t diaDaEra = anoDaEra * 365 + anoDaEra / 4 - anoDaEra / 100 + diaDoAno;
+    return era * 146097 + diaDaEra - 719468;
+}
+
+void civilDeDias(int64_t z, int& ano, int& mes, int& dia) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t diaDaEra = z - era * 146097;
+    int64_t anoDaEra = (diaDaEra - diaDaEra / 1460 + diaDaEra / 36524 - diaDaEra / 146096) / 365;
+    int64_t diaDoAno = diaDaEra - (365 * anoDaEra + anoDaEra / 4 - anoDaEra / 100);
+    int64_t mp = (5 * diaDoAno + 2) / 153;
+    dia = static_cast<int>(diaDoAno - (153 * mp + 2) / 5 + 1);
+    mes = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    ano = static_cast<int>(anoDaEra + era * 400 + (mes <= 2));
+}
+
+// "dd/mm/aaaa hh:mm:ss", o formato de DataHora::formatar
+std::string formatarDataHora(int64_t segundos) {
+    int ano, mes, dia;
+    int64_t diasTotais = segundos / 86400;
+    int64_t resto = segundos % 86400;
+    civilDeDias(diasTotais, ano, mes, dia);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%02d/%02d/%04d %02d:%02d:%02d", dia, mes, ano,
+                  static_cast<int>(resto / 3600), static_cast<int>(resto / 60 % 60), static_cast<int>(resto % 60));
+    return buffer;
+}
+
+std::string formatarData(int64_t segundos) {
+    return formatarDataHora(segundos).substr(0, 10);
+}
+
+// Centavos em "123.45" (o formato gravado por Dinheiro)
+std::string formatarCentavos(int64_t centavos) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%lld.%02lld", static_cast<long long>(centavos / 100),
+                  static_cast<long long>(centavos % 100));
+    return buffer;
+}
+
+// Texto pronunciável com comprimento sorteado em [minimo, maximo] (sem '|' nem quebras de linha)
+std::string textoAleatorio(GeradorDeterministico& g, size_t minimo, size_t maximo) {
+    static const char* silabas[] = {"ba", "ca", "da", "fe", "ga", "li", "ma", "no", "pa", "ra",
+                                    "sa", "te", "vi", "lo", "mu", "ni", "so", "tu", "re", "co"};
+    size_t alvo = static_cast<size_t>(g.intervalo(static_cast<int64_t>(minimo), static_cast<int64_t>(maximo)));
+    std::string s;
+    size_t palavra = 0;
+    while (s.size() < alvo) {
+        if (palavra >= 4 + g.proximo() % 6 && s.size() + 1 < alvo) {
+            s += ' ';
+            palavra = 0;
+            continue;
+        }
+        s += silabas[g.proximo() % 20];
+        palavra += 2;
+    }
+    s.resize(alvo);
+    if (!s.empty()) s[0] = static_cast<char>(s[0] - 'a' + 'A');
+    if (!s.empty() && s.back() == ' ') s.back() = 'a';
+    return s;
+}
+
+// Grava em blocos grandes: milhões de linhas com '<<' linha a linha custam mais que a geração
+class ArquivoSaida {
+private:
+    std::FILE* arquivo;
+    std::string buffer;
+
+public:
+    explicit ArquivoSaida(const std::string& caminho) : arquivo(std::fopen(caminho.c_str(), "wb")) {
+        if (!arquivo) throw std::runtime_error("Nao foi possivel criar " + caminho);
+        buffer.reserve(1 << 20);
+    }
+
+    ~ArquivoSaida() {
+        descarregar();
+        std::fclose(arquivo);
+    }
+
+    ArquivoSaida(const ArquivoSaida&) = delete;
+    ArquivoSaida& operator=(const ArquivoSaida&) = delete;
+
+    ArquivoSaida& operator<<(const std::string& s) { buffer += s; return verificar(); }
+    ArquivoSaida& operator<<(const char* s) { buffer += s; return verificar(); }
+    ArquivoSaida& operator<<(char c) { buffer += c; return verificar(); }
+    ArquivoSaida& operator<<(long long v) { buffer += std::to_string(v); return verificar(); }
+
+    ArquivoSaida& verificar() {
+        if (buffer.size() >= (1 << 20)) descarregar();
+        return *this;
+    }
+
+    void descarregar() {
+        if (!buffer.empty()) std::fwrite(buffer.data(), 1, buffer.size(), arquivo);
+        buffer.clear();
+    }
+};
+
+struct FornecedorGerado {
+    int produto = 0;             ///< Índice do produto (idItem = 1001 + produto)
+    int64_t precoCentavos = 0;
+};
+
+std::vector<FornecedorGerado> gerarFornecedores(const OpcoesGerador& o, GeradorDeterministico& g) {
+    std::vector<FornecedorGerado> gerados(o.fornecedores);
+    ArquivoSaida f((std::filesystem::path(o.saida) / "fornecedores.txt").string());
+    f << "ID|Nome|Endereco|CNPJ|Produto|Preco\n";
+    static const char* tipos[] = {"Rua", "Av.", "Travessa", "Rodovia", "Alameda"};
+    for (size_t i = 0; i < o.fornecedores; i++) {
+        FornecedorGerado& forn = gerados[i];
+        forn.produto = static_cast<int>(g.proximo() % o.produtos);
+        // Preço base por produto (mesma faixa para todos os fornecedores do produto) com variação de ±20%
+        int64_t base = 10 + static_cast<int64_t>((forn.produto * 2654435761ULL) % 50000);
+        forn.precoCentavos = std::max<int64_t>(1, base * g.intervalo(80, 120) / 100);
+
+        char cnpj[24];
+        size_t id = i + 1;
+        std::snprintf(cnpj, sizeof(cnpj), "%02d.%03d.%03d/0001-%02d", static_cast<int>((id / 1000000) % 100),
+                      static_cast<int>((id / 1000) % 1000), static_cast<int>(id % 1000), static_cast<int>(id % 97));
+        size_t minNome = std::max<size_t>(1, o.textoMin);
+        f << static_cast<long long>(id) << '|' << textoAleatorio(g, minNome, o.textoMax) << " Ltda|"
+          << tipos[g.proximo() % 5] << ' ' << textoAleatorio(g, minNome, o.textoMax) << ", "
+          << static_cast<long long>(g.intervalo(1, 9999)) << '|' << cnpj << '|' << "Produto "
+          << static_cast<long long>(forn.produto + 1) << '|' << formatarCentavos(forn.precoCentavos) << '\n';
+    }
+    return gerados;
+}
+
+struct OrdemGerada {
+    int idItem = 0;
+    int quantidade = 0;
+    int64_t solicitacao = 0;     ///< Segundos desde a época (UTC)
+};
+
+std::vector<OrdemGerada> gerarOrdens(const OpcoesGerador& o, GeradorDeterministico& g,
+                                     const std::vector<FornecedorGerado>& fornecedores) {
+    std::vector<OrdemGerada> geradas(o.ordens);
+    ArquivoSaida f((std::filesystem::path(o.saida) / "ordens.txt").string());
+    f << "ID|IdItem|Quantidade|ValorUnitario|IdFornecedor|Status|DataSolicitacao|DataChegadaPrevista\n";
+
+    // Alguns fornecedores concentram a maior parte das ordens (Zipf), em ordem embaralhada de ID
+    std::vector<double> popularidade = acumuladaZipf(fornecedores.size(), o.assimetria);
+    std::vector<int> permutacao(fornecedores.size());
+    for (size_t i = 0; i < permutacao.size(); i++) permutacao[i] = static_cast<int>(i);
+    for (size_t i = permutacao.size(); i > 1; i--) std::swap(permutacao[i - 1], permutacao[g.proximo() % i]);
+    std::vector<double> status(o.pesosStatus, o.pesosStatus + 5);
+    for (size_t i = 1; i < status.size(); i++) status[i] += status[i - 1];
+
+    // IDs crescem com a data de solicitação, como no sistema
+    int64_t inicio = diasDesdeEpoch(o.anoInicio, o.mesInicio, o.diaInicio) * 86400;
+    double passo = static_cast<double>(o.dias) * 86400.0 / std::max<size_t>(1, o.ordens);
+    for (size_t i = 0; i < o.ordens; i++) {
+        int idForn = permutacao[g.sortear(popularidade)];
+        const FornecedorGerado& forn = fornecedores[idForn];
+        OrdemGerada& ordem = geradas[i];
+        ordem.idItem = 1001 + forn.produto;
+        // Quantidades log-uniformes entre 1 e 1000: muitas ordens pequenas, poucas grandes
+        ordem.quantidade = static_cast<int>(std::exp(g.real() * std::log(1000.0))) + 1;
+        ordem.solicitacao = inicio + static_cast<int64_t>(i * passo + g.real() * passo);
+        int64_t valor = std::max<int64_t>(1, forn.precoCentavos * g.intervalo(95, 105) / 100);
+
+        f << static_cast<long long>(i + 1) << '|' << static_cast<long long>(ordem.idItem) << '|'
+          << static_cast<long long>(ordem.quantidade) << '|' << formatarCentavos(valor) << '|'
+          << static_cast<long long>(idForn + 1) << '|' << static_cast<long long>(g.sortear(status)) << '|'
+          << formatarDataHora(ordem.solicitacao) << '|';
+        // Três em cada quatro ordens têm chegada prevista (3 a 30 dias depois)
+        if (g.proximo() % 4) f << formatarData(ordem.solicitacao + g.intervalo(3, 30) * 86400);
+        f << '\n';
+    }
+    return geradas;
+}
+
+void gerarProducao(const OpcoesGerador& o, GeradorDeterministico& g, const std::vector<OrdemGerada>& ordens) {
+    ArquivoSaida f((std::filesystem::path(o.saida) / "producao.txt").string());
+    f << "ID|IdMaterial|Quantidade|Prioridade|Status|IdOrdemCompra|DataCriacao|DataPrevistaEntrega\n";
+    static const char* status[] = {"pendente", "em_preparacao", "finalizado", "concluido"};
+    size_t linhas = o.producao < 0 ? o.ordens / 4 : static_cast<size_t>(o.producao);
+    for (size_t i = 0; i < linhas; i++) {
+        // Pedidos avulsos (sem ordem de compra) quando não há ordens
+        size_t idOrdem = ordens.empty() ? 0 : 1 + g.proximo() % ordens.size();
+        int idMaterial = idOrdem ? ordens[idOrdem - 1].idItem : 1001 + static_cast<int>(g.proximo() % o.produtos);
+        int quantidade = idOrdem ? ordens[idOrdem - 1].quantidade : static_cast<int>(g.intervalo(1, 1000));
+        int64_t criacao = idOrdem ? ordens[idOrdem - 1].solicitacao + g.intervalo(60, 86400)
+                                  : diasDesdeEpoch(o.anoInicio, o.mesInicio, o.diaInicio) * 86400 +
+                                        g.intervalo(0, static_cast<int64_t>(o.dias) * 86400);
+        f << static_cast<long long>(i + 1) << '|' << static_cast<long long>(idMaterial) << '|'
+          << static_cast<long long>(quantidade) << '|' << static_cast<long long>(g.intervalo(1, 3)) << '|'
+          << status[g.proximo() % 4] << '|' << static_cast<long long>(idOrdem) << '|' << formatarDataHora(criacao)
+          << '|' << (g.proximo() % 10 ? formatarData(criacao + g.intervalo(1, 20) * 86400) : std::string("A definir"))
+          << '\n';
+    }
+}
+
+void gerarPrevisto(const OpcoesGerador& o, GeradorDeterministico& g, const std::vector<OrdemGerada>& ordens) {
+    ArquivoSaida f((std::filesystem::path(o.saida) / "estoque_previsto.txt").string());
+    f << "IdMaterial|Quantidade|IdOrdemCompra|DataPrevista\n";
+    size_t linhas = o.previsto < 0 ? o.ordens / 4 : static_cast<size_t>(o.previsto);
+    for (size_t i = 0; i < linhas && !ordens.empty(); i++) {
+        size_t idOrdem = 1 + g.proximo() % ordens.size();
+        const OrdemGerada& ordem = ordens[idOrdem - 1];
+        f << static_cast<long long>(ordem.idItem) << '|' << static_cast<long long>(ordem.quantidade) << '|'
+          << static_cast<long long>(idOrdem) << '|' << formatarData(ordem.solicitacao + g.intervalo(3, 30) * 86400)
+          << '\n';
+    }
+}
+
+OpcoesGerador lerOpcoes(int argc, char** argv) {
+    OpcoesGerador o;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto comeca = [&](const char* prefixo) { return arg.rfind(prefixo, 0) == 0; };
+        std::string valor = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (comeca("--saida=")) o.saida = valor;
+        else if (comeca("--semente=")) o.semente = std::stoull(valor);
+        else if (comeca("--fornecedores=")) o.fornecedores = std::stoul(valor);
+        else if (comeca("--ordens=")) o.ordens = std::stoul(valor);
+        else if (comeca("--producao=")) o.producao = std::stoll(valor);
+        else if (comeca("--previsto=")) o.previsto = std::stoll(valor);
+        else if (comeca("--produtos=")) o.produtos = std::stoul(valor);
+        else if (comeca("--assimetria=")) o.assimetria = std::stod(valor);
+        else if (comeca("--dias=")) o.dias = std::stoi(valor);
+        else if (comeca("--texto-min=")) o.textoMin = std::stoul(valor);
+        else if (comeca("--texto-max=")) o.textoMax = std::stoul(valor);
+        else if (comeca("--data-inicio=")) {
+            if (std::sscanf(valor.c_str(), "%d-%d-%d", &o.anoInicio, &o.mesInicio, &o.diaInicio) != 3)
+                throw std::invalid_argument("--data-inicio deve ser aaaa-mm-dd");
+        } else if (comeca("--status=")) {
+            double* p = o.pesosStatus;
+            if (std::sscanf(valor.c_str(), "%lf,%lf,%lf,%lf,%lf", p, p + 1, p + 2, p + 3, p + 4) != 5)
+                throw std::invalid_argument("--status espera 5 pesos: pendente,aprovado,rejeitado,enviado,entregue");
+        } else {
+            throw std::invalid_argument("Opcao desconhecida: " + arg);
+        }
+    }
+    if (o.fornecedores == 0 && o.ordens > 0) throw std::invalid_argument("Ordens precisam de ao menos um fornecedor");
+    if (o.produtos == 0) throw std::invalid_argument("--produtos deve ser maior que zero");
+    if (o.textoMax < o.textoMin) throw std::invalid_argument("--texto-max menor que --texto-min");
+    double pesos = 0.0;
+    for (double p : o.pesosStatus) {
+        if (p < 0) throw std::invalid_argument("Pesos de status nao podem ser negativos");
+        pesos += p;
+    }
+    if (pesos <= 0) throw std::invalid_argument("Ao menos um peso de status deve ser positivo");
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        OpcoesGerador o = lerOpcoes(argc, argv);
+        std::filesystem::create_directories(o.saida);
+        // Um gerador por arquivo: mudar o tamanho de um arquivo não altera o conteúdo dos outros
+        GeradorDeterministico gForn(o.semente), gOrdens(o.semente ^ 0x6F7264656E73ULL),
+            gProducao(o.semente ^ 0x70726F64ULL), gPrevisto(o.semente ^ 0x70726576ULL);
+
+        auto fornecedores = gerarFornecedores(o, gForn);
+        auto ordens = gerarOrdens(o, gOrdens, fornecedores);
+        gerarProducao(o, gProducao, ordens);
+        gerarPrevisto(o, gPrevisto, ordens);
+
+        std::cout << "Gerados em " << o.saida << "/: " << o.fornecedores << " fornecedores, " << o.ordens
+                  << " ordens, " << (o.producao < 0 ? o.ordens / 4 : static_cast<size_t>(o.producao))
+                  << " registros de producao, " << (o.previsto < 0 ? o.ordens / 4 : static_cast<size_t>(o.previsto))
+                  << " de estoque previsto (semente " << o.semente << ")\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
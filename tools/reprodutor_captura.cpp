@@ -0,0 +1,269 @@
+// Reprodutor de capturas do servidor (--captura=arquivo, ver CapturaRequisicoes.h):
+// reenvia as requisições gravadas nos mesmos intervalos (ou acelerados) e compara,
+// por rota, a latência original com a da reprodução.
+//
+// Para reproduzir a partir do mesmo estado, suba o servidor numa pasta cuja data/
+// seja a cópia gravada junto com a captura ("<arquivo>.dados/"), por exemplo:
+//   mkdir -p /tmp/repro/data && cp captura.bin.dados/* /tmp/repro/data/
+//   (cd /tmp/repro && /caminho/build/http_server --latencia=zero) &
+//   ./build/reprodutor_captura --captura=captura.bin --velocidade=4
+// As requisições são agendadas como na captura (modo aberto): a latência conta a
+// partir do horário agendado, então atrasos por falta de conexões ou por um servidor
+// mais lento aparecem nos percentis. A latência original foi medida no servidor (da
+// aceitação da conexão ao envio); a da reprodução, no cliente, inclui conexão e leitura.
+//
+// Compilação (a partir da raiz): ./tools/compilar_ferramentas.sh  (ou .ps1 no Windows)
+// Uso: ./build/reprodutor_captura --captura=arquivo [--host=127.0.0.1] [--porta=8080]
+//        [--velocidade=1.0] [--conexoes=32] [--limite=N] [--saida=arquivo.json] [--rotulo=texto]
+//   --velocidade=0 envia tudo o mais rápido possível (limitado por --conexoes)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CapturaRequisicoes.h"
+#include "ClienteHttp.h"
+#include "HistogramaLatencia.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+struct OpcoesReproducao {
+    std::string captura;
+    std::string host = "127.0.0.1";
+    int porta = 8080;
+    double velocidade = 1.0;   ///< Multiplicador do ritmo original (0 = sem espera)
+    int conexoes = 32;
+    size_t limite = 0;         ///< Reproduz só os primeiros N registros (0 = todos)
+    std::string saida;
+    std::string rotulo;
+};
+
+// Requisição pronta para envio e o que a captura diz sobre ela
+struct Requisicao {
+    uint64_t chegadaNs = 0;
+    uint64_t latenciaOriginalNs = 0;
+    uint16_t statusOriginal = 0;
+    size_t rota = 0;           ///< Índice em CapturaCarregada::rotas
+    std::string texto;
+};
+
+struct CapturaCarregada {
+    std::vector<Requisicao> requisicoes;
+    std::vector<std::string> rotas;   ///< "MÉTODO /caminho" (sem a query string)
+    uint64_t inicioEpochNs = 0;
+};
+
+CapturaCarregada carregar(const OpcoesReproducao& o) {
+    LeitorCaptura leitor(o.captura);
+    CapturaCarregada c;
+    c.inicioEpochNs = leitor.obterInicioEpochNs();
+    std::map<std::string, size_t> indiceRotas;
+    RegistroCaptura r;
+    while ((o.limite == 0 || c.requisicoes.size() < o.limite) && leitor.proximo(r)) {
+        std::string rota = r.metodo + " " + r.alvo.substr(0, r.alvo.find('?'));
+        auto it = indiceRotas.emplace(rota, c.rotas.size()).first;
+        if (it->second == c.rotas.size()) c.rotas.push_back(rota);
+
+        Requisicao req;
+        req.chegadaNs = r.chegadaNs;
+        req.latenciaOriginalNs = r.latenciaNs;
+        req.statusOriginal = r.status;
+        req.rota = it->second;
+        std::ostringstream texto;
+        texto << r.metodo << " " << r.alvo << " HTTP/1.1\r\nHost: " << o.host << "\r\nConnection: close\r\n";
+        if (!r.chaveIdempotencia.empty()) texto << "Idempotency-Key: " << r.chaveIdempotencia << "\r\n";
+        texto << "Content-Length: " << r.corpo.size() << "\r\n\r\n" << r.corpo;
+        req.texto = texto.str();
+        c.requisicoes.push_back(std::move(req));
+    }
+    // O laço de accept grava na ordem de término; a agenda segue a ordem de chegada
+    std::stable_sort(c.requisicoes.begin(), c.requisicoes.end(),
+                     [](const Requisicao& a, const Requisicao& b) { return a.chegadaNs < b.chegadaNs; });
+    return c;
+}
+
+// Contadores de uma thread, por rota (um escritor; somados depois do join)
+struct ResultadoThread {
+    std::unique_ptr<HistogramaLatencia[]> latencia;
+    std::vector<uint64_t> divergencias;   ///< Status diferente do original
+    std::vector<uint64_t> errosConexao;
+    uint64_t atrasadas = 0;               ///< Saíram mais de 1 ms depois do agendado
+
+    explicit ResultadoThread(size_t rotas)
+        : latencia(new HistogramaLatencia[rotas]), divergencias(rotas, 0), errosConexao(rotas, 0) {}
+};
+
+class Reprodutor {
+private:
+    const OpcoesReproducao& opcoes;
+    const CapturaCarregada& captura;
+    sockaddr_in destino;
+    Relogio::time_point inicio;
+    std::atomic<size_t> proxima{0};
+    std::vector<ResultadoThread> resultados;
+
+    void trabalhar(ResultadoThread& res) {
+        std::string resposta;
+        while (true) {
+            size_t k = proxima.fetch_add(1, std::memory_order_relaxed);
+            if (k >= captura.requisicoes.size()) break;
+            const Requisicao& req = captura.requisicoes[k];
+            Relogio::time_point agendada = inicio;
+            if (opcoes.velocidade > 0) {
+                agendada += std::chrono::duration_cast<Relogio::duration>(
+                    std::chrono::duration<double, std::nano>(req.chegadaNs / opcoes.velocidade));
+                std::this_thread::sleep_until(agendada);
+                if (Relogio::now() - agendada > std::chrono::milliseconds(1)) res.atrasadas++;
+            } else {
+                agendada = Relogio::now();
+            }
+            int status = executarRequisicao(destino, req.texto, resposta);
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Relogio::now() - agendada).count();
+            if (status < 0) {
+                res.errosConexao[req.rota]++;
+                continue;
+            }
+            if (status != req.statusOriginal) res.divergencias[req.rota]++;
+            res.latencia[req.rota].registrar(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+        }
+    }
+
+public:
+    Reprodutor(const OpcoesReproducao& opcoes, const CapturaCarregada& captura)
+        : opcoes(opcoes), captura(captura), destino(enderecoServidor(opcoes.host, opcoes.porta)) {
+        resultados.reserve(opcoes.conexoes);
+        for (int i = 0; i < opcoes.conexoes; i++) resultados.emplace_back(captura.rotas.size());
+    }
+
+    // Reproduz a captura inteira e devolve a duração
+    double executar() {
+        if (captura.requisicoes.empty()) return 0.0;
+        // A primeira requisição da captura sai logo no início
+        uint64_t primeira = captura.requisicoes.front().chegadaNs;
+        inicio = Relogio::now() + std::chrono::milliseconds(50) -
+                 std::chrono::duration_cast<Relogio::duration>(std::chrono::duration<double, std::nano>(
+                     opcoes.velocidade > 0 ? primeira / opcoes.velocidade : 0.0));
+        auto partida = Relogio::now();
+        std::vector<std::thread> threads;
+        for (ResultadoThread& r : resultados) threads.emplace_back([this, &r] { trabalhar(r); });
+        for (auto& t : threads) t.join();
+        return std::chrono::duration<double>(Relogio::now() - partida).count();
+    }
+
+    void relatar(double duracaoS) const {
+        const size_t rotas = captura.rotas.size();
+        std::vector<HistogramaLatencia::Acumulado> original(rotas + 1), reproducao(rotas + 1);
+        std::vector<uint64_t> divergencias(rotas + 1, 0), erros(rotas + 1, 0);
+        for (const Requisicao& req : captura.requisicoes) {
+            for (size_t alvo : {req.rota, rotas}) {
+                original[alvo].contagens[HistogramaLatencia::faixa(req.latenciaOriginalNs)]++;
+                original[alvo].somaNs += req.latenciaOriginalNs;
+                original[alvo].maximoNs = std::max(original[alvo].maximoNs, req.latenciaOriginalNs);
+            }
+        }
+        uint64_t atrasadas = 0;
+        for (const ResultadoThread& r : resultados) {
+            for (size_t i = 0; i < rotas; i++) {
+                r.latencia[i].somarEm(reproducao[i]);
+                r.latencia[i].somarEm(reproducao[rotas]);
+                divergencias[i] += r.divergencias[i];
+                divergencias[rotas] += r.divergencias[i];
+                erros[i] += r.errosConexao[i];
+                erros[rotas] += r.errosConexao[i];
+            }
+            atrasadas += r.atrasadas;
+        }
+
+        double duracaoOriginalS = captura.requisicoes.empty() ? 0.0
+            : (captura.requisicoes.back().chegadaNs - captura.requisicoes.front().chegadaNs) / 1e9;
+        std::ostringstream os;
+        os << captura.requisicoes.size() << " requisicoes, " << rotas << " rotas; captura de "
+           << std::fixed << std::setprecision(1) << duracaoOriginalS << " s reproduzida em " << duracaoS
+           << " s (velocidade " << opcoes.velocidade << ", " << opcoes.conexoes << " conexoes)\n\n"
+           << std::left << std::setw(34) << "rota" << std::right << std::setw(9) << "reqs" << std::setw(21)
+           << "p50 orig/repr ms" << std::setw(21) << "p99 orig/repr ms" << std::setw(11) << "p999 repr"
+           << std::setw(10) << "status!=" << std::setw(8) << "erros" << "\n";
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3) << "{\n  \"rotulo\": \"" << opcoes.rotulo << "\",\n  \"captura\": \""
+             << opcoes.captura << "\",\n  \"velocidade\": " << opcoes.velocidade << ",\n  \"conexoes\": "
+             << opcoes.conexoes << ",\n  \"duracaoOriginalS\": " << duracaoOriginalS << ",\n  \"duracaoS\": "
+             << duracaoS << ",\n  \"atrasadas\": " << atrasadas << ",\n  \"rotas\": [\n";
+        for (size_t i = 0; i <= rotas; i++) {
+            HistogramaLatencia::Resumo o = original[i].resumir(), r = reproducao[i].resumir();
+            const std::string nome = i < rotas ? captura.rotas[i] : "total";
+            std::ostringstream p50, p99;
+            p50 << std::fixed << std::setprecision(3) << o.p50Us / 1e3 << "/" << r.p50Us / 1e3;
+            p99 << std::fixed << std::setprecision(3) << o.p99Us / 1e3 << "/" << r.p99Us / 1e3;
+            os << std::left << std::setw(34) << nome.substr(0, 33) << std::right << std::setw(9) << o.contagem
+               << std::setw(21) << p50.str() << std::setw(21) << p99.str() << std::setprecision(3) << std::setw(11)
+               << r.p999Us / 1e3 << std::setw(10) << divergencias[i] << std::setw(8) << erros[i] << "\n";
+            json << "    {\"rota\": \"" << nome << "\", \"requisicoes\": " << o.contagem
+                 << ", \"original\": {\"p50Ms\": " << o.p50Us / 1e3 << ", \"p99Ms\": " << o.p99Us / 1e3
+                 << ", \"p999Ms\": " << o.p999Us / 1e3 << ", \"maximoMs\": " << o.maximoUs / 1e3 << "}"
+                 << ", \"reproducao\": {\"p50Ms\": " << r.p50Us / 1e3 << ", \"p99Ms\": " << r.p99Us / 1e3
+                 << ", \"p999Ms\": " << r.p999Us / 1e3 << ", \"maximoMs\": " << r.maximoUs / 1e3 << "}"
+                 << ", \"statusDivergente\": " << divergencias[i] << ", \"errosConexao\": " << erros[i] << "}"
+                 << (i < rotas ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+        if (opcoes.velocidade > 0) os << "\n" << atrasadas << " requisicoes sairam mais de 1 ms apos o agendado\n";
+        std::cout << os.str();
+
+        if (!opcoes.saida.empty()) {
+            std::ofstream f(opcoes.saida);
+            if (!f.is_open()) std::cerr << "Nao foi possivel gravar " << opcoes.saida << "\n";
+            f << json.str();
+        }
+    }
+};
+
+OpcoesReproducao lerOpcoes(int argc, char** argv) {
+    OpcoesReproducao o;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto comeca = [&](const char* prefixo) { return arg.rfind(prefixo, 0) == 0; };
+        std::string valor = arg.find('=') == std::string::npos ? "" : arg.substr(arg.find('=') + 1);
+        if (comeca("--captura=")) o.captura = valor;
+        else if (comeca("--host=")) o.host = valor;
+        else if (comeca("--porta=")) o.porta = std::stoi(valor);
+        else if (comeca("--velocidade=")) o.velocidade = std::stod(valor);
+        else if (comeca("--conexoes=")) o.conexoes = std::stoi(valor);
+        else if (comeca("--limite=")) o.limite = std::stoul(valor);
+        else if (comeca("--saida=")) o.saida = valor;
+        else if (comeca("--rotulo=")) o.rotulo = valor;
+        else throw std::invalid_argument("Opcao desconhecida: " + arg);
+    }
+    if (o.captura.empty()) throw std::invalid_argument("Informe --captura=arquivo");
+    if (o.velocidade < 0) throw std::invalid_argument("--velocidade nao pode ser negativa");
+    if (o.conexoes < 1 || o.conexoes > 4096) throw std::invalid_argument("--conexoes deve estar entre 1 e 4096");
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        OpcoesReproducao opcoes = lerOpcoes(argc, argv);
+        if (!initSockets()) throw std::runtime_error("Erro ao inicializar sockets");
+        CapturaCarregada captura = carregar(opcoes);
+        Reprodutor reprodutor(opcoes, captura);
+        double duracao = reprodutor.executar();
+        reprodutor.relatar(duracao);
+    } catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,315 @@
+// Teste da camada de resiliência (GuardaIntegracao e FinanceiroResiliente), dentro do
+// processo e sem os módulos simulados: um financeiro falso que trava, que falha algumas
+// vezes antes de responder ou que sempre falha. Confere o prazo (e que ninguém fica
+// bloqueado esperando por ele), o número de tentativas, a diferença entre operações
+// idempotentes e não idempotentes, a compensação de uma resposta atrasada, a
+// idempotência de autorizarPagamento no FinanceiroMock e a abertura do disjuntor.
+//
+// Compilação (a partir da raiz): ./tools/compilar_ferramentas.sh  (ou .ps1 no Windows)
+// Uso: ./build/teste_resiliencia   (código de saída 1 se alguma verificação falhar)
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ExecutorIntegracao.h"
+#include "FinanceiroMock.h"
+#include "IntegracoesResilientes.h"
+#include "Temporizador.h"
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+int verificacoesFalhas = 0;
+
+void verificar(bool condicao, const std::string& descricao) {
+    std::cout << (condicao ? "  ok      " : "  FALHOU  ") << descricao << "\n";
+    if (!condicao) verificacoesFalhas++;
+}
+
+double msDesde(Relogio::time_point inicio) {
+    return std::chrono::duration<double, std::milli>(Relogio::now() - inicio).count();
+}
+
+// Financeiro falso: toda chamada passa por responder(), que aplica o comportamento escolhido
+class FinanceiroFalso : public IFinanceiro {
+public:
+    enum class Modo {
+        NORMAL,
+        TRAVADO,      ///< Só responde depois de liberar()
+        INSTAVEL,     ///< As primeiras 'falhasAntesDeResponder' chamadas lançam exceção
+        SEMPRE_FALHA
+    };
+
+private:
+    std::mutex mutex;
+    std::condition_variable liberou;
+    bool liberado = false;
+
+    void responder() {
+        int n = ++chamadas;
+        switch (modo.load()) {
+            case Modo::TRAVADO: {
+                std::unique_lock<std::mutex> lock(mutex);
+                liberou.wait(lock, [this] { return liberado; });
+                break;
+            }
+            case Modo::INSTAVEL:
+                if (n <= falhasAntesDeResponder) throw ComprasException("FINANCEIRO: falha transitoria");
+                break;
+            case Modo::SEMPRE_FALHA:
+                throw ComprasException("FINANCEIRO: fora do ar");
+            case Modo::NORMAL:
+            default:
+                break;
+        }
+    }
+
+public:
+    std::atomic<Modo> modo{Modo::NORMAL};
+    std::atomic<int> chamadas{0};
+    int falhasAntesDeResponder = 0;
+    std::atomic<int64_t> devolvidoCentavos{0};
+
+    explicit FinanceiroFalso(Modo modo, int falhasAntesDeResponder = 0)
+        : modo(modo), falhasAntesDeResponder(falhasAntesDeResponder) {}
+
+    // Libera as chamadas travadas (e as próximas)
+    void liberar() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            liberado = true;
+        }
+        liberou.notify_all();
+    }
+
+    bool verificarDisponibilidade(Dinheiro) override {
+        responder();
+        return true;
+    }
+
+    Dinheiro solicitarVerba(Dinheiro valorDesejado) override {
+        responder();
+        return valorDesejado;
+    }
+
+    void devolverVerba(Dinheiro valor) override { devolvidoCentavos += valor.emCentavos(); }
+
+    bool autorizarPagamento(int) override {
+        responder();
+        return true;
+    }
+
+    bool registrarContaPagar(int, Dinheiro, const std::string&, const std::string&) override {
+        responder();
+        return true;
+    }
+
+    std::vector<std::string> listarContasPagar() override {
+        responder();
+        return {};
+    }
+};
+
+PoliticaResiliencia politicaTeste() {
+    PoliticaResiliencia p;
+    p.prazo = std::chrono::milliseconds(100);
+    p.tentativas = 3;
+    p.esperaBase = std::chrono::milliseconds(10);
+    p.falhasParaAbrir = 100;
+    p.tempoAberto = std::chrono::milliseconds(200);
+    return p;
+}
+
+// Financeiro protegido e seus executores, destruídos na ordem do GerenciadorOrdens:
+// o executor de chamadas remotas encerra (terminando as tentativas abandonadas, que
+// ainda usam o decorador) antes do decorador e do temporizador.
+// O financeiro falso deve sobreviver ao cenário.
+struct Cenario {
+    Temporizador temporizador;
+    std::unique_ptr<ExecutorIntegracao> chamadasRemotas = std::make_unique<ExecutorIntegracao>(4);
+    FinanceiroResiliente financeiro;
+    ExecutorIntegracao fluxo{1};   ///< Uma thread só: se ela bloquear, nada mais anda
+
+    Cenario(IFinanceiro& alvo, const PoliticaResiliencia& politica)
+        : financeiro(alvo, politica, *chamadasRemotas, temporizador) {}
+
+    ~Cenario() { chamadasRemotas.reset(); }
+};
+
+// Espera o Futuro falhar e devolve a mensagem ("" se ele não falhou)
+template <typename T>
+std::string erroDe(const Futuro<T>& futuro) {
+    try {
+        futuro.obter();
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return "";
+}
+
+bool contem(const std::string& texto, const std::string& trecho) { return texto.find(trecho) != std::string::npos; }
+
+void testarPrazoSemBloquear() {
+    std::cout << "\nPrazo excedido (modulo travado)\n";
+    FinanceiroFalso alvo(FinanceiroFalso::Modo::TRAVADO);
+    {
+        PoliticaResiliencia politica = politicaTeste();
+        politica.tentativas = 1;
+        Cenario cenario(alvo, politica);
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+
+        // A chamada parte de uma tarefa do executor do fluxo, como no submeter()
+        auto inicio = Relogio::now();
+        Futuro<Futuro<bool>> disparo =
+            cenario.fluxo.submeter([&financeiro] { return financeiro.verificarDisponibilidadeAssincrona(Dinheiro()); });
+        Futuro<bool> resposta = disparo.obter();
+        double disparoMs = msDesde(inicio);
+        // Com a chamada travada, a única thread do fluxo continua livre
+        Futuro<int> outra = cenario.fluxo.submeter([] { return 42; });
+        bool outraRodou = outra.aguardarPor(std::chrono::milliseconds(50)) && outra.obter() == 42;
+
+        std::string erro = erroDe(resposta);
+        double prazoMs = msDesde(inicio);
+        verificar(disparoMs < 50, "a tarefa do fluxo devolve sem esperar o modulo (" + std::to_string(static_cast<long long>(disparoMs)) + " ms)");
+        verificar(outraRodou, "o executor do fluxo (1 thread) executa outra tarefa enquanto a chamada esta travada");
+        verificar(contem(erro, "prazo de 100 ms excedido"), "o Futuro falha por prazo: \"" + erro + "\"");
+        verificar(prazoMs >= 90 && prazoMs < 1000, "a falha chega perto do prazo (" + std::to_string(static_cast<long long>(prazoMs)) + " ms)");
+        auto m = financeiro.obterMetricas();
+        verificar(m.prazosExcedidos == 1 && m.falhas == 1, "metricas: 1 prazo excedido, 1 falha");
+        alvo.liberar();  // a tentativa abandonada termina e o executor pode encerrar
+    }
+}
+
+void testarNovasTentativas() {
+    std::cout << "\nNovas tentativas (modulo instavel: 2 falhas e depois responde)\n";
+    FinanceiroFalso alvo(FinanceiroFalso::Modo::INSTAVEL, 2);
+    Cenario cenario(alvo, politicaTeste());
+    FinanceiroResiliente& financeiro = cenario.financeiro;
+
+    bool disponivel = false;
+    try {
+        disponivel = financeiro.verificarDisponibilidade(Dinheiro());
+    } catch (const std::exception& e) {
+        std::cout << "    erro inesperado: " << e.what() << "\n";
+    }
+    auto m = financeiro.obterMetricas();
+    verificar(disponivel, "a terceira tentativa responde");
+    verificar(alvo.chamadas == 3, "o modulo recebeu 3 chamadas (" + std::to_string(alvo.chamadas) + ")");
+    verificar(m.chamadas == 1 && m.falhas == 2 && m.novasTentativas == 2,
+              "metricas: 1 chamada, 2 falhas, 2 novas tentativas");
+}
+
+void testarIdempotencia() {
+    std::cout << "\nIdempotente x nao idempotente (modulo sempre falha)\n";
+    {
+        FinanceiroFalso alvo(FinanceiroFalso::Modo::SEMPRE_FALHA);
+        Cenario cenario(alvo, politicaTeste());
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+        std::string erro = erroDe(financeiro.verificarDisponibilidadeAssincrona(Dinheiro()));
+        verificar(alvo.chamadas == 3, "verificarDisponibilidade (idempotente) tenta 3 vezes (" +
+                                          std::to_string(alvo.chamadas) + ")");
+        verificar(contem(erro, "(3 tentativa(s))"), "o erro final informa as tentativas: \"" + erro + "\"");
+    }
+    {
+        FinanceiroFalso alvo(FinanceiroFalso::Modo::SEMPRE_FALHA);
+        Cenario cenario(alvo, politicaTeste());
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+        std::string erro = erroDe(financeiro.solicitarVerbaAssincrona(Dinheiro::deCentavos(100)));
+        verificar(alvo.chamadas == 1, "solicitarVerba (debita saldo) tenta uma unica vez (" +
+                                          std::to_string(alvo.chamadas) + ")");
+        verificar(financeiro.obterMetricas().novasTentativas == 0, "metricas: nenhuma nova tentativa");
+    }
+    {
+        FinanceiroFalso alvo(FinanceiroFalso::Modo::SEMPRE_FALHA);
+        Cenario cenario(alvo, politicaTeste());
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+        erroDe(financeiro.autorizarPagamentoAssincrono(7));
+        verificar(alvo.chamadas == 3, "autorizarPagamento (chave idOrdem) tenta 3 vezes (" +
+                                          std::to_string(alvo.chamadas) + ")");
+    }
+    {
+        // O mock honra a chave: a repetição de uma autorização não autoriza de novo
+        FinanceiroMock mock;
+        PerfilLatencia semLatencia;
+        semLatencia.tipo = TipoLatencia::ZERO;
+        mock.configurarLatencia(semLatencia);
+        Cenario cenario(mock, politicaTeste());
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+        bool primeira = financeiro.autorizarPagamento(7);
+        bool repeticao = financeiro.autorizarPagamento(7);
+        bool outra = financeiro.autorizarPagamento(8);
+        verificar(primeira && repeticao && outra, "as tres chamadas respondem true");
+        verificar(mock.obterQuantidadeAutorizacoes() == 2, "FinanceiroMock registra 2 autorizacoes para 3 chamadas (" +
+                                                               std::to_string(mock.obterQuantidadeAutorizacoes()) + ")");
+    }
+}
+
+void testarCompensacao() {
+    std::cout << "\nResposta depois do prazo (solicitarVerba travado)\n";
+    FinanceiroFalso alvo(FinanceiroFalso::Modo::TRAVADO);
+    {
+        Cenario cenario(alvo, politicaTeste());
+        FinanceiroResiliente& financeiro = cenario.financeiro;
+        std::string erro = erroDe(financeiro.solicitarVerbaAssincrona(Dinheiro::deCentavos(500)));
+        verificar(contem(erro, "prazo"), "o Futuro falha por prazo");
+        alvo.liberar();
+    }
+    // Os executores já encerraram: a tentativa abandonada terminou e foi compensada
+    verificar(alvo.devolvidoCentavos == 500, "a verba concedida tarde volta ao financeiro (" +
+                                                 std::to_string(alvo.devolvidoCentavos) + " centavos)");
+}
+
+void testarDisjuntor() {
+    std::cout << "\nDisjuntor (3 falhas seguidas abrem o circuito)\n";
+    FinanceiroFalso alvo(FinanceiroFalso::Modo::SEMPRE_FALHA);
+    PoliticaResiliencia politica = politicaTeste();
+    politica.tentativas = 1;
+    politica.falhasParaAbrir = 3;
+    Cenario cenario(alvo, politica);
+    FinanceiroResiliente& financeiro = cenario.financeiro;
+
+    for (int i = 0; i < 3; i++) erroDe(financeiro.verificarDisponibilidadeAssincrona(Dinheiro()));
+    verificar(financeiro.obterMetricas().estado == DisjuntorCircuito::Estado::ABERTO, "circuito ABERTO apos 3 falhas");
+
+    std::string erro = erroDe(financeiro.verificarDisponibilidadeAssincrona(Dinheiro()));
+    verificar(contem(erro, "circuito aberto"), "a 4a chamada e recusada: \"" + erro + "\"");
+    verificar(alvo.chamadas == 3, "a chamada recusada nao chega ao modulo (" + std::to_string(alvo.chamadas) + ")");
+    verificar(financeiro.obterMetricas().recusadasCircuitoAberto == 1, "metricas: 1 recusada com circuito aberto");
+
+    // Passado o tempo aberto, uma chamada de teste passa e, dando certo, fecha o circuito
+    alvo.modo = FinanceiroFalso::Modo::NORMAL;
+    std::this_thread::sleep_for(politica.tempoAberto + std::chrono::milliseconds(50));
+    bool respondeu = false;
+    try {
+        respondeu = financeiro.verificarDisponibilidade(Dinheiro());
+    } catch (const std::exception&) {
+    }
+    verificar(respondeu && financeiro.obterMetricas().estado == DisjuntorCircuito::Estado::FECHADO,
+              "apos o tempo aberto, a chamada de teste passa e o circuito FECHA");
+}
+
+} // namespace
+
+int main() {
+    RegistroLog::instancia().configurar(NivelLog::ERRO, FormatoLog::TEXTO);
+    std::cout << "Teste de resiliencia das integracoes\n";
+    testarPrazoSemBloquear();
+    testarNovasTentativas();
+    testarIdempotencia();
+    testarCompensacao();
+    testarDisjuntor();
+    if (verificacoesFalhas > 0) {
+        std::cout << "\n" << verificacoesFalhas << " verificacao(oes) falharam\n";
+        return 1;
+    }
+    std::cout << "\nTodas as verificacoes passaram\n";
+    return 0;
+}